@@ -0,0 +1,197 @@
+/* Copyright (c) 2023 Renesas Electronics Corp.
+ * SPDX-License-Identifier: MIT-0 */
+
+/*******************************************************************************
+ * FILENAME: batch.h
+ *
+ * DESCRIPTION:
+ *   Shape batch functions.
+ *
+ *   Shapes (such as bounding boxes of detected objects) are collected in
+ *   an array of instances on CPU. Then, all of them are drawn with a single
+ *   instanced draw call, so the cost per shape is only a few bytes of data.
+ *
+ *   Each shape is a quad whose pixels are colored by the signed distance to
+ *   the edge of the shape (computed analytically in the fragment shader).
+ *   So, edges are antialiased and no triangle meshes are needed.
+ *
+ * PUBLIC FUNCTIONS:
+ *   batch_create
+ *   batch_delete
+ *
+ *   batch_add_rect
+ *   batch_add_rounded_rect
+ *   batch_add_circle
+ *   batch_add_line
+ *   batch_add_polyline
+ *   batch_add_polygon
+ *   batch_add_image
+ *
+ *   batch_flush
+ *
+ * AUTHOR: RVC       START DATE: 15/03/2023
+ *
+ ******************************************************************************/
+
+#ifndef _BATCH_H_
+#define _BATCH_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "gl.h"
+#include "image.h"
+
+/******************************************************************************
+ *                              MACRO VARIABLES                               *
+ ******************************************************************************/
+
+/* Kinds of shapes (must match 'batch.fs.glsl') */
+#define BATCH_KIND_BOX     0 /* Rectangle with rounded corners */
+#define BATCH_KIND_POLYGON 1 /* Polygon whose vertices are in 'tex_verts' */
+#define BATCH_KIND_IMAGE   2 /* Image (or sprite) from 'tex_images'       */
+
+/* Width (in texels) of texture which contains vertices of polygons */
+#define BATCH_VERTS_TEX_WIDTH 256
+
+/******************************************************************************
+ *                           STRUCTURE DEFINITIONS                            *
+ ******************************************************************************/
+
+/* Per-instance data of a shape (must match 'batch.vs.glsl') */
+typedef struct
+{
+    /* Center and half size of bounding box (in pixels) */
+    float rect[4];
+
+    /* Color { red, green, blue, opacity } */
+    float color[4];
+
+    /* Rotation (in radians, counter-clockwise), outline width (in pixels,
+     * 0 for filled shape), corner radius (in pixels), and kind of shape */
+    float params[4];
+
+    /* Index of the first vertex and the number of vertices (for polygon) */
+    float verts[2];
+
+    /* Texture coordinates { left, top, right, bottom } (for image) */
+    float uv[4];
+
+} batch_inst_t;
+
+typedef struct
+{
+    /* Vertex array object which keeps the layout of instances */
+    GLuint vao;
+
+    /* Corners of unit quad (shared by all instances) */
+    GLuint vbo_quad_verts;
+
+    /* An array of 'max_count' instances. The first 'count' are in use */
+    batch_inst_t * p_insts;
+
+    uint32_t count;
+    uint32_t max_count;
+
+    /* Vertices of polygons (relative to center of polygon, in pixels).
+     * Each texel of RG32F texture 'tex_verts' contains 1 vertex */
+    GLuint tex_verts;
+
+    /* An array of 'max_vert_count' vertices { x, y }.
+     * The first 'vert_count' are in use */
+    float * p_verts;
+
+    uint32_t vert_count;
+    uint32_t max_vert_count;
+
+    /* Copy of the first 'tex_vert_count' vertices, which are in 'tex_verts'.
+     * Updating a texture which the GPU may still read stalls the pipeline,
+     * so 'tex_verts' is only updated when vertices change.
+     * Note: It's in the same allocation as 'p_verts' */
+    float * p_tex_verts;
+    uint32_t tex_vert_count;
+
+    /* Texture of image atlas used by the current batch (0 if none) */
+    GLuint tex_images;
+
+} batch_t;
+
+/******************************************************************************
+ *                            FUNCTION DECLARATION                            *
+ ******************************************************************************/
+
+/* Create an empty batch which can hold up to 'max_count' shapes and
+ * 'max_vert_count' vertices of polygons.
+ *
+ * Note: Check 'p_insts' of the returned batch. It's NULL if failed */
+batch_t batch_create(uint32_t max_count, uint32_t max_vert_count);
+
+/* Delete batch.
+ * Note: This function will deallocate 'p_batch->p_insts' and
+ *       'p_batch->p_verts' */
+void batch_delete(batch_t * p_batch);
+
+/* Add a 'width' x 'height' rectangle whose bottom-left corner is ('x', 'y')
+ * before being rotated 'angle' degrees (counter-clockwise) around its center.
+ * Set 'outline_width' (in pixels) to 0 to fill the rectangle.
+ *
+ * Return false if the batch is full */
+bool batch_add_rect(batch_t * p_batch, float x, float y,
+                    float width, float height, float angle,
+                    color_t color, float opacity, float outline_width);
+
+/* Same as 'batch_add_rect', but corners are rounded with 'radius' pixels */
+bool batch_add_rounded_rect(batch_t * p_batch, float x, float y,
+                            float width, float height, float angle,
+                            float radius, color_t color, float opacity,
+                            float outline_width);
+
+/* Add a circle whose center is ('x', 'y').
+ * Set 'outline_width' (in pixels) to 0 to fill the circle.
+ *
+ * Return false if the batch is full */
+bool batch_add_circle(batch_t * p_batch, float x, float y, float radius,
+                      color_t color, float opacity, float outline_width);
+
+/* Add a line from ('x0', 'y0') to ('x1', 'y1') with round caps.
+ * Return false if the batch is full */
+bool batch_add_line(batch_t * p_batch, float x0, float y0,
+                    float x1, float y1, float width,
+                    color_t color, float opacity);
+
+/* Add lines which connect 'count' points in 'p_points' { x0, y0, x1, y1... }.
+ * Return false if the batch cannot hold all lines.
+ *
+ * Note: Lines overlap at joints. So, opacity should be 1 */
+bool batch_add_polyline(batch_t * p_batch, const float * p_points,
+                        uint32_t count, float width,
+                        color_t color, float opacity);
+
+/* Add a polygon whose 'count' vertices are in 'p_points' { x0, y0, x1, y1...}.
+ * The polygon may be concave, but its edges should not cross each other.
+ * Set 'outline_width' (in pixels) to 0 to fill the polygon.
+ *
+ * Return false if the batch cannot hold the polygon */
+bool batch_add_polygon(batch_t * p_batch, const float * p_points,
+                       uint32_t count, color_t color, float opacity,
+                       float outline_width);
+
+/* Add frame 'frame' of image 'index' of atlas 'p_atlas'. The image is
+ * scaled to 'width' x 'height' and its bottom-left corner is ('x', 'y')
+ * before being rotated 'angle' degrees (counter-clockwise) around its center.
+ *
+ * Return false if the batch is full.
+ *
+ * Note: All images in a batch must be from the same atlas */
+bool batch_add_image(batch_t * p_batch, const image_atlas_t * p_atlas,
+                     uint32_t index, uint32_t frame, float x, float y,
+                     float width, float height, float angle, float opacity);
+
+/* Draw all shapes in the batch with 1 draw call. Then, empty the batch.
+ *
+ * Note: 'prog' should be created from 'SHADER_PROG_BATCH'.
+ *       Unlike 'gl_draw_rectangle', this function does not wait for
+ *       the GPU ('glFinish') */
+void batch_flush(GLuint prog, batch_t * p_batch, gl_res_t res);
+
+#endif /* _BATCH_H_ */
@@ -0,0 +1,101 @@
+/* Copyright (c) 2023 Renesas Electronics Corp.
+ * SPDX-License-Identifier: MIT-0 */
+
+/*******************************************************************************
+ * FILENAME: denoise.h
+ *
+ * DESCRIPTION:
+ *   Temporal denoise functions.
+ *
+ *   Each camera frame is converted and blended with the previous denoised
+ *   frame, which is kept in one of 2 RGBA textures (ping-pong). The blend
+ *   is motion-adaptive: static pixels are averaged over frames, and moving
+ *   pixels keep the current frame. The encoder spends less bitrate on
+ *   sensor noise, which helps a lot in low light.
+ *
+ * PUBLIC FUNCTIONS:
+ *   denoise_create
+ *   denoise_delete
+ *
+ *   denoise_apply
+ *
+ * AUTHOR: RVC       START DATE: 15/03/2023
+ *
+ ******************************************************************************/
+
+#ifndef _DENOISE_H_
+#define _DENOISE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "gl.h"
+
+/******************************************************************************
+ *                              MACRO VARIABLES                               *
+ ******************************************************************************/
+
+/* Difference of luma (0 to 1) at which a pixel is treated as moving.
+ * Sensor noise should be below it */
+#define DENOISE_MOTION_THRESHOLD 0.08f
+
+/* Max strength with each format of denoised frames. Each blend is rounded
+ * to the format, so a static pixel stops converging within
+ * 0.5 / (1 - strength) steps of the format. The strength is capped so that
+ * this dead band stays within 1 step of 8-bit NV12 output */
+#define DENOISE_MAX_STRENGTH_HALF_FLOAT 0.9375f /* 'GL_RGBA16F'  */
+#define DENOISE_MAX_STRENGTH_10_BIT     0.875f  /* 'GL_RGB10_A2' */
+
+/******************************************************************************
+ *                            STRUCTURE DEFINITION                            *
+ ******************************************************************************/
+
+typedef struct
+{
+    /* Size of denoised frames (should be equal to size of output) */
+    uint32_t width;
+    uint32_t height;
+
+    /* Max weight of previous frame (0 to 1) */
+    float strength;
+
+    /* Internal format of denoised frames: 'GL_RGBA16F' if the GPU can
+     * render to it. Otherwise, 'GL_RGB10_A2' */
+    GLenum format;
+
+    /* RGBA textures of denoised frames and their framebuffers.
+     * Note: Their first row is the top of the image, like NV12 buffers */
+    GLuint texs[2];
+    GLuint fbs[2];
+
+    /* Number of denoised frames */
+    uint32_t frame;
+
+} denoise_t;
+
+/******************************************************************************
+ *                            FUNCTION DECLARATION                            *
+ ******************************************************************************/
+
+/* Create temporal denoise of 'width' x 'height' frames.
+ * 'strength' is the max weight of previous frame (such as 0.75). The higher
+ * it is, the more noise is removed, but slow motion may leave trails.
+ * It's capped by the precision of denoised frames (see
+ * 'DENOISE_MAX_STRENGTH_HALF_FLOAT').
+ *
+ * Note: Check 'texs' and 'fbs' of the returned struct. They are 0 if failed */
+denoise_t denoise_create(uint32_t width, uint32_t height, float strength);
+
+/* Delete temporal denoise */
+void denoise_delete(denoise_t * p_denoise);
+
+/* Convert camera texture 'tex' with 'prog' ('SHADER_PROG_DENOISE') and
+ * 'res' (crop, scaling...), and blend it with the previous denoised frame.
+ * Return the RGBA texture of the denoised frame. It can be converted to NV12
+ * with variant 'SHADER_RGBA_INPUT' of 'SHADER_PROG_YUYV_TO_NV12'.
+ *
+ * Note: The default framebuffer is bound after calling this function */
+GLuint denoise_apply(denoise_t * p_denoise, GLuint prog,
+                     GLenum target, GLuint tex, gl_res_t res);
+
+#endif /* _DENOISE_H_ */
@@ -20,6 +20,8 @@
  *   egl_create_yuyv_images
  *   egl_create_nv12_image
  *   egl_create_nv12_images
+ *   egl_create_plane_image
+ *   egl_create_nv12_plane_images
  *   egl_delete_images
  *
  * AUTHOR: RVC       START DATE: 15/03/2023
@@ -85,6 +87,22 @@ EGLImageKHR * egl_create_nv12_images(EGLDisplay display,
                                      uint32_t width, uint32_t height,
                                      mmngr_buf_t * p_bufs, uint32_t count);
 
+/* Create EGLImage of a single plane ('DRM_FORMAT_R8' or 'DRM_FORMAT_GR88')
+ * from a dmabuf file descriptor. It can be rendered to as a 2D texture.
+ * Return a value other than 'EGL_NO_IMAGE_KHR' if successful */
+EGLImageKHR egl_create_plane_image(EGLDisplay display,
+                                   uint32_t width, uint32_t height,
+                                   uint32_t fourcc, int dmabuf_fd);
+
+/* Create EGLImage objects of both planes of NV12 buffers: Y plane as
+ * 'DRM_FORMAT_R8' and UV plane (half size) as 'DRM_FORMAT_GR88'.
+ * Return an array of '2 * count' EGLImage objects (Y of buffer 0, UV of
+ * buffer 0, Y of buffer 1...) */
+EGLImageKHR * egl_create_nv12_plane_images(EGLDisplay display,
+                                           uint32_t width, uint32_t height,
+                                           mmngr_buf_t * p_bufs,
+                                           uint32_t count);
+
 /* Delete an array of EGLImage objects.
  * Note: This function will deallocate array 'p_imgs' */
 void egl_delete_images(EGLDisplay display, EGLImageKHR * p_imgs, uint32_t cnt);
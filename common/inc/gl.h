@@ -11,14 +11,19 @@
  *   gl_create_shader
  *   gl_create_prog_from_objs
  *   gl_create_prog_from_src
+ *   gl_create_prog_from_str
  *
  *   gl_is_ext_supported
  *   gl_init_ext_funcs
  *
  *   gl_create_external_texture
  *   gl_create_external_textures
+ *   gl_create_plane_texture
+ *   gl_create_plane_textures
  *   gl_create_rgb_texture
  *   gl_create_rgb_textures
+ *   gl_create_rgba_texture
+ *   gl_create_color_texture
  *   gl_delete_textures
  *
  *   gl_create_framebuffer
@@ -29,8 +34,19 @@
  *   gl_delete_resources
  *
  *   gl_draw_rectangle
+ *   gl_get_rectangle_bounds
  *   gl_render_texture
+ *   gl_render_textures
  *   gl_draw_text
+ *   gl_draw_sdf_text
+ *   gl_use_sdf_text_prog
+ *
+ *   gl_get_projection_matrix
+ *
+ *   gl_init_scaler
+ *   gl_set_zoom
+ *   gl_set_orientation
+ *   gl_get_scaler_mapping
  *
  * AUTHOR: RVC       START DATE: 15/03/2023
  *
@@ -54,6 +70,7 @@
 
 #include "egl.h"
 #include "ttf.h"
+#include "stream.h"
 
 /******************************************************************************
  *                              MACRO VARIABLES                               *
@@ -65,12 +82,111 @@
 #define GREEN ((color_t){ 0.0f, 1.0f, 0.0f })
 #define BLUE  ((color_t){ 0.0f, 0.0f, 1.0f })
 
+/* Directory (relative to the working directory) where program binaries are
+ * cached by 'gl_create_prog_from_src' and 'gl_create_prog_from_str' */
+#define GL_PROG_CACHE_DIR ".prog-cache"
+
+/* Size (in bytes) of streaming vertex buffer for dynamic geometry */
+#define GL_STREAM_SIZE (256 * 1024)
+
 /******************************************************************************
  *                           STRUCTURE DEFINITIONS                            *
  ******************************************************************************/
 
 typedef float color_t[3]; /* { red, green, blue } */
 
+/* Axis-aligned rectangle in pixels.
+ * Note: Origin is the bottom-left corner of framebuffer (same as 'glScissor') */
+typedef struct
+{
+    int32_t x;
+    int32_t y;
+    int32_t width;
+    int32_t height;
+
+} rect_t;
+
+/* Style of text rendered from signed distance field font */
+typedef struct
+{
+    /* Color of glyphs */
+    color_t color;
+
+    /* Color and width (in pixels) of outline around glyphs.
+     * Note: Set width to 0 to disable outline */
+    color_t outline_color;
+    float outline_width;
+
+    /* Color, opacity (from 0 to 1), and offset (in pixels, toward right and
+     * bottom) of drop shadow.
+     * Note: Set opacity to 0 to disable shadow */
+    color_t shadow_color;
+    float shadow_opacity;
+    float shadow_offset_x;
+    float shadow_offset_y;
+
+} text_style_t;
+
+/* Crop and scaling stage of 'gl_render_texture' and 'gl_render_textures'.
+ * A region of the source texture is scaled to the destination framebuffer,
+ * so that the output may be smaller/bigger than the camera frame or show
+ * a zoomed part of it without an extra full-frame pass */
+typedef struct
+{
+    /* Size of source texture (in pixels) */
+    uint32_t src_width;
+    uint32_t src_height;
+
+    /* Region of source texture which is rendered (in pixels).
+     * Note: Origin is the top-left corner of the image */
+    float crop_x;
+    float crop_y;
+    float crop_width;
+    float crop_height;
+
+    /* Clockwise rotation of region (0, 90, 180, or 270 degrees).
+     * Note: With 90 and 270 degrees, width and height of region are swapped
+     *       in the destination */
+    uint32_t rotation;
+
+    /* Mirror region horizontally and/or vertically (after rotation) */
+    bool b_mirror_x;
+    bool b_mirror_y;
+
+    /* Size of destination framebuffer (in pixels) */
+    uint32_t dst_width;
+    uint32_t dst_height;
+
+    /* True:  Keep aspect ratio of region and fill the rest with black bars.
+     * False: Stretch region to the entire framebuffer */
+    bool b_letterbox;
+
+    /* Filter of source texture when the region is resized (GL_LINEAR by
+     * default). YUYV textures sampled as YUV ('GL_EXT_YUV_target') need
+     * GL_NEAREST, because linear filtering of packed YUYV blends chroma of
+     * neighbouring pixels. Textures sampled in RGB and NV12 textures can be
+     * interpolated */
+    GLint filter;
+
+} scaler_t;
+
+/* Grid of triangles which replaces the canvas quad of 'gl_render_texture'
+ * and 'gl_render_textures' (such as a lens correction mesh, see 'lens.h').
+ * Each vertex is <vec2 pos, vec2 tex>, where 'tex' is the final texture
+ * coordinate (crop, scaling and orientation are already applied) */
+typedef struct
+{
+    /* Vertex buffer object */
+    GLuint vbo;
+
+    /* Index buffer object (GL_UNSIGNED_SHORT) */
+    GLuint ibo;
+
+    /* Number of indices */
+    GLsizei index_count;
+
+} mesh_t;
+
 typedef struct
 {
     /* Index buffer object */
@@ -82,15 +198,30 @@ typedef struct
     /* Vertex buffer object for canvas */
     GLuint vbo_canvas_verts;
 
-    /* Vertex buffer object for glyph bitmaps */
-    GLuint vbo_text_verts;
+    /* Streaming vertex buffer for dynamic geometry (text, batches...) */
+    stream_t * p_stream;
 
     /* Projection matrix */
     mat4 projection_mat;
 
+    /* Set to true when rendering overlay to framebuffers whose first row is
+     * the top of the image (such as NV12 buffers). False by default */
+    bool b_top_down;
+
+    /* Crop and scaling of 'gl_render_texture' and 'gl_render_textures'.
+     * NULL by default: the entire texture fills the current viewport */
+    const scaler_t * p_scaler;
+
+    /* Mesh of 'gl_render_texture' and 'gl_render_textures'.
+     * NULL by default: the canvas quad is used */
+    const mesh_t * p_mesh;
+
     /* An array of 'glyph_t' objects */
     glyph_t ** pp_glyphs;
 
+    /* Signed distance field font (text of any size from 1 atlas) */
+    ttf_sdf_font_t * p_sdf_font;
+
     /* The time when struct 'gl_res_t' is created */
     struct timeval start_tv;
 
@@ -109,14 +240,27 @@ GLuint gl_create_shader(const char * p_file, GLenum type);
 GLuint gl_create_prog_from_objs(GLuint vs_object, GLuint fs_object);
 
 /* Create program from file 'p_vs_file' and file 'p_fs_file'.
- * Return program's ID (positive integer) if successful */
+ * Return program's ID (positive integer) if successful.
+ *
+ * Note: The linked program binary is saved to 'GL_PROG_CACHE_DIR'. The next
+ *       time, it is loaded instead of compiling the shaders again. Entries are
+ *       keyed by a hash of the sources, GL_RENDERER, and GL_VERSION. So, an
+ *       edited shader or updated driver simply causes a new compile */
 GLuint gl_create_prog_from_src(const char * p_vs_file, const char * p_fs_file);
 
+/* Create program from source code 'p_vs_src' and 'p_fs_src'.
+ * Return program's ID (positive integer) if successful.
+ * Note: The program binary is cached (see 'gl_create_prog_from_src') */
+GLuint gl_create_prog_from_str(const char * p_vs_src, const char * p_fs_src);
+
 /* Return true if extension 'p_name' is supported by the implementation */
 bool gl_is_ext_supported(const char * p_name);
 
 /* Initialize OpenGL ES extension functions.
- * Return true if all functions are supported at runtime */
+ * Return true if all functions are supported at runtime.
+ *
+ * Note: 'GL_EXT_YUV_target' is not required. Without it, YUV textures can
+ *       only be sampled in RGB, and NV12 buffers are written by plane */
 bool gl_init_ext_funcs();
 
 /* Create external texture from EGLImage object.
@@ -131,6 +275,17 @@ GLuint gl_create_external_texture(EGLImageKHR image);
  * Return an array of 'count' textures if successful. Otherwise, return NULL */
 GLuint * gl_create_external_textures(EGLImageKHR * p_images, uint32_t count);
 
+/* Create 2D texture from EGLImage object of a single plane (such as Y or UV
+ * plane of NV12 buffer, see 'egl_create_plane_image').
+ * Return texture's ID (positive integer) if successful.
+ *
+ * Note: The texture is unbound after calling this function */
+GLuint gl_create_plane_texture(EGLImageKHR image);
+
+/* Create 2D textures from an array of EGLImage objects of single planes.
+ * Return an array of 'count' textures if successful. Otherwise, return NULL */
+GLuint * gl_create_plane_textures(EGLImageKHR * p_images, uint32_t count);
+
 /* Create RGB texture. If 'p_data' is not NULL, fill the texture with it.
  * Return texture's ID (positive integer) if successful */
 GLuint gl_create_rgb_texture(uint32_t width, uint32_t height, char * p_data);
@@ -140,6 +295,19 @@ GLuint gl_create_rgb_texture(uint32_t width, uint32_t height, char * p_data);
 GLuint * gl_create_rgb_textures(uint32_t width, uint32_t height,
                                 char ** pp_data, uint32_t count);
 
+/* Create RGBA texture. If 'p_data' is not NULL, fill the texture with it.
+ * Return texture's ID (positive integer) if successful */
+GLuint gl_create_rgba_texture(uint32_t width, uint32_t height, char * p_data);
+
+/* Create empty texture which can be rendered to. 'format' is its internal
+ * format: 'GL_RGBA8', 'GL_RGBA4', 'GL_RGB5_A1', 'GL_RGB565', 'GL_R8',
+ * 'GL_RGB10_A2', or 'GL_RGBA16F' (it needs 'GL_EXT_color_buffer_half_float').
+ * 16-bit formats halve memory and bandwidth at the cost of precision.
+ * If 'p_size' is not NULL, it receives the size of texture (in bytes).
+ * Return texture's ID (positive integer) if successful */
+GLuint gl_create_color_texture(uint32_t width, uint32_t height,
+                               GLenum format, size_t * p_size);
+
 /* Delete textures.
  * Note: This function will deallocate array 'p_textures' */
 void gl_delete_textures(GLuint * p_textures, uint32_t count);
@@ -179,17 +347,75 @@ void gl_delete_resources(gl_res_t res);
  * https://en.wikibooks.org/wiki/OpenGL_Programming */
 void gl_draw_rectangle(GLuint prog, gl_res_t res);
 
+/* Return the area (in pixels) which is covered by the rectangle drawn by
+ * 'gl_draw_rectangle' at this moment on a 'width' x 'height' framebuffer */
+rect_t gl_get_rectangle_bounds(uint32_t width, uint32_t height, gl_res_t res);
+
 /* Render texture.
  * The destination format is determined by 'prog' and framebuffer's layout.
+ * If 'res.p_scaler' is not NULL, its crop and scaling are applied. Then,
+ * 'prog' should be created from 'texture.vs.glsl' (all texture programs of
+ * 'shader.h' are).
  *
  * Note: 'target' should be one of the following values:
  *   - GL_TEXTURE_2D: If 'tex' is an RGB texture.
  *   - GL_TEXTURE_EXTERNAL_OES: If 'tex' is an external texture */
 void gl_render_texture(GLuint prog, GLenum target, GLuint tex, gl_res_t res);
 
+/* Render 'count' textures in a single pass.
+ * Texture 'p_texs[i]' (of target 'p_targets[i]') is bound to texture unit 'i'.
+ *
+ * Note: Sampler uniforms of 'prog' must be set to the matching texture units
+ *       ('glUniform1i') before calling this function */
+void gl_render_textures(GLuint prog, const GLenum * p_targets,
+                        const GLuint * p_texs, uint32_t count, gl_res_t res);
+
 /* Draw text.
  * https://learnopengl.com/In-Practice/Text-Rendering */
 void gl_draw_text(GLuint prog, const char * p_text,
                   float x, float y, color_t color, gl_res_t res);
 
+/* Draw text from signed distance field font.
+ * The text is 'size' pixels high (em square) and its baseline starts at
+ * ('x', 'y'). All glyphs are drawn with a single draw call.
+ *
+ * Note: 'prog' should be created from 'SHADER_PROG_SDF_TEXT'.
+ *       Outline and shadow should not exceed the spread of the font
+ *       ('SDF_SPREAD' pixels when 'size' is 'SDF_CHAR_SIZE') */
+void gl_draw_sdf_text(GLuint prog, const char * p_text, float x, float y,
+                      float size, const text_style_t * p_style, gl_res_t res);
+
+/* Use 'prog' ('SHADER_PROG_SDF_TEXT') and set its uniforms for text which is
+ * 'size' pixels high with 'p_style'. Vertices of glyphs and the atlas of
+ * 'res.p_sdf_font' are bound by the caller (see 'gl_draw_sdf_text') */
+void gl_use_sdf_text_prog(GLuint prog, float size,
+                          const text_style_t * p_style, gl_res_t res);
+
+/* Get matrix which converts pixels to normalized device coordinates.
+ * It's 'res.projection_mat', mirrored if 'res.b_top_down' is true */
+void gl_get_projection_matrix(gl_res_t res, mat4 projection_mat);
+
+/* Return scaler which renders entire 'src_width' x 'src_height' texture to
+ * 'dst_width' x 'dst_height' framebuffer with linear filtering */
+scaler_t gl_init_scaler(uint32_t src_width, uint32_t src_height,
+                        uint32_t dst_width, uint32_t dst_height,
+                        bool b_letterbox);
+
+/* Zoom into source texture by 'zoom' times (1 shows the entire texture).
+ * The region is centered at ('center_x', 'center_y') (in pixels, origin is
+ * the top-left corner of the image) but it never goes outside the texture */
+void gl_set_zoom(scaler_t * p_scaler, float zoom,
+                 float center_x, float center_y);
+
+/* Rotate region clockwise by 'rotation' degrees (0, 90, 180, or 270), then
+ * mirror it. It only changes texture coordinates, so it costs nothing */
+void gl_set_orientation(scaler_t * p_scaler, uint32_t rotation,
+                        bool b_mirror_x, bool b_mirror_y);
+
+/* Get the mapping of 'p_scaler' (identity if NULL) in normalized coordinates:
+ * destination area and source region as <vec2 offset, vec2 size>, and the
+ * orientation from a position inside area to a position inside region */
+void gl_get_scaler_mapping(const scaler_t * p_scaler, vec4 dst_area,
+                           vec4 src_region, mat3 orientation);
+
 #endif /* _GL_H_ */
@@ -0,0 +1,119 @@
+/* Copyright (c) 2023 Renesas Electronics Corp.
+ * SPDX-License-Identifier: MIT-0 */
+
+/*******************************************************************************
+ * FILENAME: image.h
+ *
+ * DESCRIPTION:
+ *   Image atlas functions.
+ *
+ *   Images (logos, icons, sprite sheets...) are loaded once and packed into
+ *   a single RGBA texture with premultiplied alpha. So, any number of images
+ *   can be drawn with a single draw call (see 'batch_add_image').
+ *
+ * PUBLIC FUNCTIONS:
+ *   image_atlas_create
+ *   image_atlas_delete
+ *
+ *   image_atlas_add_rgba
+ *   image_atlas_add_png
+ *
+ *   image_get_frame_uv
+ *
+ * AUTHOR: RVC       START DATE: 15/03/2023
+ *
+ ******************************************************************************/
+
+#ifndef _IMAGE_H_
+#define _IMAGE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "gl.h"
+
+/******************************************************************************
+ *                              MACRO VARIABLES                               *
+ ******************************************************************************/
+
+/* The maximum number of images in an atlas */
+#define IMAGE_ATLAS_MAX_COUNT 64
+
+/* Gap (in pixels) between images in the atlas.
+ * It prevents linear filtering from mixing texels of neighbor images */
+#define IMAGE_ATLAS_GAP 1
+
+/******************************************************************************
+ *                           STRUCTURE DEFINITIONS                            *
+ ******************************************************************************/
+
+typedef struct
+{
+    /* Texture coordinates of the entire image (or sprite sheet) */
+    float tex_left;
+    float tex_top;
+    float tex_right;
+    float tex_bottom;
+
+    /* Size (in pixels) of 1 frame */
+    uint32_t width;
+    uint32_t height;
+
+    /* The number of frames per row and column of sprite sheet.
+     * Note: They are 1 for normal images */
+    uint32_t cols;
+    uint32_t rows;
+
+} image_t;
+
+typedef struct
+{
+    /* RGBA texture (premultiplied alpha) */
+    GLuint tex;
+
+    /* Size (in pixels) of texture */
+    uint32_t width;
+    uint32_t height;
+
+    /* An array of 'count' images in the atlas */
+    image_t images[IMAGE_ATLAS_MAX_COUNT];
+    uint32_t count;
+
+    /* Position of next image and height of current shelf (row of images) */
+    uint32_t pos_x;
+    uint32_t pos_y;
+    uint32_t shelf_height;
+
+} image_atlas_t;
+
+/******************************************************************************
+ *                            FUNCTION DECLARATION                            *
+ ******************************************************************************/
+
+/* Create an empty 'width' x 'height' atlas.
+ * Note: Check 'tex' of the returned atlas. It's 0 if failed */
+image_atlas_t image_atlas_create(uint32_t width, uint32_t height);
+
+/* Delete atlas */
+void image_atlas_delete(image_atlas_t * p_atlas);
+
+/* Add 'width' x 'height' RGBA image 'p_data' (straight alpha, first row is
+ * the top of the image) to atlas. The image is a sprite sheet if 'cols' or
+ * 'rows' is greater than 1.
+ *
+ * Return index of image in the atlas if successful. Otherwise, return -1 */
+int image_atlas_add_rgba(image_atlas_t * p_atlas, const uint8_t * p_data,
+                         uint32_t width, uint32_t height,
+                         uint32_t cols, uint32_t rows);
+
+/* Load PNG file 'p_file' and add it to atlas (see 'image_atlas_add_rgba').
+ * Return index of image in the atlas if successful. Otherwise, return -1 */
+int image_atlas_add_png(image_atlas_t * p_atlas, const char * p_file,
+                        uint32_t cols, uint32_t rows);
+
+/* Get texture coordinates { left, top, right, bottom } of frame 'frame'
+ * (counted from left to right, then top to bottom) of image 'index' */
+void image_get_frame_uv(const image_atlas_t * p_atlas, uint32_t index,
+                        uint32_t frame, float uv[4]);
+
+#endif /* _IMAGE_H_ */
@@ -0,0 +1,248 @@
+/* Copyright (c) 2023 Renesas Electronics Corp.
+ * SPDX-License-Identifier: MIT-0 */
+
+/*******************************************************************************
+ * FILENAME: ipc.h
+ *
+ * DESCRIPTION:
+ *   Shared-memory overlay command functions.
+ *
+ *   External processes (such as an object detector) publish lists of
+ *   overlay commands (boxes, labels, and masks) through a POSIX shared
+ *   memory object which is created by the demo. Each list is tagged with the
+ *   capture time of the frame it was computed from.
+ *
+ *   The shared memory holds a ring of 'IPC_SLOT_COUNT' slots. Each slot is
+ *   guarded by a sequence lock: the publisher makes its sequence number odd,
+ *   writes the list, then makes it even again. The render thread copies a
+ *   slot and checks that the sequence number is even and unchanged, so it
+ *   never waits for the publisher and no system call is made once the
+ *   memory is mapped. A torn copy is retried a few times, then the previous
+ *   list is kept.
+ *
+ *   For each camera frame, the list whose timestamp matches the frame is
+ *   drawn. If there is none (the detector is slower than the camera), the
+ *   newest list is drawn. Lists older than 'IPC_MAX_AGE_US' are dropped, so
+ *   stale boxes disappear if the publisher stops.
+ *
+ *   Boxes and masks are added to a batch ('batch.h'), so they are drawn
+ *   with the other shapes in a single draw call.
+ *
+ * PROTOCOL (for publishers):
+ *   1. Open the object with 'ipc_open' (or 'shm_open' and 'mmap' it as
+ *      'ipc_shm_t', then check 'magic' and 'version').
+ *   2. Read 'frame_timestamp_us' and 'frame_sequence' for the latest frame
+ *      of the demo, or use capture times of your own frames (microseconds
+ *      of 'CLOCK_MONOTONIC', like V4L2 buffer timestamps).
+ *   3. Publish lists with 'ipc_publish'. There must be only 1 publisher per
+ *      shared memory object.
+ *
+ *   The object can only be opened by the user who runs the demo. Commands
+ *   with values which are not finite or out of range (see 'ipc_cmd_t') are
+ *   not drawn.
+ *
+ * PUBLIC FUNCTIONS:
+ *   ipc_create
+ *   ipc_open
+ *   ipc_delete
+ *
+ *   ipc_publish
+ *
+ *   ipc_update
+ *   ipc_get_bounds
+ *   ipc_add_shapes
+ *   ipc_draw_labels
+ *
+ * AUTHOR: RVC       START DATE: 15/03/2023
+ *
+ ******************************************************************************/
+
+#ifndef _IPC_H_
+#define _IPC_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "gl.h"
+#include "batch.h"
+
+/******************************************************************************
+ *                              MACRO VARIABLES                               *
+ ******************************************************************************/
+
+/* Identification of the shared memory layout */
+#define IPC_MAGIC   0x3152564F /* "OVR1" in little endian */
+#define IPC_VERSION 1
+
+/* Number of slots of the ring */
+#define IPC_SLOT_COUNT 4
+
+/* Max number of commands in a list */
+#define IPC_MAX_CMDS 64
+
+/* Max number of points of a mask */
+#define IPC_MAX_POINTS 8
+
+/* Max length of a label (including the null terminator) */
+#define IPC_LABEL_MAX_LEN 32
+
+/* A list matches a frame if their timestamps differ by this value (in
+ * microseconds) or less */
+#define IPC_MATCH_TOLERANCE_US 10000
+
+/* Lists older than this value (in microseconds) are not drawn */
+#define IPC_MAX_AGE_US 1000000
+
+/* Max number of attempts to copy a slot which is being written */
+#define IPC_READ_RETRIES 3
+
+/* Types of command */
+#define IPC_CMD_BOX   0 /* Outline of rectangle ('x', 'y', 'width', 'height') */
+#define IPC_CMD_LABEL 1 /* Text ('x', 'y', 'height' as size, and 'text')     */
+#define IPC_CMD_MASK  2 /* Filled polygon ('points' and 'point_count')       */
+
+/******************************************************************************
+ *                            STRUCTURE DEFINITION                            *
+ ******************************************************************************/
+
+/* Overlay command.
+ * Note: Coordinates are in pixels of the output, with origin at the
+ *       top-left corner (as in images of detectors). A label starts at
+ *       ('x', 'y') on its baseline. Coordinates and sizes must be within
+ *       65536 pixels, sizes must not be negative, and colors and opacity
+ *       must be within 0 to 1 */
+typedef struct
+{
+    /* Type of command ('IPC_CMD_*') */
+    uint32_t type;
+
+    /* Color (0 to 1), opacity (0 to 1), and outline width (in pixels) of
+     * boxes. Labels ignore opacity and outline width */
+    float color[3];
+    float opacity;
+    float outline_width;
+
+    float x;
+    float y;
+    float width;
+    float height;
+
+    uint32_t point_count;
+    float points[IPC_MAX_POINTS][2];
+
+    char text[IPC_LABEL_MAX_LEN];
+
+} ipc_cmd_t;
+
+/* List of commands for a frame */
+typedef struct
+{
+    /* Capture time of the frame (in microseconds of 'CLOCK_MONOTONIC') and
+     * its sequence number (informative only) */
+    uint64_t timestamp_us;
+    uint32_t frame_sequence;
+
+    /* Number of commands */
+    uint32_t count;
+
+    ipc_cmd_t cmds[IPC_MAX_CMDS];
+
+} ipc_list_t;
+
+/* Slot of the ring */
+typedef struct
+{
+    /* Sequence lock. It's odd while the list is being written and 0 if the
+     * slot has never been written */
+    uint32_t seq;
+    uint32_t reserved;
+
+    ipc_list_t list;
+
+} ipc_slot_t;
+
+/* Layout of the shared memory object */
+typedef struct
+{
+    /* 'IPC_MAGIC' and 'IPC_VERSION'. 'magic' is written last when the
+     * object is created */
+    uint32_t magic;
+    uint32_t version;
+
+    /* Size of the output (in pixels) */
+    uint32_t width;
+    uint32_t height;
+
+    /* Capture time and sequence number of the latest frame of the demo */
+    uint64_t frame_timestamp_us;
+    uint32_t frame_sequence;
+
+    /* Number of published lists. The newest one is in slot
+     * '(publish_count - 1) % IPC_SLOT_COUNT' */
+    uint32_t publish_count;
+
+    ipc_slot_t slots[IPC_SLOT_COUNT];
+
+} ipc_shm_t;
+
+typedef struct
+{
+    /* Mapped shared memory and its name */
+    ipc_shm_t * p_shm;
+    char * p_name;
+
+    /* True if the object was created by 'ipc_create' (it's removed by
+     * 'ipc_delete') */
+    bool b_owner;
+
+    /* Slot and sequence number of the list which was copied last */
+    uint32_t last_slot;
+    uint32_t last_seq;
+
+    /* List which is drawn (copied out of shared memory), and a list which
+     * slots are copied to before they are validated */
+    ipc_list_t list;
+    ipc_list_t scratch;
+
+} ipc_t;
+
+/******************************************************************************
+ *                            FUNCTION DECLARATION                            *
+ ******************************************************************************/
+
+/* Create shared memory object 'p_name' (such as "/overlay") for a
+ * 'width' x 'height' output and map it.
+ * Return NULL if failed */
+ipc_t * ipc_create(const char * p_name, uint32_t width, uint32_t height);
+
+/* Map existing shared memory object 'p_name' (for publishers).
+ * Return NULL if failed or if its layout does not match */
+ipc_t * ipc_open(const char * p_name);
+
+/* Unmap shared memory (and remove it if it was created by 'ipc_create').
+ * Nothing happens if 'p_ipc' is NULL */
+void ipc_delete(ipc_t * p_ipc);
+
+/* Write 'p_list' to the next slot (for publishers). It never blocks */
+void ipc_publish(ipc_t * p_ipc, const ipc_list_t * p_list);
+
+/* Announce the frame captured at 'timestamp_us' (with 'sequence') to
+ * publishers, then copy the list which matches it (or the newest one).
+ * Invalid commands of the list are skipped.
+ * Return true if the drawn list has changed */
+bool ipc_update(ipc_t * p_ipc, uint64_t timestamp_us, uint32_t sequence);
+
+/* Return the area (in pixels, origin at the bottom-left corner) which the
+ * drawn list covers. Labels are estimated from their length */
+rect_t ipc_get_bounds(const ipc_t * p_ipc);
+
+/* Add boxes and masks of the drawn list to 'p_batch'.
+ * Commands which do not fit in the batch are skipped */
+void ipc_add_shapes(const ipc_t * p_ipc, batch_t * p_batch);
+
+/* Draw labels of the drawn list with 'prog' ('SHADER_PROG_SDF_TEXT').
+ * 'p_style' is used with the color of each label */
+void ipc_draw_labels(const ipc_t * p_ipc, GLuint prog,
+                     const text_style_t * p_style, gl_res_t res);
+
+#endif /* _IPC_H_ */
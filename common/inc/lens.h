@@ -0,0 +1,60 @@
+/* Copyright (c) 2023 Renesas Electronics Corp.
+ * SPDX-License-Identifier: MIT-0 */
+
+/*******************************************************************************
+ * FILENAME: lens.h
+ *
+ * DESCRIPTION:
+ *   Lens distortion correction functions.
+ *
+ *   Radial (barrel or pincushion) distortion of wide-angle lenses is
+ *   corrected by drawing the conversion pass with a grid mesh instead of the
+ *   canvas quad. Texture coordinates of the mesh point to the distorted
+ *   positions in camera frame. The mesh is generated once, so the correction
+ *   costs no extra render pass.
+ *
+ * PUBLIC FUNCTIONS:
+ *   lens_create_mesh
+ *   lens_delete_mesh
+ *
+ * AUTHOR: RVC       START DATE: 15/03/2023
+ *
+ ******************************************************************************/
+
+#ifndef _LENS_H_
+#define _LENS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "gl.h"
+
+/******************************************************************************
+ *                              MACRO VARIABLES                               *
+ ******************************************************************************/
+
+/* Number of cells of mesh. Distortion is linear inside a cell */
+#define LENS_MESH_COLS 32
+#define LENS_MESH_ROWS 24
+
+/******************************************************************************
+ *                            FUNCTION DECLARATION                            *
+ ******************************************************************************/
+
+/* Create mesh which corrects radial distortion 'k1' and 'k2' of camera frame
+ * for the conversion pass with 'p_scaler' (crop, scaling and orientation).
+ * 'b_flip_y' must match 'SHADER_FLIP_Y' of the program.
+ *
+ * A point of corrected frame maps to 'p * (1 + k1 * r^2 + k2 * r^4)' in
+ * camera frame, where 'p' is relative to the center of frame, half of frame
+ * width is 1, and 'r' is the length of 'p'. Barrel distortion has negative
+ * 'k1'. Return a mesh with non-zero buffers if successful.
+ *
+ * Note: The mesh must be created again if 'p_scaler' changes */
+mesh_t lens_create_mesh(float k1, float k2,
+                        const scaler_t * p_scaler, bool b_flip_y);
+
+/* Delete mesh */
+void lens_delete_mesh(mesh_t * p_mesh);
+
+#endif /* _LENS_H_ */
@@ -0,0 +1,143 @@
+/* Copyright (c) 2023 Renesas Electronics Corp.
+ * SPDX-License-Identifier: MIT-0 */
+
+/*******************************************************************************
+ * FILENAME: mask.h
+ *
+ * DESCRIPTION:
+ *   Privacy mask functions.
+ *
+ *   Regions (rectangles or polygons) of video frames, such as windows of
+ *   neighbouring buildings, are pixelated or blurred before overlay is
+ *   drawn and frames are encoded. The camera frame is rendered again at low
+ *   resolution, then blurred with a separable filter (2 passes). Each pass
+ *   is a single draw call, limited to the bounding box of all regions
+ *   (scissor test). Finally, regions are drawn as triangles which sample
+ *   the low resolution frame ('mask_draw'), or a conversion pass replaces
+ *   covered pixels with it ('SHADER_MASK' and 'mask_draw_coverage'). So,
+ *   masking a few regions costs a small fraction of a full-frame pass.
+ *
+ *   Regions are read from a text file, 1 per line ('#' starts a comment):
+ *
+ *     style pixelate|blur        Style of all regions (default: pixelate)
+ *     rect X Y WIDTH HEIGHT      Rectangle
+ *     poly X0 Y0 X1 Y1 X2 Y2...  Polygon (may be concave)
+ *
+ *   Coordinates are in pixels of output. Origin is the bottom-left corner of
+ *   the image (same as shapes of 'batch.h').
+ *
+ * PUBLIC FUNCTIONS:
+ *   mask_create
+ *   mask_delete
+ *   mask_update
+ *   mask_draw
+ *   mask_draw_coverage
+ *
+ * AUTHOR: RVC       START DATE: 15/03/2023
+ *
+ ******************************************************************************/
+
+#ifndef _MASK_H_
+#define _MASK_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "gl.h"
+
+/******************************************************************************
+ *                              MACRO VARIABLES                               *
+ ******************************************************************************/
+
+/* Max number of regions and max number of vertices of a polygon */
+#define MASK_MAX_REGIONS       16
+#define MASK_MAX_POLYGON_VERTS 16
+
+/* Styles of masks */
+#define MASK_STYLE_PIXELATE 0 /* Blocks of 'MASK_PIXEL_SIZE' pixels          */
+#define MASK_STYLE_BLUR     1 /* Gaussian blur at 1/'MASK_BLUR_SCALE' size   */
+
+/* Size (in pixels of output) of blocks of pixelated regions */
+#define MASK_PIXEL_SIZE 16
+
+/* Blur is done at 1/8 of the output size. The filter spans 9 texels, so
+ * the blur radius is about 32 pixels of output */
+#define MASK_BLUR_SCALE 8
+
+/******************************************************************************
+ *                            STRUCTURE DEFINITION                            *
+ ******************************************************************************/
+
+typedef struct
+{
+    /* Size of output (in pixels) */
+    uint32_t width;
+    uint32_t height;
+
+    /* Style of masks ('MASK_STYLE_PIXELATE'...) */
+    uint32_t style;
+
+    /* Bounding boxes of regions.
+     * Note: Origin is the bottom-left corner of the image */
+    rect_t bounds[MASK_MAX_REGIONS];
+    uint32_t region_count;
+
+    /* Bounding box of all regions */
+    rect_t area;
+
+    /* Vertex buffer object of triangles of all regions (vec2, in pixels) */
+    GLuint vbo;
+    GLsizei vert_count;
+
+    /* Low resolution frames (RGB565) and their framebuffers. The first one
+     * holds the masked content, the second one is for blurring.
+     * Note: Their first row is the top of the image, like NV12 buffers */
+    uint32_t work_width;
+    uint32_t work_height;
+
+    GLuint texs[2];
+    GLuint fbs[2];
+
+    /* Coverage of regions at output size (R8, 1 inside regions) and its
+     * framebuffer. It's only created by 'mask_draw_coverage'.
+     * Note: Its first row is the bottom of the image, like overlay */
+    GLuint cover_tex;
+    GLuint cover_fb;
+
+} mask_t;
+
+/******************************************************************************
+ *                            FUNCTION DECLARATION                            *
+ ******************************************************************************/
+
+/* Create masks of 'width' x 'height' output from regions in file 'p_file'
+ * (see above). Return masks with non-zero 'vbo', 'texs' and 'fbs' if
+ * successful. Otherwise, they are 0 */
+mask_t mask_create(uint32_t width, uint32_t height, const char * p_file);
+
+/* Delete masks */
+void mask_delete(mask_t * p_mask);
+
+/* Render the content of regions from camera texture 'tex' with 'src_prog'
+ * ('SHADER_PROG_YUV_TO_RGB' without 'SHADER_FLIP_Y') and 'res', which is the
+ * same as the conversion pass (crop, scaling, lens correction...). Then,
+ * blur it with 'blur_prog' ('SHADER_PROG_BLUR') if style is blur.
+ *
+ * Note: The default framebuffer is bound after calling this function.
+ *       The viewport is kept */
+void mask_update(mask_t * p_mask, GLuint src_prog, GLuint blur_prog,
+                 GLenum target, GLuint tex, gl_res_t res);
+
+/* Draw regions onto currently bound framebuffer with 'prog'
+ * ('SHADER_PROG_MASK'). Call this function after 'mask_update' and before
+ * drawing overlay, so overlay stays on top of masks */
+void mask_draw(const mask_t * p_mask, GLuint prog, gl_res_t res);
+
+/* Draw coverage of regions to 'cover_tex' with 'prog' ('SHADER_PROG_MASK'
+ * without 'SHADER_YUV_OUTPUT'). Regions never move, so call this function
+ * once. Then, conversion passes with 'SHADER_MASK' sample 'texs[0]' and
+ * 'cover_tex' after 'mask_update', instead of calling 'mask_draw'.
+ * Return false if failed */
+bool mask_draw_coverage(mask_t * p_mask, GLuint prog, gl_res_t res);
+
+#endif /* _MASK_H_ */
@@ -0,0 +1,140 @@
+/* Copyright (c) 2023 Renesas Electronics Corp.
+ * SPDX-License-Identifier: MIT-0 */
+
+/*******************************************************************************
+ * FILENAME: motion.h
+ *
+ * DESCRIPTION:
+ *   Motion detection functions.
+ *
+ *   Each camera frame is rendered as a tiny luma frame, and differenced
+ *   against the previous one in the same pass. The result is copied to one
+ *   of 'MOTION_READBACK_COUNT' pixel buffer objects, and read by the CPU
+ *   after the GPU passes its fence (normally a frame or two later). So,
+ *   motion detection never waits for the GPU, and the stream does not have
+ *   to be decoded again by a separate analytics process.
+ *
+ *   The result is a motion score (the ratio of changed pixels) and a grid
+ *   of 'MOTION_GRID_COLS' x 'MOTION_GRID_ROWS' cells which tells where the
+ *   motion is.
+ *
+ * PUBLIC FUNCTIONS:
+ *   motion_create
+ *   motion_delete
+ *   motion_update
+ *   motion_is_cell_moving
+ *   motion_get_cell_rect
+ *   motion_write_result
+ *
+ * AUTHOR: RVC       START DATE: 15/03/2023
+ *
+ ******************************************************************************/
+
+#ifndef _MOTION_H_
+#define _MOTION_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "gl.h"
+
+/******************************************************************************
+ *                              MACRO VARIABLES                               *
+ ******************************************************************************/
+
+/* Size of luma frames (in pixels). They cover the entire output */
+#define MOTION_WIDTH  64
+#define MOTION_HEIGHT 48
+
+/* Size of grid (in cells). Each cell is 4x4 pixels of luma frame.
+ * Note: A row of grid is a 16-bit mask */
+#define MOTION_GRID_COLS 16
+#define MOTION_GRID_ROWS 12
+
+/* Difference of luma (0 to 255) at which a pixel is treated as changed.
+ * Sensor noise should be below it */
+#define MOTION_PIXEL_THRESHOLD 16
+
+/* Ratio of changed pixels at which a cell is treated as moving */
+#define MOTION_CELL_THRESHOLD 0.25f
+
+/* The number of pixel buffer objects, which is the max number of frames
+ * whose results are not read yet */
+#define MOTION_READBACK_COUNT 3
+
+/******************************************************************************
+ *                            STRUCTURE DEFINITION                            *
+ ******************************************************************************/
+
+typedef struct
+{
+    /* RGBA textures of luma frames (R: luma, G: difference from previous
+     * frame) and their framebuffers.
+     * Note: Their first row is the top of the image, like NV12 buffers */
+    GLuint texs[2];
+    GLuint fbs[2];
+
+    /* Pixel buffer objects, their fences (NULL if not in use), and frames
+     * which are copied to them */
+    GLuint pbos[MOTION_READBACK_COUNT];
+    GLsync fences[MOTION_READBACK_COUNT];
+    uint32_t pbo_frames[MOTION_READBACK_COUNT];
+
+    /* The oldest pixel buffer object which is not read yet, and the number
+     * of such buffers */
+    uint32_t first;
+    uint32_t pending;
+
+    /* Number of rendered frames */
+    uint32_t frame;
+
+    /* Latest result: frame which it belongs to (counted from 0), ratio of
+     * changed pixels (0 to 1), and moving cells (bit 'col' of row 'row').
+     * Note: Row 0 is the top of the image */
+    uint32_t result_frame;
+    float score;
+    uint16_t grid[MOTION_GRID_ROWS];
+
+} motion_t;
+
+/******************************************************************************
+ *                            FUNCTION DECLARATION                            *
+ ******************************************************************************/
+
+/* Create motion detection.
+ * Note: Check 'texs', 'fbs' and 'pbos' of the returned struct. They are 0 if
+ *       failed */
+motion_t motion_create(void);
+
+/* Delete motion detection */
+void motion_delete(motion_t * p_motion);
+
+/* Render camera texture 'tex' with 'prog' ('SHADER_PROG_MOTION') and 'res'
+ * (crop, scaling...) as a luma frame, and start copying it to the CPU.
+ * Then, read results of earlier frames which the GPU has finished.
+ * Return true if 'result_frame', 'score' and 'grid' are updated.
+ *
+ * Note: The default framebuffer is bound after calling this function */
+bool motion_update(motion_t * p_motion, GLuint prog,
+                   GLenum target, GLuint tex, gl_res_t res);
+
+/* Return true if cell ('col', 'row') of the latest result is moving */
+bool motion_is_cell_moving(const motion_t * p_motion,
+                           uint32_t col, uint32_t row);
+
+/* Return area of cell ('col', 'row') on 'width' x 'height' output.
+ * Note: Origin of the area is the bottom-left corner of the image */
+rect_t motion_get_cell_rect(uint32_t col, uint32_t row,
+                            uint32_t width, uint32_t height);
+
+/* Write the latest result to 'p_file' as a line of text, so that external
+ * tools can read it (such as from a named pipe):
+ *
+ *   FRAME SCORE ROW0 ROW1 ... ROW11
+ *
+ * SCORE is between 0 and 1. Rows are 16-bit masks in hexadecimal (bit 0 is
+ * the left column). The line is flushed immediately */
+void motion_write_result(const motion_t * p_motion, FILE * p_file);
+
+#endif /* _MOTION_H_ */
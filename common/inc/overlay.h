@@ -0,0 +1,112 @@
+/* Copyright (c) 2023 Renesas Electronics Corp.
+ * SPDX-License-Identifier: MIT-0 */
+
+/*******************************************************************************
+ * FILENAME: overlay.h
+ *
+ * DESCRIPTION:
+ *   Persistent overlay layer functions.
+ *
+ *   Overlay content (shapes, text, images...) is rendered into an RGBA
+ *   texture only where it has changed. Then, the texture is blended onto
+ *   every video frame with a single pass, so per-frame cost does not depend
+ *   on how complex the overlay is.
+ *
+ * PUBLIC FUNCTIONS:
+ *   overlay_create
+ *   overlay_delete
+ *
+ *   overlay_invalidate
+ *   overlay_invalidate_all
+ *   overlay_is_dirty
+ *
+ *   overlay_begin
+ *   overlay_end
+ *
+ *   overlay_composite
+ *
+ * AUTHOR: RVC       START DATE: 15/03/2023
+ *
+ ******************************************************************************/
+
+#ifndef _OVERLAY_H_
+#define _OVERLAY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "gl.h"
+
+/******************************************************************************
+ *                            STRUCTURE DEFINITION                            *
+ ******************************************************************************/
+
+typedef struct
+{
+    /* Size of overlay (should be equal to size of video frame) */
+    uint32_t width;
+    uint32_t height;
+
+    /* RGBA texture (premultiplied alpha) and its framebuffer */
+    GLuint tex;
+    GLuint fb;
+
+    /* Internal format and size (in bytes) of texture */
+    GLenum format;
+    size_t size;
+
+    /* Bounding box of all areas which must be redrawn.
+     * Note: The box is empty if its width or height is 0 */
+    rect_t dirty;
+
+} overlay_t;
+
+/******************************************************************************
+ *                            FUNCTION DECLARATION                            *
+ ******************************************************************************/
+
+/* Create a transparent 'width' x 'height' overlay.
+ * The entire overlay is marked as dirty so that it's drawn at the first frame.
+ *
+ * 'format' is the internal format of texture. It must have an alpha channel:
+ *   - 'GL_RGBA8':   Best quality.
+ *   - 'GL_RGBA4':   Half the memory and bandwidth. Smooth edges of text and
+ *                   shapes get 16 levels of alpha.
+ *   - 'GL_RGB5_A1': Half the memory and bandwidth. Edges become aliased.
+ *
+ * Note: Check 'tex' and 'fb' of the returned overlay. They are 0 if failed */
+overlay_t overlay_create(uint32_t width, uint32_t height, GLenum format);
+
+/* Delete overlay */
+void overlay_delete(overlay_t * p_overlay);
+
+/* Mark area 'rect' of overlay as dirty.
+ * Call this function when content inside 'rect' is added, moved, or removed.
+ *
+ * Note: For content which moves, both old and new areas should be marked */
+void overlay_invalidate(overlay_t * p_overlay, rect_t rect);
+
+/* Mark entire overlay as dirty */
+void overlay_invalidate_all(overlay_t * p_overlay);
+
+/* Return true if overlay has dirty areas */
+bool overlay_is_dirty(const overlay_t * p_overlay);
+
+/* Start redrawing dirty areas of overlay.
+ * Return false if there is nothing to redraw. Otherwise, bind framebuffer of
+ * overlay, clear dirty areas, and limit rendering to them (scissor test).
+ * Then, draw all content (everything outside dirty areas is discarded)
+ * and call 'overlay_end'.
+ *
+ * Note: The default framebuffer is bound after calling 'overlay_end' */
+bool overlay_begin(const overlay_t * p_overlay);
+
+/* Finish redrawing overlay and mark it as clean */
+void overlay_end(overlay_t * p_overlay);
+
+/* Blend overlay onto currently bound framebuffer.
+ * Note: 'prog' should just output sampled texels, such as 'overlay.fs.glsl' */
+void overlay_composite(GLuint prog, const overlay_t * p_overlay,
+                       gl_res_t res);
+
+#endif /* _OVERLAY_H_ */
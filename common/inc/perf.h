@@ -0,0 +1,119 @@
+/* Copyright (c) 2023 Renesas Electronics Corp.
+ * SPDX-License-Identifier: MIT-0 */
+
+/*******************************************************************************
+ * FILENAME: perf.h
+ *
+ * DESCRIPTION:
+ *   Render pass profiling functions.
+ *
+ *   Each pass (conversion, overlay, display...) is measured on the GPU with
+ *   GL_EXT_disjoint_timer_query and on the CPU. Queries are read back
+ *   'PERF_QUERY_DEPTH' frames later, so measuring never waits for the GPU.
+ *   Every 'PERF_REPORT_FRAMES' frames, min/avg/p99 GPU time and avg CPU time
+ *   of each pass are printed.
+ *
+ * PUBLIC FUNCTIONS:
+ *   perf_create
+ *   perf_delete
+ *
+ *   perf_add_pass
+ *   perf_begin
+ *   perf_end
+ *   perf_end_frame
+ *
+ * AUTHOR: RVC       START DATE: 15/03/2023
+ *
+ ******************************************************************************/
+
+#ifndef _PERF_H_
+#define _PERF_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "gl.h"
+
+/******************************************************************************
+ *                              MACRO VARIABLES                               *
+ ******************************************************************************/
+
+/* The maximum number of passes */
+#define PERF_MAX_PASSES 12
+
+/* The number of frames between issuing a query and reading its result */
+#define PERF_QUERY_DEPTH 4
+
+/* The number of frames per report */
+#define PERF_REPORT_FRAMES 300
+
+/******************************************************************************
+ *                           STRUCTURE DEFINITIONS                            *
+ ******************************************************************************/
+
+typedef struct
+{
+    /* Name of pass (shown in reports) */
+    const char * p_name;
+
+    /* Ring of timer queries (one per frame) and whether they are in flight */
+    GLuint queries[PERF_QUERY_DEPTH];
+    bool b_pending[PERF_QUERY_DEPTH];
+
+    /* CPU time (in microseconds) when the current measurement started */
+    int64_t cpu_start_us;
+
+    /* GPU times (in microseconds) collected since the last report */
+    float gpu_us[PERF_REPORT_FRAMES];
+    uint32_t gpu_count;
+
+    /* Total CPU time (in microseconds) and the number of measurements since
+     * the last report */
+    int64_t cpu_total_us;
+    uint32_t cpu_count;
+
+} perf_pass_t;
+
+typedef struct
+{
+    /* False if profiling is disabled or not supported.
+     * Then, all functions do nothing */
+    bool b_enabled;
+
+    /* Passes */
+    perf_pass_t passes[PERF_MAX_PASSES];
+    uint32_t pass_count;
+
+    /* The number of frames since the start and the last report */
+    uint32_t frame;
+    uint32_t report_frame;
+
+} perf_t;
+
+/******************************************************************************
+ *                            FUNCTION DECLARATION                            *
+ ******************************************************************************/
+
+/* Create profiler. If 'b_enabled' is false or GL_EXT_disjoint_timer_query is
+ * not supported, the profiler is disabled.
+ * Return NULL if failed */
+perf_t * perf_create(bool b_enabled);
+
+/* Delete profiler */
+void perf_delete(perf_t * p_perf);
+
+/* Add pass 'p_name' (it must be a string literal or live as long as
+ * the profiler). Return ID of pass or -1 if there are too many passes */
+int perf_add_pass(perf_t * p_perf, const char * p_name);
+
+/* Start and stop measuring pass 'pass' of the current frame.
+ * Note: Passes must not be nested, because only 1 timer query can be active
+ *       at a time */
+void perf_begin(perf_t * p_perf, int pass);
+void perf_end(perf_t * p_perf, int pass);
+
+/* Mark end of frame. Results of earlier frames are collected and a report is
+ * printed every 'PERF_REPORT_FRAMES' frames */
+void perf_end_frame(perf_t * p_perf);
+
+#endif /* _PERF_H_ */
@@ -0,0 +1,113 @@
+/* Copyright (c) 2023 Renesas Electronics Corp.
+ * SPDX-License-Identifier: MIT-0 */
+
+/*******************************************************************************
+ * FILENAME: pip.h
+ *
+ * DESCRIPTION:
+ *   Picture-in-picture functions.
+ *
+ *   Frames of a second camera (such as a door camera) are imported as
+ *   EGLImages (zero-copy, like the main camera) and drawn as an inset of
+ *   the output. The second camera is never waited for: each frame, filled
+ *   buffers which are ready are dequeued without blocking, and the latest
+ *   one is kept for drawing. So, the main camera keeps its frame rate even
+ *   if the second camera is slower or stops.
+ *
+ * PUBLIC FUNCTIONS:
+ *   pip_create
+ *   pip_delete
+ *   pip_update
+ *   pip_draw
+ *
+ * AUTHOR: RVC       START DATE: 15/03/2023
+ *
+ ******************************************************************************/
+
+#ifndef _PIP_H_
+#define _PIP_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "gl.h"
+#include "egl.h"
+
+/******************************************************************************
+ *                              MACRO VARIABLES                               *
+ ******************************************************************************/
+
+/* Frame size of the second camera (in pixels). The inset is stretched to
+ * its area, so the area should have the same aspect ratio (4:3) */
+#define PIP_CAM_WIDTH  640
+#define PIP_CAM_HEIGHT 480
+
+/* The number of YUYV buffers of the second camera. 1 is kept for drawing */
+#define PIP_BUFFER_COUNT 3
+
+/* Default inset: 1/4 of the output width, 'PIP_MARGIN' pixels away from the
+ * bottom-right corner */
+#define PIP_DEFAULT_SCALE 4
+#define PIP_MARGIN        16
+
+/******************************************************************************
+ *                            STRUCTURE DEFINITION                            *
+ ******************************************************************************/
+
+typedef struct
+{
+    /* File descriptor of the second camera (-1 if not opened) */
+    int cam_fd;
+
+    /* YUYV buffers, their images and textures */
+    EGLDisplay display;
+
+    v4l2_dmabuf_exp_t * p_bufs;
+    EGLImageKHR * p_imgs;
+    GLuint * p_texs;
+
+    /* Buffer which is drawn (-1 if no frame has arrived yet).
+     * It's dequeued until a newer frame replaces it */
+    int index;
+
+    /* Area of inset and size of output (in pixels).
+     * Note: Origin of area is the bottom-left corner of the image */
+    rect_t area;
+
+    uint32_t out_width;
+    uint32_t out_height;
+
+} pip_t;
+
+/******************************************************************************
+ *                            FUNCTION DECLARATION                            *
+ ******************************************************************************/
+
+/* Open camera 'p_dev', import its buffers to 'display', and start capturing.
+ * The inset is drawn at 'area' of 'out_width' x 'out_height' output. If width
+ * or height of 'area' is 0, the default inset is used.
+ * Note: Check 'p_texs' of the returned struct. It's NULL if failed */
+pip_t pip_create(EGLDisplay display, const char * p_dev, rect_t area,
+                 uint32_t out_width, uint32_t out_height);
+
+/* Stop capturing, delete textures and images, and close camera.
+ * Nothing happens if 'p_pip' is not created (zero-initialized) */
+void pip_delete(pip_t * p_pip);
+
+/* Dequeue all frames which are ready (without blocking) and keep the latest
+ * one. The previous one is given back to the camera.
+ * Return true if a new frame is kept.
+ *
+ * Note: Call this function once per output frame, after the GPU has
+ *       finished drawing the previous inset */
+bool pip_update(pip_t * p_pip);
+
+/* Draw the latest frame to its area of the currently bound framebuffer with
+ * 'prog' and 'res'. 'prog' samples YUYV textures, such as
+ * 'SHADER_PROG_YUYV_TO_NV12' for NV12 framebuffers (first row at the top,
+ * 'b_top_down' of 'res' is set) or 'SHADER_PROG_YUV_TO_RGB' with
+ * 'SHADER_FLIP_Y' for RGBA framebuffers. Nothing is drawn until the first
+ * frame arrives */
+void pip_draw(const pip_t * p_pip, GLuint prog, gl_res_t res);
+
+#endif /* _PIP_H_ */
@@ -26,6 +26,23 @@
 /* Max length of camera device file */
 #define CAM_DEV_MAX_LEN 50
 
+/* Max length of privacy mask file */
+#define MASK_FILE_MAX_LEN 256
+
+/* Max length of motion detection file */
+#define MOTION_FILE_MAX_LEN 256
+
+/* Max length of prefix of snapshot files */
+#define SNAPSHOT_PREFIX_MAX_LEN 256
+
+/* Max length of name of shared memory for overlay commands */
+#define IPC_NAME_MAX_LEN 256
+
+/* Ways to write NV12 frames (option '-n') */
+#define NV12_WRITER_AUTO   0 /* 1 pass if 'GL_EXT_YUV_target' is supported */
+#define NV12_WRITER_PLANES 1 /* 2 passes to Y and UV planes                */
+#define NV12_WRITER_BENCH  2 /* Alternate both every frame (to compare)    */
+
 /******************************************************************************
  *                            STRUCTURE DEFINITION                            *
  ******************************************************************************/
@@ -45,6 +62,72 @@ typedef struct
     /* Framerate of camera */
     framerate_t framerate;
 
+    /* Size of output (display, encoder input). If not specified, it's the
+     * same as frame size of camera */
+    size_t out_width;
+    size_t out_height;
+
+    /* Size of low-resolution sub-stream, encoded along with the main stream.
+     * It's 0 if there is no sub-stream */
+    size_t sub_width;
+    size_t sub_height;
+
+    /* Digital zoom into the center of camera frame (1: no zoom) */
+    float zoom;
+
+    /* Clockwise rotation of camera frame (0, 90, 180, or 270 degrees) */
+    uint32_t rotation;
+
+    /* Mirror camera frame horizontally and/or vertically */
+    bool b_mirror_x;
+    bool b_mirror_y;
+
+    /* Way to write NV12 frames ('NV12_WRITER_AUTO'...) */
+    uint32_t nv12_writer;
+
+    /* Radial distortion coefficients of lens (see 'lens.h').
+     * Both are 0 if distortion is not corrected */
+    float lens_k1;
+    float lens_k2;
+
+    /* Max weight of previous frame in temporal denoise (0: no denoise) */
+    float denoise;
+
+    /* File of privacy masks (see 'mask.h'). It's empty if there are no masks */
+    char mask_file[MASK_FILE_MAX_LEN];
+
+    /* File which results of motion detection are written to (see 'motion.h').
+     * It's empty if motion is not detected */
+    char motion_file[MOTION_FILE_MAX_LEN];
+
+    /* Prefix of JPEG snapshots taken on 'SIGUSR1' (see 'snapshot.h').
+     * It's empty if snapshots are disabled */
+    char snapshot_prefix[SNAPSHOT_PREFIX_MAX_LEN];
+
+    /* Device file of the second camera, drawn as picture-in-picture (see
+     * 'pip.h'). It's empty if there is no second camera */
+    char pip_dev[CAM_DEV_MAX_LEN];
+
+    /* Area of picture-in-picture (in pixels of output, origin at the
+     * bottom-left corner). Size is 0 for the default area */
+    int32_t pip_x;
+    int32_t pip_y;
+    size_t pip_width;
+    size_t pip_height;
+
+    /* Stabilize camera frames (see 'stabilize.h') */
+    bool b_stabilize;
+
+    /* Burn capture time and frame counter into frames (see 'timestamp.h') */
+    bool b_timestamp;
+
+    /* Name of shared memory through which external processes publish
+     * overlay commands (see 'ipc.h'). It's empty if it's not created */
+    char ipc_name[IPC_NAME_MAX_LEN];
+
+    /* Profile render passes on the GPU */
+    bool b_perf;
+
 } prog_opts_t;
 
 /******************************************************************************
@@ -0,0 +1,74 @@
+/* Copyright (c) 2023 Renesas Electronics Corp.
+ * SPDX-License-Identifier: MIT-0 */
+
+/*******************************************************************************
+ * FILENAME: shader.h
+ *
+ * DESCRIPTION:
+ *   Embedded shader functions.
+ *
+ *   Shaders in 'common/shaders' are embedded into apps at build time (see
+ *   'Makefile'). Each program is specialized by preprocessor definitions
+ *   (color standard, range, flip, overlay...), so shaders have no runtime
+ *   branches for these options and no shader files are read at runtime.
+ *
+ * PUBLIC FUNCTIONS:
+ *   shader_create_prog
+ *
+ * AUTHOR: RVC       START DATE: 15/03/2023
+ *
+ ******************************************************************************/
+
+#ifndef _SHADER_H_
+#define _SHADER_H_
+
+#include <stdint.h>
+
+#include "gl.h"
+
+/******************************************************************************
+ *                              MACRO VARIABLES                               *
+ ******************************************************************************/
+
+/* Programs */
+#define SHADER_PROG_RECTANGLE    0 /* Draw rectangle                         */
+#define SHADER_PROG_TEXT         1 /* Draw bitmap text                       */
+#define SHADER_PROG_SDF_TEXT     2 /* Draw signed distance field text        */
+#define SHADER_PROG_BATCH        3 /* Draw batch of shapes                   */
+#define SHADER_PROG_YUV_TO_RGB   4 /* Draw YUYV or NV12 texture in RGB       */
+#define SHADER_PROG_YUYV_TO_NV12 5 /* Convert YUYV texture to NV12           */
+#define SHADER_PROG_OVERLAY      6 /* Blend overlay layer onto framebuffer   */
+#define SHADER_PROG_DENOISE      7 /* Blend YUYV texture with previous frame */
+#define SHADER_PROG_BLUR         8 /* Blur RGB texture in 1 direction        */
+#define SHADER_PROG_MASK         9 /* Draw privacy masks                     */
+#define SHADER_PROG_MOTION      10 /* Render luma frame for motion detection */
+#define SHADER_PROG_STABILIZE   11 /* Match luma frames for stabilization    */
+#define SHADER_PROG_COUNT       12
+
+/* Variants. By default, programs write RGBA, colors are BT.601 full range,
+ * textures are not flipped, no overlay is blended, and YUV textures are
+ * sampled as YUV ('GL_EXT_YUV_target') */
+#define SHADER_YUV_OUTPUT    (1 << 0) /* Write YUV to NV12 framebuffer       */
+#define SHADER_BT709         (1 << 1) /* Use BT.709 instead of BT.601        */
+#define SHADER_LIMITED_RANGE (1 << 2) /* Use limited range (16-235)          */
+#define SHADER_FLIP_Y        (1 << 3) /* Flip texture vertically             */
+#define SHADER_OVERLAY       (1 << 4) /* Blend overlay texture (texture 1)   */
+#define SHADER_RGB_INPUT     (1 << 5) /* Sample YUV textures in RGB          */
+#define SHADER_LUMA_OUTPUT   (1 << 6) /* Write Y plane of NV12 (R8)          */
+#define SHADER_CHROMA_OUTPUT (1 << 7) /* Write UV plane of NV12 (RG8)        */
+#define SHADER_RGBA_INPUT    (1 << 8) /* Sample camera from RGBA texture     */
+#define SHADER_MASK          (1 << 9) /* Apply privacy masks (textures 2, 3) */
+
+/******************************************************************************
+ *                            FUNCTION DECLARATION                            *
+ ******************************************************************************/
+
+/* Create variant 'flags' (combination of 'SHADER_YUV_OUTPUT'...) of program
+ * 'prog' ('SHADER_PROG_RECTANGLE'...) from embedded shaders.
+ * Return program's ID (positive integer) if successful.
+ *
+ * Note: Flags which do not apply to the program are ignored. The program
+ *       binary is cached (see 'gl_create_prog_from_str') */
+GLuint shader_create_prog(uint32_t prog, uint32_t flags);
+
+#endif /* _SHADER_H_ */
@@ -0,0 +1,117 @@
+/* Copyright (c) 2023 Renesas Electronics Corp.
+ * SPDX-License-Identifier: MIT-0 */
+
+/*******************************************************************************
+ * FILENAME: snapshot.h
+ *
+ * DESCRIPTION:
+ *   Snapshot functions.
+ *
+ *   A still image of the output frame (with overlay) is saved as a JPEG file
+ *   on demand, without stalling the live pipeline. The frame is rendered to
+ *   an RGBA texture and copied to a pixel buffer object. When the GPU passes
+ *   its fence (normally a frame later), the buffer is mapped and handed to a
+ *   low-priority worker thread, which encodes it. The buffer is unmapped
+ *   when the file is written. Only 1 snapshot is in progress at a time.
+ *
+ *   Snapshots are named 'PREFIX-NNNN.jpg', where NNNN counts from 0000.
+ *
+ * PUBLIC FUNCTIONS:
+ *   snapshot_create
+ *   snapshot_delete
+ *   snapshot_capture
+ *   snapshot_update
+ *
+ * AUTHOR: RVC       START DATE: 15/03/2023
+ *
+ ******************************************************************************/
+
+#ifndef _SNAPSHOT_H_
+#define _SNAPSHOT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#include "gl.h"
+
+/******************************************************************************
+ *                              MACRO VARIABLES                               *
+ ******************************************************************************/
+
+/* Quality of JPEG files (0 to 100) */
+#define SNAPSHOT_JPEG_QUALITY 90
+
+/* States of snapshot */
+#define SNAPSHOT_STATE_IDLE     0 /* Ready to capture                         */
+#define SNAPSHOT_STATE_READING  1 /* The GPU is copying frame to the buffer   */
+#define SNAPSHOT_STATE_ENCODING 2 /* The worker thread is encoding the buffer */
+#define SNAPSHOT_STATE_ENCODED  3 /* The buffer can be unmapped               */
+
+/******************************************************************************
+ *                            STRUCTURE DEFINITION                            *
+ ******************************************************************************/
+
+typedef struct
+{
+    /* Size of output (in pixels) */
+    uint32_t width;
+    uint32_t height;
+
+    /* Prefix of file names, and the number of snapshots taken so far */
+    const char * p_prefix;
+    uint32_t count;
+
+    /* RGBA texture of output frame, its framebuffer, and the 1:1 scaling
+     * to it.
+     * Note: Its first row is the top of the image, like NV12 buffers */
+    GLuint tex;
+    GLuint fb;
+    scaler_t scaler;
+
+    /* Pixel buffer object and its fence (NULL if not in use) */
+    GLuint pbo;
+    GLsync fence;
+
+    /* State ('SNAPSHOT_STATE_IDLE'...) and the mapped buffer (RGBA).
+     * Both are shared with the worker thread, and protected by 'mutex' */
+    uint32_t state;
+    const uint8_t * p_pixels;
+
+    /* Worker thread. It waits on 'cond' until the state becomes
+     * 'SNAPSHOT_STATE_ENCODING' or 'b_quit' is set */
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    bool b_quit;
+
+} snapshot_t;
+
+/******************************************************************************
+ *                            FUNCTION DECLARATION                            *
+ ******************************************************************************/
+
+/* Create snapshot of 'width' x 'height' output. Files are named after
+ * 'p_prefix' (it must live as long as the snapshot).
+ * Return NULL if failed */
+snapshot_t * snapshot_create(uint32_t width, uint32_t height,
+                             const char * p_prefix);
+
+/* Delete snapshot. A snapshot which is being encoded is finished first */
+void snapshot_delete(snapshot_t * p_snapshot);
+
+/* Render output texture 'tex' (such as NV12 texture of the frame sent to
+ * the encoder) with 'prog' ('SHADER_PROG_YUV_TO_RGB' without 'SHADER_FLIP_Y')
+ * and start copying it to the CPU. 'res' is only used for its resources.
+ * Return false if the previous snapshot is still in progress.
+ *
+ * Note: The default framebuffer is bound after calling this function */
+bool snapshot_capture(snapshot_t * p_snapshot, GLuint prog,
+                      GLenum target, GLuint tex, gl_res_t res);
+
+/* Hand the copied frame to the worker thread once the GPU has finished it,
+ * and release the buffer once it's encoded. Call this function every frame.
+ * It never waits for the GPU or the worker thread */
+void snapshot_update(snapshot_t * p_snapshot);
+
+#endif /* _SNAPSHOT_H_ */
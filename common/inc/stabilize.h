@@ -0,0 +1,124 @@
+/* Copyright (c) 2023 Renesas Electronics Corp.
+ * SPDX-License-Identifier: MIT-0 */
+
+/*******************************************************************************
+ * FILENAME: stabilize.h
+ *
+ * DESCRIPTION:
+ *   Digital image stabilization functions.
+ *
+ *   Global motion of camera frames (such as a camera on a pole shaking in
+ *   the wind) is estimated by block matching on the GPU. Each camera frame
+ *   is rendered as a small luma frame, then a tiny pass computes the
+ *   difference from the previous luma frame for every shift in the search
+ *   window. The CPU reads these costs back (a few hundred pixels), picks the
+ *   best shift, and smooths the trajectory of the content. Finally, the crop
+ *   of the conversion pass is moved against the shake, so stabilization
+ *   costs no extra full-frame pass.
+ *
+ *   The crop is zoomed by 'STABILIZE_ZOOM', so that there is a margin for
+ *   moving it.
+ *
+ * PUBLIC FUNCTIONS:
+ *   stabilize_create
+ *   stabilize_delete
+ *   stabilize_update
+ *   stabilize_apply
+ *
+ * AUTHOR: RVC       START DATE: 15/03/2023
+ *
+ ******************************************************************************/
+
+#ifndef _STABILIZE_H_
+#define _STABILIZE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "gl.h"
+
+/******************************************************************************
+ *                              MACRO VARIABLES                               *
+ ******************************************************************************/
+
+/* Size of luma frames (in pixels). They cover the entire camera frame */
+#define STABILIZE_WIDTH  128
+#define STABILIZE_HEIGHT 96
+
+/* Max shift between 2 frames (in pixels of luma frame) which is searched.
+ * The search window is 'STABILIZE_WINDOW' x 'STABILIZE_WINDOW' shifts */
+#define STABILIZE_SEARCH_RADIUS 8
+#define STABILIZE_WINDOW        ((2 * STABILIZE_SEARCH_RADIUS) + 1)
+
+/* Extra zoom of the crop. The crop can move by half of the margin
+ * (about 4.5% of the camera frame) in each direction */
+#define STABILIZE_ZOOM 1.1f
+
+/* Weight of the current position when the trajectory is smoothed (0 to 1).
+ * Smaller values remove more shake, but follow panning more slowly */
+#define STABILIZE_SMOOTHING 0.1f
+
+/******************************************************************************
+ *                            STRUCTURE DEFINITION                            *
+ ******************************************************************************/
+
+typedef struct
+{
+    /* Size of camera frame (in pixels) */
+    uint32_t cam_width;
+    uint32_t cam_height;
+
+    /* RGBA textures of luma frames (R: luma) and their framebuffers.
+     * Note: Their first row is the top of the image */
+    GLuint texs[2];
+    GLuint fbs[2];
+
+    /* RGBA texture of costs of shifts and its framebuffer */
+    GLuint cost_tex;
+    GLuint cost_fb;
+
+    /* Number of analyzed frames */
+    uint32_t frame;
+
+    /* Position of the content (sum of shifts since the first frame), its
+     * smoothed position, and the offset of crop which compensates the
+     * difference (in pixels of camera frame).
+     * Note: Origin is the top-left corner of the image */
+    float path_x;
+    float path_y;
+    float smooth_x;
+    float smooth_y;
+    float offset_x;
+    float offset_y;
+
+} stabilize_t;
+
+/******************************************************************************
+ *                            FUNCTION DECLARATION                            *
+ ******************************************************************************/
+
+/* Create stabilization of 'cam_width' x 'cam_height' camera frames.
+ * Note: Check 'texs', 'fbs' and 'cost_fb' of the returned struct. They are 0
+ *       if failed */
+stabilize_t stabilize_create(uint32_t cam_width, uint32_t cam_height);
+
+/* Delete stabilization */
+void stabilize_delete(stabilize_t * p_stab);
+
+/* Render camera texture 'tex' as a luma frame with 'luma_prog'
+ * ('SHADER_PROG_MOTION'), match it against the previous one with
+ * 'match_prog' ('SHADER_PROG_STABILIZE'), and update the offset of crop.
+ * 'res' is only used for its resources.
+ *
+ * Note: The default framebuffer is bound after calling this function */
+void stabilize_update(stabilize_t * p_stab, GLuint luma_prog,
+                      GLuint match_prog, GLenum target, GLuint tex,
+                      gl_res_t res);
+
+/* Zoom 'p_scaler' into camera frame by 'zoom' (and 'STABILIZE_ZOOM'),
+ * centered at ('center_x', 'center_y') moved by the offset of crop.
+ * It replaces 'gl_set_zoom' for the conversion pass */
+void stabilize_apply(const stabilize_t * p_stab, scaler_t * p_scaler,
+                     float zoom, float center_x, float center_y);
+
+#endif /* _STABILIZE_H_ */
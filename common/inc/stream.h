@@ -0,0 +1,86 @@
+/* Copyright (c) 2023 Renesas Electronics Corp.
+ * SPDX-License-Identifier: MIT-0 */
+
+/*******************************************************************************
+ * FILENAME: stream.h
+ *
+ * DESCRIPTION:
+ *   Streaming vertex buffer functions.
+ *
+ *   Dynamic geometry (text, batches of shapes...) is written to a ring buffer
+ *   which is split into 'STREAM_REGION_COUNT' regions. Data is appended to
+ *   the current region with unsynchronized mapping, so uploads never wait for
+ *   draw calls which still read earlier data. When a region is full, a fence
+ *   is inserted and the next region is used. A region is only reused after
+ *   the GPU passes its fence, which normally happened frames ago.
+ *
+ * PUBLIC FUNCTIONS:
+ *   stream_create
+ *   stream_delete
+ *
+ *   stream_upload
+ *
+ * AUTHOR: RVC       START DATE: 15/03/2023
+ *
+ ******************************************************************************/
+
+#ifndef _STREAM_H_
+#define _STREAM_H_
+
+#include <stdint.h>
+
+#include <GLES3/gl3.h>
+
+/******************************************************************************
+ *                              MACRO VARIABLES                               *
+ ******************************************************************************/
+
+/* The number of regions of ring buffer */
+#define STREAM_REGION_COUNT 4
+
+/* Alignment (in bytes) of data in the buffer.
+ * Note: It's the size of vertex <vec2 pos, vec2 tex>, so the offset of
+ *       such vertices can be converted to a vertex index */
+#define STREAM_ALIGNMENT 16
+
+/******************************************************************************
+ *                           STRUCTURE DEFINITIONS                            *
+ ******************************************************************************/
+
+typedef struct
+{
+    /* Vertex buffer object */
+    GLuint vbo;
+
+    /* Size (in bytes) of 1 region */
+    uint32_t region_size;
+
+    /* Current region and the offset (in bytes) of free space in it */
+    uint32_t region;
+    uint32_t offset;
+
+    /* Fence of each region (NULL if the region is not in use by GPU) */
+    GLsync fences[STREAM_REGION_COUNT];
+
+} stream_t;
+
+/******************************************************************************
+ *                            FUNCTION DECLARATION                            *
+ ******************************************************************************/
+
+/* Create a streaming vertex buffer of 'size' bytes.
+ * Return pointer to the stream if successful. Otherwise, return NULL */
+stream_t * stream_create(uint32_t size);
+
+/* Delete stream */
+void stream_delete(stream_t * p_stream);
+
+/* Copy 'size' bytes of 'p_data' to the stream.
+ * Return offset (in bytes, multiple of 'STREAM_ALIGNMENT') of the data in
+ * 'vbo' if successful. Otherwise, return -1.
+ *
+ * Note: 'vbo' is bound to 'GL_ARRAY_BUFFER' after the function returns.
+ *       The data must be smaller than a region */
+int32_t stream_upload(stream_t * p_stream, const void * p_data, uint32_t size);
+
+#endif /* _STREAM_H_ */
@@ -0,0 +1,104 @@
+/* Copyright (c) 2023 Renesas Electronics Corp.
+ * SPDX-License-Identifier: MIT-0 */
+
+/*******************************************************************************
+ * FILENAME: timestamp.h
+ *
+ * DESCRIPTION:
+ *   Timestamp burn-in functions.
+ *
+ *   The capture time of each camera frame (with milliseconds) and its frame
+ *   counter are drawn as signed distance field text, such as:
+ *
+ *     2023-03-15 09:41:27.533 #00001234
+ *
+ *   The text has a fixed layout: every character has its own slot, and
+ *   digits share the same (widest) advance, so slots never move. Vertices of
+ *   all slots are kept in memory. Each frame, only slots whose character has
+ *   changed (normally the last few digits) are laid out again, then the whole
+ *   text is uploaded to the streaming vertex buffer ('stream.h') and drawn
+ *   with a single draw call.
+ *
+ * PUBLIC FUNCTIONS:
+ *   timestamp_create
+ *   timestamp_update
+ *   timestamp_draw
+ *
+ * AUTHOR: RVC       START DATE: 15/03/2023
+ *
+ ******************************************************************************/
+
+#ifndef _TIMESTAMP_H_
+#define _TIMESTAMP_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "gl.h"
+#include "v4l2.h"
+
+/******************************************************************************
+ *                              MACRO VARIABLES                               *
+ ******************************************************************************/
+
+/* Length of text: "YYYY-MM-DD hh:mm:ss.mmm #nnnnnnnn" */
+#define TIMESTAMP_LEN 33
+
+/* Frame counter wraps around after 8 digits */
+#define TIMESTAMP_COUNTER_MOD 100000000
+
+/* Default size (in pixels, em square) of text and its distance from the
+ * top-left corner of the image */
+#define TIMESTAMP_TEXT_SIZE 24.0f
+#define TIMESTAMP_MARGIN    16.0f
+
+/******************************************************************************
+ *                            STRUCTURE DEFINITION                            *
+ ******************************************************************************/
+
+typedef struct
+{
+    /* Vertices of slots. There are 6 vertices (2 triangles) per slot, each
+     * is <vec2 pos, vec2 tex> */
+    float verts[TIMESTAMP_LEN][6][4];
+
+    /* Text whose slots are currently laid out in 'verts' */
+    char text[TIMESTAMP_LEN + 1];
+
+    /* Origin (in pixels) of each slot, and baseline of text */
+    float slot_x[TIMESTAMP_LEN];
+    float y;
+
+    /* Size (in pixels, em square) of text */
+    float size;
+
+    /* Area (in pixels) which any text covers.
+     * Note: Origin is the bottom-left corner of the image */
+    rect_t bounds;
+
+} timestamp_t;
+
+/******************************************************************************
+ *                            FUNCTION DECLARATION                            *
+ ******************************************************************************/
+
+/* Lay out text of 'size' pixels whose baseline starts at ('x', 'y'), with
+ * signed distance field font of 'res' */
+timestamp_t timestamp_create(float x, float y, float size, gl_res_t res);
+
+/* Set text to the capture time and sequence number of camera buffer
+ * 'p_buf', and lay out slots which have changed.
+ * Return true if the text has changed.
+ *
+ * Note: Monotonic timestamps (the default of V4L2 drivers) are converted to
+ *       the local wall-clock time */
+bool timestamp_update(timestamp_t * p_stamp, const struct v4l2_buffer * p_buf,
+                      gl_res_t res);
+
+/* Upload vertices to the stream of 'res', then draw text with 'prog'
+ * ('SHADER_PROG_SDF_TEXT') and 'p_style'.
+ * Note: Outline and shadow should not exceed the spread of the font */
+void timestamp_draw(const timestamp_t * p_stamp, GLuint prog,
+                    const text_style_t * p_style, gl_res_t res);
+
+#endif /* _TIMESTAMP_H_ */
@@ -11,6 +11,9 @@
  *   ttf_generate
  *   ttf_delete_glyphs
  *
+ *   ttf_generate_sdf
+ *   ttf_delete_sdf_font
+ *
  * AUTHOR: RVC       START DATE: 18/04/2023
  *
  ******************************************************************************/
@@ -34,6 +37,22 @@
 #define HORZ_RESOLUTION 96 /* dpi */
 #define VERT_RESOLUTION 96 /* dpi */
 
+/* Size of the em square of glyphs in the signed distance field atlas.
+ * Text of any size is scaled from these glyphs */
+#define SDF_CHAR_SIZE 32 /* pixels */
+
+/* Distance (in pixels of 'SDF_CHAR_SIZE') encoded by the signed distance
+ * field on each side of glyph outlines. It limits the widest outline and
+ * the farthest drop shadow which can be rendered from the atlas */
+#define SDF_SPREAD 4 /* pixels */
+
+/* Glyphs are rasterized 'SDF_UPSCALE' times larger than 'SDF_CHAR_SIZE'
+ * before their distance fields are computed. This keeps corners sharp */
+#define SDF_UPSCALE 4
+
+/* Width of the signed distance field atlas */
+#define SDF_ATLAS_WIDTH 512 /* pixels */
+
 /******************************************************************************
  *                           STRUCTURE DEFINITIONS                            *
  ******************************************************************************/
@@ -41,9 +60,16 @@
 /* https://learnopengl.com/In-Practice/Text-Rendering */
 typedef struct
 {
-    /* Texture's ID (generated from bitmap image of active glyph) */
+    /* Texture's ID (generated from bitmap image of active glyph).
+     * Note: Glyphs of an atlas share the same texture */
     unsigned int tex_id;
 
+    /* Texture coordinates of bitmap image in texture 'tex_id' */
+    float tex_left;
+    float tex_top;
+    float tex_right;
+    float tex_bottom;
+
     /* Width and height (in pixels) of bitmap image */
     int width;
     int height;
@@ -60,6 +86,35 @@ typedef struct
 
 } glyph_t;
 
+/* A font whose glyphs are stored as signed distance fields in one atlas.
+ *
+ * Each texel of the atlas keeps the distance from its center to the closest
+ * glyph outline: 0.5 is on the outline, bigger values are inside the glyph.
+ * Because distances can be interpolated, the same atlas renders text of any
+ * size, and outlines and shadows come from other thresholds of the field.
+ *
+ * https://steamcdn-a.akamaihd.net/apps/valve/2007/SIGGRAPH2007_AlphaTestedMagnification.pdf
+ */
+typedef struct
+{
+    /* Texture's ID of the atlas (single channel) */
+    unsigned int tex_id;
+
+    /* Width and height (in pixels) of the atlas */
+    int width;
+    int height;
+
+    /* Size (in pixels) of the em square which glyph metrics refer to */
+    float size;
+
+    /* Distance (in pixels) encoded on each side of glyph outlines */
+    float spread;
+
+    /* An array of 'glyph_t' objects whose metrics include the spread */
+    glyph_t ** pp_glyphs;
+
+} ttf_sdf_font_t;
+
 /******************************************************************************
  *                            FUNCTION DECLARATION                            *
  ******************************************************************************/
@@ -76,4 +131,15 @@ glyph_t ** ttf_generate(const char * p_file);
 /* Free array 'pp_glyphs' */
 void ttf_delete_glyphs(glyph_t ** pp_glyphs);
 
+/* Generate a signed distance field font from TrueType font 'p_file'.
+ * If the operation is not successful, return NULL.
+ *
+ * Notes:
+ *   - The glyphs are first 128 characters of ASCII table.
+ *   - The font must be freed when no longer used */
+ttf_sdf_font_t * ttf_generate_sdf(const char * p_file);
+
+/* Free font 'p_font' and its atlas */
+void ttf_delete_sdf_font(ttf_sdf_font_t * p_font);
+
 #endif /* _TTF_H_ */
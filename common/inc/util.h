@@ -17,8 +17,11 @@
  *   util_find_whole_str
  *
  *   util_read_file
+ *   util_read_bin_file
  *   util_write_file
  *
+ *   util_hash
+ *
  * AUTHOR: RVC       START DATE: 14/03/2023
  *
  ******************************************************************************/
@@ -78,6 +81,9 @@
 /* Validate framerate */
 #define IS_FRAMERATE_VALID(FPS) (((FPS).den > 0) && ((FPS).num > 0))
 
+/* Initial value of 64-bit FNV-1a hash (see 'util_hash') */
+#define UTIL_HASH_INIT 0xcbf29ce484222325ULL
+
 /******************************************************************************
  *                           STRUCTURE DEFINITIONS                            *
  ******************************************************************************/
@@ -139,8 +145,23 @@ bool util_find_whole_str(const char * p_str_arr,
  * Note: The content must be freed when no longer used */
 char * util_read_file(const char * p_name);
 
+/* Read binary file's contents and store its size in 'p_size'.
+ * Return an array of bytes if successful. Otherwise, return NULL.
+ * Note: The content must be freed when no longer used */
+char * util_read_bin_file(const char * p_name, size_t * p_size);
+
 /* Write data to a file.
  * Note: The data is not freed by this function */
 void util_write_file(const char * p_name, const char * p_buffer, size_t size);
 
+/********************************** FOR HASH **********************************/
+
+/* Continue 64-bit FNV-1a hash 'hash' with 'size' bytes of 'p_data'.
+ * Start with 'UTIL_HASH_INIT', then call the function for each piece of data.
+ *
+ * For example:
+ *   hash = util_hash(UTIL_HASH_INIT, p_str1, strlen(p_str1));
+ *   hash = util_hash(hash, p_str2, strlen(p_str2)); */
+uint64_t util_hash(uint64_t hash, const void * p_data, size_t size);
+
 #endif /* _UTIL_H_ */
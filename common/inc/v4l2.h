@@ -30,6 +30,7 @@
  *   v4l2_enqueue_buf
  *   v4l2_enqueue_bufs
  *   v4l2_dequeue_buf
+ *   v4l2_is_buf_ready
  *
  *   v4l2_enable_capturing
  *   v4l2_disable_capturing
@@ -159,6 +160,10 @@ bool v4l2_enqueue_bufs(int dev_fd, uint32_t count);
  * successful */
 bool v4l2_dequeue_buf(int dev_fd, struct v4l2_buffer * p_buf);
 
+/* Check if a filled buffer can be dequeued from V4L2 device without
+ * blocking. Return true if so. Otherwise, return false */
+bool v4l2_is_buf_ready(int dev_fd);
+
 /* Enable capturing process on V4L2 device.
  * Return true if successful. Otherwise, return false */
 bool v4l2_enable_capturing(int dev_fd);
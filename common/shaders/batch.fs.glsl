@@ -0,0 +1,152 @@
+/* Copyright (c) 2023 Renesas Electronics Corp.
+ * SPDX-License-Identifier: MIT-0 */
+
+precision highp float;
+
+/* Vertices of polygons (relative to center of polygon, in pixels) */
+uniform highp sampler2D polyVerts;
+
+/* Image atlas (premultiplied alpha) */
+uniform sampler2D imageAtlas;
+
+in vec2 localPos;
+flat in vec2 halfSize;
+flat in vec4 shapeColor;
+flat in vec4 shapeParams;
+flat in ivec2 shapeVerts;
+flat in vec4 shapeUV;
+
+/* Must match 'BATCH_KIND_*' and 'BATCH_VERTS_TEX_WIDTH' in 'batch.h' */
+#define KIND_BOX     0.0
+#define KIND_POLYGON 1.0
+#define KIND_IMAGE   2.0
+#define VERTS_WIDTH  256
+
+/* Signed distances (in pixels, negative inside) are based on:
+ * https://iquilezles.org/articles/distfunctions2d */
+
+/* Signed distance from 'p' to the edge of a box with rounded corners */
+float boxDistance(vec2 p, vec2 b, float r)
+{
+    vec2 d = abs(p) - b + r;
+    return length(max(d, 0.0)) + min(max(d.x, d.y), 0.0) - r;
+}
+
+/* Get vertex 'index' of polygons */
+vec2 getVertex(int index)
+{
+    return texelFetch(polyVerts, ivec2(index % VERTS_WIDTH,
+                                       index / VERTS_WIDTH), 0).xy;
+}
+
+/* Signed distance from 'p' to the edge of polygon */
+float polygonDistance(vec2 p, int first, int count)
+{
+    vec2 v0 = getVertex(first);
+
+    float d = dot(p - v0, p - v0);
+    float s = 1.0;
+
+    for (int i = 0, j = count - 1; i < count; j = i, i++)
+    {
+        vec2 vi = getVertex(first + i);
+        vec2 vj = getVertex(first + j);
+
+        /* Distance to edge (vi, vj) */
+        vec2 e = vj - vi;
+        vec2 w = p - vi;
+        vec2 b = w - (e * clamp(dot(w, e) / dot(e, e), 0.0, 1.0));
+
+        d = min(d, dot(b, b));
+
+        /* Winding number: flip sign when edge crosses horizontal ray */
+        bvec3 c = bvec3(p.y >= vi.y, p.y < vj.y, (e.x * w.y) > (e.y * w.x));
+
+        if (all(c) || all(not(c)))
+        {
+            s = -s;
+        }
+    }
+
+    return s * sqrt(d);
+}
+
+float shapeDistance(void)
+{
+    float dist = 0.0;
+    float outlineWidth = shapeParams.y;
+
+    if (shapeParams.w == KIND_POLYGON)
+    {
+        dist = polygonDistance(localPos, shapeVerts.x, shapeVerts.y);
+    }
+    else
+    {
+        dist = boxDistance(localPos, halfSize, shapeParams.z);
+    }
+
+    /* Keep only a band of 'outlineWidth' pixels inside the edge */
+    if (outlineWidth > 0.0)
+    {
+        dist = abs(dist + (outlineWidth * 0.5)) - (outlineWidth * 0.5);
+    }
+
+    return dist;
+}
+
+/* Sample image atlas at the current pixel.
+ * Note: The top of image has smaller texture coordinate than its bottom */
+vec4 imageColor(void)
+{
+    vec2 pos = clamp((localPos / halfSize) * 0.5 + 0.5, 0.0, 1.0);
+
+    return texture(imageAtlas, vec2(mix(shapeUV.x, shapeUV.z, pos.x),
+                                    mix(shapeUV.w, shapeUV.y, pos.y)));
+}
+
+void main(void)
+{
+#ifdef YUV_OUTPUT
+    /* Blending is not guaranteed on YUV framebuffers.
+     * So, pixels outside the shape and transparent pixels are skipped */
+    if (shapeParams.w == KIND_IMAGE)
+    {
+        vec4 color = imageColor() * shapeColor.a;
+
+        if (color.a < 0.5)
+        {
+            discard;
+        }
+
+        /* Undo premultiplied alpha and convert from RGB format to YUV */
+        FragColor = vec4(rgbToYuv(color.rgb / color.a), 1.0);
+    }
+    else
+    {
+        if ((shapeDistance() > 0.0) || (shapeColor.a < 0.5))
+        {
+            discard;
+        }
+
+        FragColor = vec4(rgbToYuv(shapeColor.rgb), 1.0);
+    }
+#else
+    /* Output premultiplied alpha */
+    if (shapeParams.w == KIND_IMAGE)
+    {
+        /* Antialias edges over 1 pixel (the quad is extended by 1 pixel) */
+        vec2 d = abs(localPos) - halfSize;
+        float coverage = clamp(0.5 - max(d.x, d.y), 0.0, 1.0);
+
+        FragColor = imageColor() * (shapeColor.a * coverage);
+    }
+    else
+    {
+        /* Antialias edges over 1 pixel */
+        float coverage = clamp(0.5 - shapeDistance(), 0.0, 1.0);
+        float alpha = shapeColor.a * coverage;
+
+        FragColor = vec4(shapeColor.rgb * alpha, alpha);
+    }
+#endif
+}
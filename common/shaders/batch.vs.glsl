@@ -0,0 +1,41 @@
+/* Copyright (c) 2023 Renesas Electronics Corp.
+ * SPDX-License-Identifier: MIT-0 */
+
+layout (location = 0) in vec2 aCorner;   /* Corner of unit quad              */
+layout (location = 1) in vec4 iRect;     /* <vec2 center, vec2 half>         */
+layout (location = 2) in vec4 iColor;    /* <vec3 color, opacity>            */
+layout (location = 3) in vec4 iParams;   /* <rotation, outline, radius, kind> */
+layout (location = 4) in vec2 iVerts;    /* <first vertex, vertex count>     */
+layout (location = 5) in vec4 iUV;       /* <left, top, right, bottom>       */
+
+uniform mat4 projection;
+
+out vec2 localPos;
+flat out vec2 halfSize;
+flat out vec4 shapeColor;
+flat out vec4 shapeParams;
+flat out ivec2 shapeVerts;
+flat out vec4 shapeUV;
+
+void main(void)
+{
+    /* Extend the quad by 1 pixel, so antialiased edges are not cut off */
+    vec2 local = aCorner * (iRect.zw + 1.0);
+
+    /* Rotate around the center of the shape */
+    float c = cos(iParams.x);
+    float s = sin(iParams.x);
+
+    vec2 pos = iRect.xy + vec2((c * local.x) - (s * local.y),
+                               (s * local.x) + (c * local.y));
+
+    gl_Position = projection * vec4(pos, 0.0, 1.0);
+
+    /* Pass shape's data (in pixels) to fragment shader */
+    localPos    = local;
+    halfSize    = iRect.zw;
+    shapeColor  = iColor;
+    shapeParams = iParams;
+    shapeVerts  = ivec2(iVerts);
+    shapeUV     = iUV;
+}
@@ -0,0 +1,31 @@
+/* Copyright (c) 2023 Renesas Electronics Corp.
+ * SPDX-License-Identifier: MIT-0 */
+
+/* Frame to be blurred (such as low resolution frame of privacy masks) */
+uniform sampler2D maskTexture;
+
+/* Distance between 2 texels along the direction of blur, in texture
+ * coordinates. (1 / width, 0) blurs horizontally, (0, 1 / height) vertically */
+uniform vec2 blurStep;
+
+in vec2 texCoord;
+
+/* 9-tap Gaussian filter. Pairs of taps are merged into 1 sample between
+ * them, so linear filtering does half of the work */
+const float OFFSETS[3] = float[3](0.0, 1.3846153846, 3.2307692308);
+const float WEIGHTS[3] = float[3](0.2270270270, 0.3162162162, 0.0702702703);
+
+void main(void)
+{
+    vec3 color = texture(maskTexture, texCoord).rgb * WEIGHTS[0];
+
+    for (int i = 1; i < 3; i++)
+    {
+        color += texture(maskTexture, texCoord + (blurStep * OFFSETS[i])).rgb *
+                 WEIGHTS[i];
+        color += texture(maskTexture, texCoord - (blurStep * OFFSETS[i])).rgb *
+                 WEIGHTS[i];
+    }
+
+    FragColor = vec4(color, 1.0);
+}
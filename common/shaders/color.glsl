@@ -0,0 +1,77 @@
+/* Copyright (c) 2023 Renesas Electronics Corp.
+ * SPDX-License-Identifier: MIT-0 */
+
+/* Color conversion between RGB and YUV, shared by all fragment shaders.
+ *
+ * Standard: BT.601 (default) or BT.709 if 'BT709' is defined.
+ * Range:    Full (default) or limited (16-235) if 'LIMITED_RANGE' is defined.
+ *
+ * Note: Fragment shaders write YUV to NV12 buffers if 'YUV_OUTPUT' is defined.
+ *       Otherwise, they write RGBA */
+
+#ifdef BT709
+const float KR = 0.2126;
+const float KB = 0.0722;
+#else
+const float KR = 0.299;
+const float KB = 0.114;
+#endif
+
+const float KG = 1.0 - KR - KB;
+
+/* Offset of U and V */
+const float CHROMA_OFFSET = 128.0 / 255.0;
+
+vec3 rgbToYuv(vec3 rgb)
+{
+    float y = dot(rgb, vec3(KR, KG, KB));
+    vec2 uv = vec2((rgb.b - y) / (2.0 * (1.0 - KB)),
+                   (rgb.r - y) / (2.0 * (1.0 - KR)));
+
+#ifdef LIMITED_RANGE
+    y  = (16.0 + (219.0 * y)) / 255.0;
+    uv = uv * (224.0 / 255.0);
+#endif
+
+    return vec3(y, uv + CHROMA_OFFSET);
+}
+
+vec3 yuvToRgb(vec3 yuv)
+{
+    float y = yuv.x;
+    vec2 uv = yuv.yz - CHROMA_OFFSET;
+
+#ifdef LIMITED_RANGE
+    y  = ((y * 255.0) - 16.0) / 219.0;
+    uv = uv * (255.0 / 224.0);
+#endif
+
+    float r = y + (2.0 * (1.0 - KR) * uv.y);
+    float b = y + (2.0 * (1.0 - KB) * uv.x);
+    float g = (y - (KR * r) - (KB * b)) / KG;
+
+    return clamp(vec3(r, g, b), 0.0, 1.0);
+}
+
+/* Return true if 'coord' is outside of [0, 1] (such as in letterbox bars) */
+bool isOutside(vec2 coord)
+{
+    return any(lessThan(coord, vec2(0.0))) ||
+           any(greaterThan(coord, vec2(1.0)));
+}
+
+/* Return black in the output format */
+vec4 black(void)
+{
+#ifdef YUV_OUTPUT
+    return vec4(rgbToYuv(vec3(0.0)), 1.0);
+#else
+    return vec4(0.0, 0.0, 0.0, 1.0);
+#endif
+}
+
+#ifdef YUV_OUTPUT
+layout (yuv) out vec4 FragColor;
+#else
+out vec4 FragColor;
+#endif
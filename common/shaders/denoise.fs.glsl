@@ -0,0 +1,48 @@
+/* Copyright (c) 2023 Renesas Electronics Corp.
+ * SPDX-License-Identifier: MIT-0 */
+
+#ifdef RGB_INPUT
+/* Without 'GL_EXT_YUV_target', the driver converts YUYV to RGB */
+uniform samplerExternalOES yuyvTexture;
+#else
+uniform __samplerExternal2DY2YEXT yuyvTexture;
+#endif
+
+/* Denoised previous frame (RGBA, same size and orientation as output) */
+uniform sampler2D historyTexture;
+
+/* Max weight of previous frame (0: no denoising) */
+uniform float strength;
+
+/* Difference of luma at which a pixel is treated as moving */
+uniform float motionThreshold;
+
+in vec2 texCoord;
+in vec2 areaCoord;
+in vec2 canvasCoord;
+
+void main(void)
+{
+    /* Fill letterbox bars */
+    if (isOutside(areaCoord))
+    {
+        FragColor = black();
+        return;
+    }
+
+#ifdef RGB_INPUT
+    vec3 curColor = texture(yuyvTexture, texCoord).rgb;
+#else
+    vec3 curColor = yuvToRgb(vec3(texture(yuyvTexture, texCoord)));
+#endif
+
+    vec3 prevColor = texture(historyTexture, canvasCoord).rgb;
+
+    /* Noise is a small difference, so static pixels are averaged over
+     * frames. Moving pixels keep the current frame (no ghosting) */
+    float diff = abs(dot(curColor - prevColor, vec3(KR, KG, KB)));
+    float weight = strength * (1.0 - smoothstep(0.5 * motionThreshold,
+                                                motionThreshold, diff));
+
+    FragColor = vec4(mix(curColor, prevColor, weight), 1.0);
+}
@@ -0,0 +1,26 @@
+/* Copyright (c) 2023 Renesas Electronics Corp.
+ * SPDX-License-Identifier: MIT-0 */
+
+/* Low resolution frame (pixelated or blurred) */
+uniform sampler2D maskTexture;
+
+/* True if coverage of regions is drawn instead of their content */
+uniform bool coverage;
+
+in vec2 texCoord;
+
+void main(void)
+{
+    vec3 color = texture(maskTexture, texCoord).rgb;
+
+    if (coverage)
+    {
+        color = vec3(1.0);
+    }
+
+#ifdef YUV_OUTPUT
+    FragColor = vec4(rgbToYuv(color), 1.0);
+#else
+    FragColor = vec4(color, 1.0);
+#endif
+}
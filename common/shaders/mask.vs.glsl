@@ -0,0 +1,20 @@
+/* Copyright (c) 2023 Renesas Electronics Corp.
+ * SPDX-License-Identifier: MIT-0 */
+
+layout (location = 0) in vec2 aPos; /* Vertex of region (in pixels) */
+
+uniform mat4 projection;
+
+/* Size of output (in pixels) */
+uniform vec2 frameSize;
+
+out vec2 texCoord;
+
+void main(void)
+{
+    gl_Position = projection * vec4(aPos, 0.0, 1.0);
+
+    /* Low resolution frame covers the entire output, but its first row is
+     * the top of the image */
+    texCoord = vec2(aPos.x / frameSize.x, 1.0 - (aPos.y / frameSize.y));
+}
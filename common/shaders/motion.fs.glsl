@@ -0,0 +1,60 @@
+/* Copyright (c) 2023 Renesas Electronics Corp.
+ * SPDX-License-Identifier: MIT-0 */
+
+#ifdef RGB_INPUT
+/* Without 'GL_EXT_YUV_target', the driver converts YUYV to RGB */
+uniform samplerExternalOES yuyvTexture;
+#else
+uniform __samplerExternal2DY2YEXT yuyvTexture;
+#endif
+
+/* Previous luma frame (R: luma, same size as output) */
+uniform sampler2D historyTexture;
+
+/* True if there is no previous frame yet */
+uniform bool firstFrame;
+
+in vec2 texCoord;
+in vec2 areaCoord;
+in vec2 canvasCoord;
+
+/* Return luma of camera at 'coord' */
+float getLuma(vec2 coord)
+{
+#ifdef RGB_INPUT
+    return dot(texture(yuyvTexture, coord).rgb, vec3(KR, KG, KB));
+#else
+    return texture(yuyvTexture, coord).r;
+#endif
+}
+
+void main(void)
+{
+    /* A pixel covers a lot of camera pixels. So, 4x4 samples spread over
+     * its footprint are averaged, which also suppresses sensor noise */
+    vec2 stepX = dFdx(texCoord) / 4.0;
+    vec2 stepY = dFdy(texCoord) / 4.0;
+
+    float luma = 0.0;
+
+    /* Letterbox bars never change */
+    if (!isOutside(areaCoord))
+    {
+        for (int y = 0; y < 4; y++)
+        {
+            for (int x = 0; x < 4; x++)
+            {
+                luma += getLuma(texCoord +
+                                (stepX * (float(x) - 1.5)) +
+                                (stepY * (float(y) - 1.5)));
+            }
+        }
+
+        luma /= 16.0;
+    }
+
+    float prevLuma = firstFrame ? luma :
+                                  texture(historyTexture, canvasCoord).r;
+
+    FragColor = vec4(luma, abs(luma - prevLuma), 0.0, 1.0);
+}
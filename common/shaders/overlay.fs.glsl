@@ -0,0 +1,21 @@
+/* Copyright (c) 2023 Renesas Electronics Corp.
+ * SPDX-License-Identifier: MIT-0 */
+
+/* RGBA texture of overlay (premultiplied alpha) */
+uniform sampler2D overlayTexture;
+
+in vec2 texCoord;
+in vec2 areaCoord;
+
+void main(void)
+{
+    /* Nothing is blended onto letterbox bars */
+    if (isOutside(areaCoord))
+    {
+        FragColor = vec4(0.0);
+        return;
+    }
+
+    /* Blending is done by 'glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA)' */
+    FragColor = texture(overlayTexture, texCoord);
+}
@@ -1,14 +1,13 @@
-#version 300 es
-
 /* Copyright (c) 2023 Renesas Electronics Corp.
  * SPDX-License-Identifier: MIT-0 */
 
-precision mediump float;
-
 in vec3 ourColor;
-out vec4 FragColor;
 
 void main(void)
 {
+#ifdef YUV_OUTPUT
+    FragColor = vec4(rgbToYuv(ourColor), 1.0);
+#else
     FragColor = vec4(ourColor, 1.0);
+#endif
 }
@@ -1,5 +1,3 @@
-#version 300 es
-
 /* Copyright (c) 2023 Renesas Electronics Corp.
  * SPDX-License-Identifier: MIT-0 */
 
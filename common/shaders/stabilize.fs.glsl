@@ -0,0 +1,48 @@
+/* Copyright (c) 2023 Renesas Electronics Corp.
+ * SPDX-License-Identifier: MIT-0 */
+
+/* Luma frames (R: luma) of the current and previous camera frame.
+ * Their first row is the top of the image */
+uniform sampler2D currentTexture;
+uniform sampler2D previousTexture;
+
+/* Max shift (in pixels of luma frame) which is searched. The output is
+ * (2 * searchRadius + 1) pixels wide and high */
+uniform int searchRadius;
+
+/* Distance (in pixels of luma frame) between sampled pixels */
+const int SAMPLE_STEP = 4;
+
+void main(void)
+{
+    /* Each output pixel is a candidate shift of the content since the
+     * previous frame. Pixel (searchRadius, searchRadius) is no shift */
+    ivec2 shift = ivec2(gl_FragCoord.xy) - ivec2(searchRadius);
+    ivec2 size  = textureSize(currentTexture, 0);
+
+    /* Mean absolute difference between the current frame and the shifted
+     * previous frame. The margin keeps all samples inside both frames.
+     * Note: The sum of hundreds of samples needs more than 'mediump' */
+    highp float sum   = 0.0;
+    highp float count = 0.0;
+
+    for (int y = searchRadius; y < size.y - searchRadius; y += SAMPLE_STEP)
+    {
+        for (int x = searchRadius; x < size.x - searchRadius; x += SAMPLE_STEP)
+        {
+            ivec2 pos = ivec2(x, y);
+
+            sum += abs(texelFetch(currentTexture, pos, 0).r -
+                       texelFetch(previousTexture, pos - shift, 0).r);
+            count += 1.0;
+        }
+    }
+
+    highp float cost = sum / count;
+
+    /* Pack cost (0 to 1) into 2 channels, so it keeps 16 bits when it's
+     * read back as RGBA8 */
+    highp float scaled = cost * 255.0;
+
+    FragColor = vec4(floor(scaled) / 255.0, fract(scaled), 0.0, 1.0);
+}
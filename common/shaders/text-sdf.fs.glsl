@@ -0,0 +1,67 @@
+/* Copyright (c) 2023 Renesas Electronics Corp.
+ * SPDX-License-Identifier: MIT-0 */
+
+/* Signed distance field atlas (0.5 is the edge of glyphs) */
+uniform sampler2D text;
+uniform vec3 textColor;
+
+/* Outline around glyphs (width is in units of the field) */
+uniform vec3 outlineColor;
+uniform float outlineWidth;
+
+/* Drop shadow (offset is in texture coordinates).
+ * Note: With 'YUV_OUTPUT', shadow is opaque unless 'shadowOpacity' is 0 */
+uniform vec3 shadowColor;
+uniform float shadowOpacity;
+uniform vec2 shadowOffset;
+
+in vec2 texCoords;
+
+void main(void)
+{
+    float dist = texture(text, texCoords).r;
+    float shadowDist = texture(text, texCoords - shadowOffset).r;
+
+    float edge = 0.5 - outlineWidth;
+
+#ifdef YUV_OUTPUT
+    vec3 color;
+
+    /* Blending is not guaranteed on YUV framebuffers.
+     * So, each pixel takes the color of the topmost layer covering it */
+    if (dist >= 0.5)
+    {
+        color = textColor;
+    }
+    else if (dist >= edge)
+    {
+        color = outlineColor;
+    }
+    else if ((shadowOpacity > 0.0) && (shadowDist >= edge))
+    {
+        color = shadowColor;
+    }
+    else
+    {
+        discard;
+    }
+
+    FragColor = vec4(rgbToYuv(color), 1.0);
+#else
+    /* Antialias edges over about 1 pixel on screen */
+    float aa = 0.7 * fwidth(dist);
+
+    /* Coverage of glyph, glyph plus outline, and shadow */
+    float fill = smoothstep(0.5 - aa, 0.5 + aa, dist);
+    float body = smoothstep(edge - aa, edge + aa, dist);
+    float shadow = shadowOpacity * smoothstep(edge - aa, edge + aa, shadowDist);
+
+    /* Composite glyph over outline, then both over shadow */
+    vec3 bodyColor = mix(outlineColor, textColor, fill / max(body, 0.0001));
+    float alpha = body + (shadow * (1.0 - body));
+
+    vec3 color = (bodyColor * body) + (shadowColor * shadow * (1.0 - body));
+
+    FragColor = vec4(color / max(alpha, 0.0001), alpha);
+#endif
+}
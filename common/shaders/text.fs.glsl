@@ -1,18 +1,24 @@
-#version 300 es
-
 /* Copyright (c) 2023 Renesas Electronics Corp.
  * SPDX-License-Identifier: MIT-0 */
 
-precision mediump float;
-
 uniform sampler2D text;
 uniform vec3 textColor;
 
 in vec2 texCoords;
-out vec4 FragColor;
 
 void main(void)
 {
+#ifdef YUV_OUTPUT
+    /* Blending is not guaranteed on YUV framebuffers.
+     * So, pixels which are less than half covered by the glyph are skipped */
+    if (texture(text, texCoords).r < 0.5)
+    {
+        discard;
+    }
+
+    FragColor = vec4(rgbToYuv(textColor), 1.0);
+#else
     vec4 sampled = vec4(1.0, 1.0, 1.0, texture(text, texCoords).r);
     FragColor = vec4(textColor, 1.0) * sampled;
+#endif
 }
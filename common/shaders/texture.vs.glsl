@@ -0,0 +1,57 @@
+/* Copyright (c) 2023 Renesas Electronics Corp.
+ * SPDX-License-Identifier: MIT-0 */
+
+layout (location = 0) in vec4 aVertex; /* <vec2 pos, vec2 tex> */
+
+/* Area of destination and region of texture (crop and scaling), both as
+ * <vec2 offset, vec2 size> in texture coordinates.
+ * (0, 0, 1, 1) means the entire texture fills the entire viewport */
+uniform vec4 dstArea;
+uniform vec4 srcRegion;
+
+/* Rotation and mirroring of region. It maps a position inside destination
+ * area to a position inside region (both in [0, 1]) */
+uniform mat3 orientation;
+
+/* True if 'aVertex.zw' are final texture coordinates (such as a lens
+ * correction mesh). Then, the uniforms above only place letterbox bars */
+uniform bool warped;
+
+out vec2 texCoord;
+
+/* Position inside destination area. It's outside [0, 1] in letterbox bars */
+out vec2 areaCoord;
+
+/* Position on the entire destination, regardless of scaling and rotation */
+out vec2 canvasCoord;
+
+void main(void)
+{
+    vec2 coord;
+
+    /* Just convert a 2D coordinate to 3D coordinate */
+    gl_Position = vec4(aVertex.xy, 0.0, 1.0);
+
+    /* Position on the destination, in texture coordinates of the output
+     * image. 'FLIP_Y' is for textures whose first row is the top of the
+     * image (camera frames, NV12 buffers) drawn on OpenGL ES framebuffers */
+    coord = (aVertex.xy + 1.0) / 2.0;
+
+#ifdef FLIP_Y
+    coord.y = 1.0 - coord.y;
+#endif
+
+    /* Pass texture coordinate of the region to fragment shader */
+    canvasCoord = coord;
+    areaCoord   = (coord - dstArea.xy) / dstArea.zw;
+
+    if (warped)
+    {
+        texCoord = aVertex.zw;
+    }
+    else
+    {
+        texCoord = srcRegion.xy +
+                   ((orientation * vec3(areaCoord, 1.0)).xy * srcRegion.zw);
+    }
+}
@@ -0,0 +1,30 @@
+/* Copyright (c) 2023 Renesas Electronics Corp.
+ * SPDX-License-Identifier: MIT-0 */
+
+#ifdef RGB_INPUT
+/* YUYV or NV12 texture (converted to RGB by the driver) */
+uniform samplerExternalOES yuvTexture;
+#else
+/* YUYV or NV12 texture (sampled without conversion) */
+uniform __samplerExternal2DY2YEXT yuvTexture;
+#endif
+
+in vec2 texCoord;
+in vec2 areaCoord;
+
+void main(void)
+{
+    /* Fill letterbox bars */
+    if (isOutside(areaCoord))
+    {
+        FragColor = black();
+        return;
+    }
+
+#ifdef RGB_INPUT
+    FragColor = vec4(texture(yuvTexture, texCoord).rgb, 1.0);
+#else
+    /* Convert color of texture from YUV to RGB format */
+    FragColor = vec4(yuvToRgb(vec3(texture(yuvTexture, texCoord))), 1.0);
+#endif
+}
@@ -0,0 +1,101 @@
+/* Copyright (c) 2023 Renesas Electronics Corp.
+ * SPDX-License-Identifier: MIT-0 */
+
+#if defined(RGBA_INPUT)
+/* Camera frame which is already converted (such as denoised, see
+ * 'denoise.fs.glsl'). It has the same size and orientation as output */
+uniform sampler2D yuyvTexture;
+#elif defined(RGB_INPUT)
+/* Without 'GL_EXT_YUV_target', the driver converts YUYV to RGB */
+uniform samplerExternalOES yuyvTexture;
+#else
+uniform __samplerExternal2DY2YEXT yuyvTexture;
+#endif
+
+#ifdef OVERLAY
+/* RGBA texture of overlay (premultiplied alpha) */
+uniform sampler2D overlayTexture;
+#endif
+
+#ifdef MASK
+/* Low resolution frame of privacy masks (pixelated or blurred) and coverage
+ * of their regions (see 'mask.h') */
+uniform sampler2D maskTexture;
+uniform sampler2D coverTexture;
+#endif
+
+in vec2 texCoord;
+in vec2 areaCoord;
+in vec2 canvasCoord;
+
+/* Return color of camera in RGB format */
+vec3 getCamColor(void)
+{
+#if defined(RGB_INPUT) || defined(RGBA_INPUT)
+    return texture(yuyvTexture, texCoord).rgb;
+#else
+    return yuvToRgb(vec3(texture(yuyvTexture, texCoord)));
+#endif
+}
+
+/* Write 'yuv' to NV12 framebuffer, or to one of its planes.
+ * The UV plane has half the size, so a fragment covers 2x2 pixels */
+void writeYuv(vec3 yuv)
+{
+#if defined(LUMA_OUTPUT)
+    FragColor = vec4(yuv.x, 0.0, 0.0, 1.0);
+#elif defined(CHROMA_OUTPUT)
+    FragColor = vec4(yuv.yz, 0.0, 1.0);
+#else
+    FragColor = vec4(yuv, 1.0);
+#endif
+}
+
+void main(void)
+{
+#ifdef OVERLAY
+    /* Overlay covers the entire NV12 frame (including letterbox bars), so it
+     * keeps its orientation when the camera frame is rotated or mirrored.
+     * NV12 buffers start with the top row of the image. The overlay was
+     * rendered by OpenGL ES (bottom row first), so it must be flipped */
+    vec2 overlayCoord = vec2(canvasCoord.x, 1.0 - canvasCoord.y);
+
+    /* Color of camera in RGB format (black in the bars) */
+    vec3 camColor = vec3(0.0);
+
+    if (!isOutside(areaCoord))
+    {
+        camColor = getCamColor();
+
+#ifdef MASK
+        /* Replace regions of privacy masks. The low resolution frame starts
+         * with the top row like NV12 buffers, but coverage is drawn like
+         * overlay */
+        camColor = mix(camColor, texture(maskTexture, canvasCoord).rgb,
+                       texture(coverTexture, overlayCoord).r);
+#endif
+    }
+
+    /* Blend overlay onto camera */
+    vec4 overlayColor = texture(overlayTexture, overlayCoord);
+    vec3 color = overlayColor.rgb + (camColor * (1.0 - overlayColor.a));
+
+    /* Convert the result from RGB format to YUV */
+    writeYuv(rgbToYuv(color));
+#else
+    /* Fill letterbox bars */
+    if (isOutside(areaCoord))
+    {
+        writeYuv(rgbToYuv(vec3(0.0)));
+        return;
+    }
+
+#if defined(RGB_INPUT) || defined(RGBA_INPUT)
+    writeYuv(rgbToYuv(getCamColor()));
+#else
+    /* Both YUYV and NV12 buffers start with the top row of the image and
+     * use the same color space. So, YUV values are copied as is */
+    writeYuv(vec3(texture(yuyvTexture, texCoord)));
+#endif
+#endif
+}
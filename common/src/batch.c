@@ -0,0 +1,488 @@
+/* Copyright (c) 2023 Renesas Electronics Corp.
+ * SPDX-License-Identifier: MIT-0 */
+
+/*******************************************************************************
+ * FILENAME: batch.c
+ *
+ * DESCRIPTION:
+ *   Shape batch function definition.
+ * 
+ * NOTE:
+ *   For function usage, please refer to 'batch.h'.
+ * 
+ * AUTHOR: RVC       START DATE: 15/03/2023
+ *
+ ******************************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "batch.h"
+
+/******************************************************************************
+ *                              FUNCTION MACROS                               *
+ ******************************************************************************/
+
+/* Pointer (offset in buffer) of member 'MEMBER' of the first instance which
+ * starts at 'OFFSET' */
+#define INST_ATTRIB(OFFSET, MEMBER) \
+    ((void *)(intptr_t)((OFFSET) + offsetof(batch_inst_t, MEMBER)))
+
+/******************************************************************************
+ *                        STATIC FUNCTION DECLARATION                         *
+ ******************************************************************************/
+
+static bool add_instance(batch_t * p_batch, float center_x, float center_y,
+                         float half_width, float half_height, float rotation,
+                         float radius, float kind, color_t color,
+                         float opacity, float outline_width);
+
+/******************************************************************************
+ *                            FUNCTION DEFINITION                             *
+ ******************************************************************************/
+
+batch_t batch_create(uint32_t max_count, uint32_t max_vert_count)
+{
+    batch_t batch = { 0 };
+
+    /* The number of rows of texture which contains vertices of polygons */
+    uint32_t rows = 0;
+
+    GLuint index = 0;
+
+    /* Corners of unit quad (drawn as triangle strip) */
+    GLfloat quad_verts[] =
+    {
+        -1.0f, -1.0f, /* Bottom-left  */
+         1.0f, -1.0f, /* Bottom-right */
+        -1.0f,  1.0f, /* Top-left     */
+         1.0f,  1.0f, /* Top-right    */
+    };
+
+    /* Check parameter */
+    assert(max_count > 0);
+
+    batch.p_insts = (batch_inst_t *)malloc(max_count * sizeof(batch_inst_t));
+    if (batch.p_insts == NULL)
+    {
+        printf("Error: Failed to allocate %u instances\n", max_count);
+        return batch;
+    }
+
+    batch.max_count = max_count;
+
+    /* The vertex array object keeps attribute divisors away from
+     * other drawing functions which use the default vertex array */
+    glGenVertexArrays(1, &(batch.vao));
+    glBindVertexArray(batch.vao);
+
+    /* Attribute 0: Corner of unit quad */
+    glGenBuffers(1, &(batch.vbo_quad_verts));
+    glBindBuffer(GL_ARRAY_BUFFER, batch.vbo_quad_verts);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(quad_verts),
+                 quad_verts, GL_STATIC_DRAW);
+
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE,
+                          2 * sizeof(GLfloat), (void *)0);
+
+    /* Attributes 1, 2, 3, 4, 5: Bounding box, color, parameters, vertices,
+     * and texture coordinates of instance.
+     * Note: Instances are in the streaming vertex buffer. So, their
+     *       pointers are set by 'batch_flush' */
+    for (index = 1; index <= 5; index++)
+    {
+        glEnableVertexAttribArray(index);
+        glVertexAttribDivisor(index, 1);
+    }
+
+    /* Unbind vertex array and buffer */
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    if (max_vert_count > 0)
+    {
+        /* Round up to whole rows, so that rows can be uploaded as is */
+        rows = (max_vert_count + BATCH_VERTS_TEX_WIDTH - 1) /
+               BATCH_VERTS_TEX_WIDTH;
+
+        /* Vertices of the batch, then the copy of uploaded vertices */
+        batch.max_vert_count = rows * BATCH_VERTS_TEX_WIDTH;
+        batch.p_verts = (float *)calloc(batch.max_vert_count,
+                                        4 * sizeof(float));
+        if (batch.p_verts == NULL)
+        {
+            printf("Error: Failed to allocate %u vertices of polygons\n",
+                   batch.max_vert_count);
+
+            /* 'p_insts' becomes NULL */
+            batch_delete(&batch);
+            return batch;
+        }
+
+        batch.p_tex_verts = batch.p_verts + (2 * batch.max_vert_count);
+
+        /* Create texture for vertices of polygons.
+         * Float textures cannot be filtered, so 'GL_NEAREST' is required */
+        glGenTextures(1, &(batch.tex_verts));
+        glBindTexture(GL_TEXTURE_2D, batch.tex_verts);
+
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RG32F, BATCH_VERTS_TEX_WIDTH,
+                     rows, 0, GL_RG, GL_FLOAT, NULL);
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+        /* Unbind texture */
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    return batch;
+}
+
+void batch_delete(batch_t * p_batch)
+{
+    /* Check parameter */
+    assert(p_batch != NULL);
+
+    glDeleteVertexArrays(1, &(p_batch->vao));
+    glDeleteBuffers(1, &(p_batch->vbo_quad_verts));
+
+    if (p_batch->tex_verts != 0)
+    {
+        glDeleteTextures(1, &(p_batch->tex_verts));
+    }
+
+    free(p_batch->p_insts);
+    free(p_batch->p_verts);
+
+    p_batch->p_insts   = NULL;
+    p_batch->count     = 0;
+    p_batch->max_count = 0;
+
+    p_batch->p_verts        = NULL;
+    p_batch->vert_count     = 0;
+    p_batch->max_vert_count = 0;
+
+    p_batch->p_tex_verts    = NULL;
+    p_batch->tex_vert_count = 0;
+}
+
+bool batch_add_rect(batch_t * p_batch, float x, float y,
+                    float width, float height, float angle,
+                    color_t color, float opacity, float outline_width)
+{
+    return batch_add_rounded_rect(p_batch, x, y, width, height, angle,
+                                  0.0f, color, opacity, outline_width);
+}
+
+bool batch_add_rounded_rect(batch_t * p_batch, float x, float y,
+                            float width, float height, float angle,
+                            float radius, color_t color, float opacity,
+                            float outline_width)
+{
+    return add_instance(p_batch, x + (width / 2.0f), y + (height / 2.0f),
+                        width / 2.0f, height / 2.0f, glm_rad(angle),
+                        radius, BATCH_KIND_BOX, color, opacity,
+                        outline_width);
+}
+
+bool batch_add_circle(batch_t * p_batch, float x, float y, float radius,
+                      color_t color, float opacity, float outline_width)
+{
+    /* A circle is a square whose corners are rounded by half of its size */
+    return add_instance(p_batch, x, y, radius, radius, 0.0f, radius,
+                        BATCH_KIND_BOX, color, opacity, outline_width);
+}
+
+bool batch_add_line(batch_t * p_batch, float x0, float y0,
+                    float x1, float y1, float width,
+                    color_t color, float opacity)
+{
+    float half_len = sqrtf(((x1 - x0) * (x1 - x0)) +
+                           ((y1 - y0) * (y1 - y0))) / 2.0f;
+
+    /* A line is a rectangle along the segment, rounded by half of its width
+     * (so the distance to its edge is the distance to the segment) */
+    return add_instance(p_batch, (x0 + x1) / 2.0f, (y0 + y1) / 2.0f,
+                        half_len + (width / 2.0f), width / 2.0f,
+                        atan2f(y1 - y0, x1 - x0), width / 2.0f,
+                        BATCH_KIND_BOX, color, opacity, 0.0f);
+}
+
+bool batch_add_polyline(batch_t * p_batch, const float * p_points,
+                        uint32_t count, float width,
+                        color_t color, float opacity)
+{
+    uint32_t index = 0;
+
+    /* Check parameters */
+    assert((p_batch != NULL) && (p_points != NULL) && (count >= 2));
+
+    if ((p_batch->count + count - 1) > p_batch->max_count)
+    {
+        return false;
+    }
+
+    for (index = 0; index < (count - 1); index++)
+    {
+        batch_add_line(p_batch, p_points[index * 2], p_points[(index * 2) + 1],
+                       p_points[(index * 2) + 2], p_points[(index * 2) + 3],
+                       width, color, opacity);
+    }
+
+    return true;
+}
+
+bool batch_add_polygon(batch_t * p_batch, const float * p_points,
+                       uint32_t count, color_t color, float opacity,
+                       float outline_width)
+{
+    uint32_t index = 0;
+    uint32_t first = 0;
+
+    float min_x = 0.0f;
+    float min_y = 0.0f;
+    float max_x = 0.0f;
+    float max_y = 0.0f;
+
+    float center_x = 0.0f;
+    float center_y = 0.0f;
+
+    /* Check parameters */
+    assert((p_batch != NULL) && (p_points != NULL) && (count >= 3));
+
+    if (((p_batch->vert_count + count) > p_batch->max_vert_count) ||
+        (p_batch->count >= p_batch->max_count))
+    {
+        return false;
+    }
+
+    /* Get bounding box of polygon */
+    min_x = max_x = p_points[0];
+    min_y = max_y = p_points[1];
+
+    for (index = 1; index < count; index++)
+    {
+        min_x = fminf(min_x, p_points[index * 2]);
+        max_x = fmaxf(max_x, p_points[index * 2]);
+        min_y = fminf(min_y, p_points[(index * 2) + 1]);
+        max_y = fmaxf(max_y, p_points[(index * 2) + 1]);
+    }
+
+    center_x = (min_x + max_x) / 2.0f;
+    center_y = (min_y + max_y) / 2.0f;
+
+    /* Store vertices relative to the center */
+    first = p_batch->vert_count;
+
+    for (index = 0; index < count; index++)
+    {
+        p_batch->p_verts[(first + index) * 2] = p_points[index * 2] - center_x;
+        p_batch->p_verts[((first + index) * 2) + 1] =
+                                        p_points[(index * 2) + 1] - center_y;
+    }
+
+    p_batch->vert_count += count;
+
+    add_instance(p_batch, center_x, center_y,
+                 (max_x - min_x) / 2.0f, (max_y - min_y) / 2.0f, 0.0f,
+                 0.0f, BATCH_KIND_POLYGON, color, opacity, outline_width);
+
+    /* Link the instance to its vertices */
+    p_batch->p_insts[p_batch->count - 1].verts[0] = first;
+    p_batch->p_insts[p_batch->count - 1].verts[1] = count;
+
+    return true;
+}
+
+bool batch_add_image(batch_t * p_batch, const image_atlas_t * p_atlas,
+                     uint32_t index, uint32_t frame, float x, float y,
+                     float width, float height, float angle, float opacity)
+{
+    batch_inst_t * p_inst = NULL;
+
+    /* Check parameters */
+    assert((p_batch != NULL) && (p_atlas != NULL));
+    assert((p_batch->tex_images == 0) || (p_batch->tex_images == p_atlas->tex));
+
+    if (!add_instance(p_batch, x + (width / 2.0f), y + (height / 2.0f),
+                      width / 2.0f, height / 2.0f, glm_rad(angle), 0.0f,
+                      BATCH_KIND_IMAGE, WHITE, opacity, 0.0f))
+    {
+        return false;
+    }
+
+    p_batch->tex_images = p_atlas->tex;
+
+    /* Select the frame by its texture coordinates */
+    p_inst = &(p_batch->p_insts[p_batch->count - 1]);
+    image_get_frame_uv(p_atlas, index, frame, p_inst->uv);
+
+    return true;
+}
+
+void batch_flush(GLuint prog, batch_t * p_batch, gl_res_t res)
+{
+    mat4 projection_mat;
+
+    int32_t offset = -1;
+
+    /* Check parameters */
+    assert((prog != 0) && (p_batch != NULL));
+
+    if (p_batch->count == 0)
+    {
+        return;
+    }
+
+    /* Upload all instances at once */
+    offset = stream_upload(res.p_stream, p_batch->p_insts,
+                           p_batch->count * sizeof(batch_inst_t));
+    if (offset < 0)
+    {
+        p_batch->count = 0;
+        p_batch->vert_count = 0;
+        p_batch->tex_images = 0;
+        return;
+    }
+
+    /* Enable blending.
+     * The fragment shader outputs premultiplied alpha (as in image atlas) */
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+    /* Use program object for drawing shapes */
+    glUseProgram(prog);
+
+    /* Set projection matrix to uniform variable */
+    gl_get_projection_matrix(res, projection_mat);
+
+    glUniformMatrix4fv(glGetUniformLocation(prog, "projection"),
+                       1, GL_FALSE, projection_mat[0]);
+
+    /* Vertices of polygons are in texture unit 0, images in unit 1 */
+    glUniform1i(glGetUniformLocation(prog, "polyVerts"), 0);
+    glUniform1i(glGetUniformLocation(prog, "imageAtlas"), 1);
+
+    /* Bind image atlas */
+    if (p_batch->tex_images != 0)
+    {
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, p_batch->tex_images);
+        glActiveTexture(GL_TEXTURE0);
+    }
+
+    /* Upload rows which contain vertices of polygons, unless the texture
+     * already has them (such as static polygons drawn every frame) */
+    if (p_batch->vert_count > 0)
+    {
+        glBindTexture(GL_TEXTURE_2D, p_batch->tex_verts);
+
+        if ((p_batch->vert_count != p_batch->tex_vert_count) ||
+            (memcmp(p_batch->p_verts, p_batch->p_tex_verts,
+                    p_batch->vert_count * 2 * sizeof(float)) != 0))
+        {
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, BATCH_VERTS_TEX_WIDTH,
+                            (p_batch->vert_count + BATCH_VERTS_TEX_WIDTH - 1) /
+                            BATCH_VERTS_TEX_WIDTH,
+                            GL_RG, GL_FLOAT, p_batch->p_verts);
+
+            memcpy(p_batch->p_tex_verts, p_batch->p_verts,
+                   p_batch->vert_count * 2 * sizeof(float));
+
+            p_batch->tex_vert_count = p_batch->vert_count;
+        }
+    }
+
+    /* Point instance attributes at the uploaded instances.
+     * Note: The stream's buffer is bound by 'stream_upload' */
+    glBindVertexArray(p_batch->vao);
+
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(batch_inst_t),
+                          INST_ATTRIB(offset, rect));
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(batch_inst_t),
+                          INST_ATTRIB(offset, color));
+    glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(batch_inst_t),
+                          INST_ATTRIB(offset, params));
+    glVertexAttribPointer(4, 2, GL_FLOAT, GL_FALSE, sizeof(batch_inst_t),
+                          INST_ATTRIB(offset, verts));
+    glVertexAttribPointer(5, 4, GL_FLOAT, GL_FALSE, sizeof(batch_inst_t),
+                          INST_ATTRIB(offset, uv));
+
+    /* Draw all shapes */
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, p_batch->count);
+
+    /* Unbind vertex array, buffer, and textures */
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    if (p_batch->tex_images != 0)
+    {
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glActiveTexture(GL_TEXTURE0);
+    }
+
+    /* Disable blending */
+    glDisable(GL_BLEND);
+
+    /* Empty the batch */
+    p_batch->count = 0;
+    p_batch->vert_count = 0;
+    p_batch->tex_images = 0;
+}
+
+/******************************************************************************
+ *                         STATIC FUNCTION DEFINITION                         *
+ ******************************************************************************/
+
+static bool add_instance(batch_t * p_batch, float center_x, float center_y,
+                         float half_width, float half_height, float rotation,
+                         float radius, float kind, color_t color,
+                         float opacity, float outline_width)
+{
+    batch_inst_t * p_inst = NULL;
+
+    /* Check parameter */
+    assert(p_batch != NULL);
+
+    if (p_batch->count >= p_batch->max_count)
+    {
+        return false;
+    }
+
+    p_inst = &(p_batch->p_insts[p_batch->count]);
+
+    p_inst->rect[0] = center_x;
+    p_inst->rect[1] = center_y;
+    p_inst->rect[2] = half_width;
+    p_inst->rect[3] = half_height;
+
+    p_inst->color[0] = color[0];
+    p_inst->color[1] = color[1];
+    p_inst->color[2] = color[2];
+    p_inst->color[3] = opacity;
+
+    p_inst->params[0] = rotation;
+    p_inst->params[1] = outline_width;
+    p_inst->params[2] = fminf(radius, fminf(half_width, half_height));
+    p_inst->params[3] = kind;
+
+    p_inst->verts[0] = 0.0f;
+    p_inst->verts[1] = 0.0f;
+
+    p_inst->uv[0] = 0.0f;
+    p_inst->uv[1] = 0.0f;
+    p_inst->uv[2] = 0.0f;
+    p_inst->uv[3] = 0.0f;
+
+    p_batch->count++;
+
+    return true;
+}
@@ -0,0 +1,153 @@
+/* Copyright (c) 2023 Renesas Electronics Corp.
+ * SPDX-License-Identifier: MIT-0 */
+
+/*******************************************************************************
+ * FILENAME: denoise.c
+ *
+ * DESCRIPTION:
+ *   Temporal denoise function definition.
+ * 
+ * NOTE:
+ *   For function usage, please refer to 'denoise.h'.
+ * 
+ * AUTHOR: RVC       START DATE: 15/03/2023
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <assert.h>
+
+#include "denoise.h"
+
+/******************************************************************************
+ *                            FUNCTION DEFINITION                             *
+ ******************************************************************************/
+
+denoise_t denoise_create(uint32_t width, uint32_t height, float strength)
+{
+    denoise_t denoise = { 0 };
+    uint32_t index = 0;
+
+    float max_strength = 0.0f;
+
+    /* Check parameters */
+    assert((width > 0) && (height > 0));
+    assert((strength >= 0.0f) && (strength < 1.0f));
+
+    /* 8-bit history would stop converging up to 10 steps away from static
+     * pixels at strength 0.95. Half float has 3 more bits for bright pixels
+     * and much more for dark ones (low light) */
+    if (gl_is_ext_supported("GL_EXT_color_buffer_half_float") ||
+        gl_is_ext_supported("GL_EXT_color_buffer_float"))
+    {
+        denoise.format = GL_RGBA16F;
+        max_strength   = DENOISE_MAX_STRENGTH_HALF_FLOAT;
+    }
+    else
+    {
+        denoise.format = GL_RGB10_A2;
+        max_strength   = DENOISE_MAX_STRENGTH_10_BIT;
+    }
+
+    if (strength > max_strength)
+    {
+        printf("Warning: Strength of denoise is limited to %.3f\n",
+               max_strength);
+
+        strength = max_strength;
+    }
+
+    denoise.width    = width;
+    denoise.height   = height;
+    denoise.strength = strength;
+
+    /* Create RGBA textures and framebuffers */
+    for (index = 0; index < 2; index++)
+    {
+        denoise.texs[index] = gl_create_color_texture(width, height,
+                                                      denoise.format, NULL);
+        if (denoise.texs[index] == 0)
+        {
+            printf("Error: Failed to create texture of denoise\n");
+            break;
+        }
+
+        denoise.fbs[index] = gl_create_framebuffer(GL_TEXTURE_2D,
+                                                   denoise.texs[index]);
+        if (denoise.fbs[index] == 0)
+        {
+            printf("Error: Failed to create framebuffer of denoise\n");
+            break;
+        }
+    }
+
+    if (index < 2)
+    {
+        denoise_delete(&denoise);
+    }
+
+    return denoise;
+}
+
+void denoise_delete(denoise_t * p_denoise)
+{
+    uint32_t index = 0;
+
+    /* Check parameter */
+    assert(p_denoise != NULL);
+
+    for (index = 0; index < 2; index++)
+    {
+        glDeleteFramebuffers(1, &(p_denoise->fbs[index]));
+        glDeleteTextures(1, &(p_denoise->texs[index]));
+
+        p_denoise->fbs[index]  = 0;
+        p_denoise->texs[index] = 0;
+    }
+}
+
+GLuint denoise_apply(denoise_t * p_denoise, GLuint prog,
+                     GLenum target, GLuint tex, gl_res_t res)
+{
+    /* Write to one texture while reading the other (ping-pong) */
+    uint32_t cur  = 0;
+    uint32_t prev = 0;
+
+    GLenum targets[2] = { 0, GL_TEXTURE_2D };
+    GLuint texs[2]    = { 0, 0 };
+
+    /* Check parameters */
+    assert((p_denoise != NULL) && (prog != 0) && (tex != 0));
+
+    cur  = p_denoise->frame % 2;
+    prev = 1 - cur;
+
+    /* Camera frame from texture unit 0 and previous frame from unit 1 */
+    targets[0] = target;
+    texs[0]    = tex;
+    texs[1]    = p_denoise->texs[prev];
+
+    glUseProgram(prog);
+    glUniform1i(glGetUniformLocation(prog, "yuyvTexture"), 0);
+    glUniform1i(glGetUniformLocation(prog, "historyTexture"), 1);
+
+    /* There is no previous frame at the first frame */
+    glUniform1f(glGetUniformLocation(prog, "strength"),
+                (p_denoise->frame == 0) ? 0.0f : p_denoise->strength);
+
+    glUniform1f(glGetUniformLocation(prog, "motionThreshold"),
+                DENOISE_MOTION_THRESHOLD);
+
+    /* Render denoised frame. It's drawn without 'SHADER_FLIP_Y', so its
+     * first row is the top of the image */
+    glBindFramebuffer(GL_FRAMEBUFFER, p_denoise->fbs[cur]);
+
+    gl_render_textures(prog, targets, texs, 2, res);
+
+    /* Unbind framebuffer */
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    p_denoise->frame++;
+
+    return p_denoise->texs[cur];
+}
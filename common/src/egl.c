@@ -385,6 +385,99 @@ EGLImageKHR * egl_create_nv12_images(EGLDisplay display,
     return p_imgs;
 }
 
+EGLImageKHR egl_create_plane_image(EGLDisplay display,
+                                   uint32_t width, uint32_t height,
+                                   uint32_t fourcc, int dmabuf_fd)
+{
+    EGLImageKHR img = EGL_NO_IMAGE_KHR;
+
+    /* Check parameters */
+    assert(display != EGL_NO_DISPLAY);
+    assert((width > 0) && (height > 0) && (dmabuf_fd > 0));
+    assert((fourcc == DRM_FORMAT_R8) || (fourcc == DRM_FORMAT_GR88));
+
+    EGLint img_attribs[] =
+    {
+        /* The logical dimensions of the plane in pixels */
+        EGL_WIDTH, width,
+        EGL_HEIGHT, height,
+
+        /* Pixel format of the plane, as specified by 'drm_fourcc.h'.
+         * It's a color format, so no YUV extension is needed to render it */
+        EGL_LINUX_DRM_FOURCC_EXT, fourcc,
+
+        EGL_DMA_BUF_PLANE0_FD_EXT, dmabuf_fd,
+        EGL_DMA_BUF_PLANE0_OFFSET_EXT, 0,
+
+        /* 1 byte per pixel (R8) or 2 bytes per pixel (GR88) */
+        EGL_DMA_BUF_PLANE0_PITCH_EXT,
+                            (fourcc == DRM_FORMAT_R8) ? width : width * 2,
+        EGL_NONE,
+    };
+
+    /* Create EGLImage from a Linux dmabuf file descriptor */
+    img = eglCreateImageKHR(display, EGL_NO_CONTEXT, EGL_LINUX_DMA_BUF_EXT,
+                            (EGLClientBuffer)NULL, img_attribs);
+    if (img == EGL_NO_IMAGE_KHR)
+    {
+        printf("Error: Failed to create plane EGLImage\n");
+    }
+
+    return img;
+}
+
+EGLImageKHR * egl_create_nv12_plane_images(EGLDisplay display,
+                                           uint32_t width, uint32_t height,
+                                           mmngr_buf_t * p_bufs,
+                                           uint32_t count)
+{
+    EGLImageKHR * p_imgs = NULL;
+
+    uint32_t index = 0;
+    mmngr_dmabuf_exp_t * p_dmabufs = NULL;
+
+    /* Check parameters */
+    assert(display != EGL_NO_DISPLAY);
+    assert((width > 0) && (height > 0));
+    assert((p_bufs != NULL) && (count > 0));
+
+    p_imgs = (EGLImageKHR *)malloc(2 * count * sizeof(EGLImageKHR));
+
+    for (index = 0; index < 2 * count; index++)
+    {
+        p_dmabufs = p_bufs[index / 2].p_dmabufs;
+
+        /* Plane 0 has a Y value per pixel. Plane 1 has a pair of U and V
+         * values per 2x2 pixels */
+        if ((index % 2) == 0)
+        {
+            p_imgs[index] = egl_create_plane_image(display, width, height,
+                                                   DRM_FORMAT_R8,
+                                                   p_dmabufs[0].dmabuf_fd);
+        }
+        else
+        {
+            p_imgs[index] = egl_create_plane_image(display,
+                                                   width / 2, height / 2,
+                                                   DRM_FORMAT_GR88,
+                                                   p_dmabufs[1].dmabuf_fd);
+        }
+
+        if (p_imgs[index] == EGL_NO_IMAGE_KHR)
+        {
+            break;
+        }
+    }
+
+    if (index < 2 * count)
+    {
+        egl_delete_images(display, p_imgs, index);
+        return NULL;
+    }
+
+    return p_imgs;
+}
+
 void egl_delete_images(EGLDisplay display, EGLImageKHR * p_imgs, uint32_t cnt)
 {
     uint32_t index = 0;
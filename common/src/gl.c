@@ -18,6 +18,11 @@
 #include <stdio.h>
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <inttypes.h>
+
+#include <sys/stat.h>
 
 #include "gl.h"
 #include "util.h"
@@ -31,6 +36,26 @@ typedef void (*GLEGLIMAGETARGETTEXTURE2DOES) (GLenum target,
 
 GLEGLIMAGETARGETTEXTURE2DOES glEGLImageTargetTexture2DOES;
 
+/******************************************************************************
+ *                        STATIC FUNCTION DECLARATION                         *
+ ******************************************************************************/
+
+static void get_rectangle_transform(gl_res_t res, mat4 transform_mat);
+
+static void apply_orientation(gl_res_t res, mat4 mat);
+
+/* Set uniforms of texture programs and viewport for 'res.p_scaler'.
+ * Texture filtering of 'target' (bound to the active unit) is also set */
+static void apply_scaler(GLuint prog, GLenum target, gl_res_t res);
+
+static GLuint compile_shader(const char * p_src, GLenum type);
+
+static void get_prog_cache_file(const char * p_vs_src, const char * p_fs_src,
+                                char * p_file, size_t size);
+
+static GLuint load_prog_binary(const char * p_file);
+static void save_prog_binary(GLuint prog, const char * p_file);
+
 /******************************************************************************
  *                            FUNCTION DEFINITION                             *
  ******************************************************************************/
@@ -40,11 +65,6 @@ GLuint gl_create_shader(const char * p_file, GLenum type)
     GLuint shader = 0;
     char * p_shader_src = NULL;
 
-    GLint log_len = 0;
-    char * p_log  = NULL;
-
-    GLint b_compile_ok = GL_FALSE;
-
     /* Check parameter */
     assert(p_file != NULL);
 
@@ -55,38 +75,10 @@ GLuint gl_create_shader(const char * p_file, GLenum type)
         return 0;
     }
 
-    /* Create an empty shader object */
-    shader = glCreateShader(type);
-    if (shader == 0)
-    {
-        printf("Error: Failed to create shader object\n");
-        return 0;
-    }
-
-    /* Copy source code into the shader object */
-    glShaderSource(shader, 1, (const GLchar **)&p_shader_src, NULL);
+    shader = compile_shader(p_shader_src, type);
     free(p_shader_src);
 
-    /* Compile the source code strings that was stored in the shader object */
-    glCompileShader(shader);
-
-    /* Get status of the last compile operation on the shader object */
-    glGetShaderiv(shader, GL_COMPILE_STATUS, &b_compile_ok);
-    if (b_compile_ok == GL_FALSE)
-    {
-        glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &log_len);
-        p_log = (char *)malloc(log_len);
-
-        /* Get the compile error of the shader object */
-        glGetShaderInfoLog(shader, log_len, NULL, p_log);
-        printf("Error: Failed to compile shader:\n%s\n", p_log);
-        free(p_log);
-
-        glDeleteShader(shader);
-        return 0;
-    }
-
-  return shader;
+    return shader;
 }
 
 GLuint gl_create_prog_from_objs(GLuint vs_object, GLuint fs_object)
@@ -113,6 +105,9 @@ GLuint gl_create_prog_from_objs(GLuint vs_object, GLuint fs_object)
     glAttachShader(program, vs_object);
     glAttachShader(program, fs_object);
 
+    /* Ask driver to keep the binary, so it can be cached after linking */
+    glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
     /* Link the program object */
     glLinkProgram(program);
 
@@ -136,28 +131,73 @@ GLuint gl_create_prog_from_objs(GLuint vs_object, GLuint fs_object)
 }
 
 GLuint gl_create_prog_from_src(const char * p_vs_file, const char * p_fs_file)
+{
+    GLuint prog_object = 0;
+
+    char * p_vs_src = NULL;
+    char * p_fs_src = NULL;
+
+    /* Check parameters */
+    assert((p_vs_file != NULL) && (p_fs_file != NULL));
+
+    /* Read source code of vertex shader and fragment shader */
+    p_vs_src = util_read_file(p_vs_file);
+    p_fs_src = util_read_file(p_fs_file);
+
+    if ((p_vs_src == NULL) || (p_fs_src == NULL))
+    {
+        printf("Error: Failed to open '%s'\n",
+               (p_vs_src == NULL) ? p_vs_file : p_fs_file);
+    }
+    else
+    {
+        prog_object = gl_create_prog_from_str(p_vs_src, p_fs_src);
+    }
+
+    free(p_vs_src);
+    free(p_fs_src);
+
+    return prog_object;
+}
+
+GLuint gl_create_prog_from_str(const char * p_vs_src, const char * p_fs_src)
 {
     GLuint vs_object   = 0;
     GLuint fs_object   = 0;
     GLuint prog_object = 0;
 
+    char cache_file[128];
+
     /* Check parameters */
-    assert((p_vs_file != NULL) && (p_fs_file != NULL));
+    assert((p_vs_src != NULL) && (p_fs_src != NULL));
+
+    /* Load program binary from cache. Compile it if not found */
+    get_prog_cache_file(p_vs_src, p_fs_src, cache_file, sizeof(cache_file));
 
-    /* Create and compile vertex shader object */
-    vs_object = gl_create_shader(p_vs_file, GL_VERTEX_SHADER);
+    prog_object = load_prog_binary(cache_file);
+    if (prog_object == 0)
+    {
+        /* Create and compile vertex shader object */
+        vs_object = compile_shader(p_vs_src, GL_VERTEX_SHADER);
+
+        /* Create and compile fragment shader object */
+        fs_object = compile_shader(p_fs_src, GL_FRAGMENT_SHADER);
 
-    /* Create and compile fragment shader object */
-    fs_object = gl_create_shader(p_fs_file, GL_FRAGMENT_SHADER);
+        /* Create program object and
+         * link vertex shader object and fragment shader object to it */
+        prog_object = gl_create_prog_from_objs(vs_object, fs_object);
 
-    /* Create program object and
-     * link vertex shader object and fragment shader object to it */
-    prog_object = gl_create_prog_from_objs(vs_object, fs_object);
+        /* The vertex shader object and fragment shader object are not needed
+         * after creating program. So, it should be deleted */
+        glDeleteShader(vs_object);
+        glDeleteShader(fs_object);
 
-    /* The vertex shader object and fragment shader object are not needed
-     * after creating program. So, it should be deleted */
-    glDeleteShader(vs_object);
-    glDeleteShader(fs_object);
+        /* Save program binary for the next run */
+        if (prog_object != 0)
+        {
+            save_prog_binary(prog_object, cache_file);
+        }
+    }
 
     return prog_object;
 }
@@ -201,8 +241,7 @@ bool gl_init_ext_funcs()
     if ((glEGLImageTargetTexture2DOES == NULL) ||
         !gl_is_ext_supported("GL_OES_surfaceless_context") ||
         !gl_is_ext_supported("GL_OES_EGL_image_external") ||
-        !gl_is_ext_supported("GL_OES_EGL_image_external_essl3") ||
-        !gl_is_ext_supported("GL_EXT_YUV_target"))
+        !gl_is_ext_supported("GL_OES_EGL_image_external_essl3"))
     {
         printf("Error: Failed to init OpenGL ES extension functions\n");
         return false;
@@ -272,6 +311,62 @@ GLuint * gl_create_external_textures(EGLImageKHR * p_images, uint32_t count)
     return p_textures;
 }
 
+GLuint gl_create_plane_texture(EGLImageKHR image)
+{
+    GLuint texture = 0;
+
+    /* Check parameter */
+    assert(image != EGL_NO_IMAGE_KHR);
+
+    /* R8 and GR88 images are plain color formats, so they are bound to
+     * GL_TEXTURE_2D. Unlike external textures, they can be rendered to on
+     * any GPU which imports dmabuf */
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    /* Define texture from an existing EGLImage */
+    glEGLImageTargetTexture2DOES(GL_TEXTURE_2D, image);
+
+    /* Unbind texture */
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    return texture;
+}
+
+GLuint * gl_create_plane_textures(EGLImageKHR * p_images, uint32_t count)
+{
+    GLuint * p_textures = NULL;
+    uint32_t index = 0;
+
+    /* Check parameters */
+    assert((p_images != NULL) && (count > 0));
+
+    p_textures = (GLuint *)malloc(count * sizeof(GLuint));
+
+    for (index = 0; index < count; index++)
+    {
+        p_textures[index] = gl_create_plane_texture(p_images[index]);
+        if (p_textures[index] == 0)
+        {
+            printf("Error: Failed to create texture at index '%d'\n", index);
+            break;
+        }
+    }
+
+    if (index < count)
+    {
+        gl_delete_textures(p_textures, index);
+        return NULL;
+    }
+
+    return p_textures;
+}
+
 GLuint gl_create_rgb_texture(uint32_t width, uint32_t height, char * p_data)
 {
     GLuint texture = 0;
@@ -339,6 +434,129 @@ GLuint * gl_create_rgb_textures(uint32_t width, uint32_t height,
     return p_textures;
 }
 
+GLuint gl_create_rgba_texture(uint32_t width, uint32_t height, char * p_data)
+{
+    GLuint texture = 0;
+
+    /* Check parameters */
+    assert((width > 0) && (height > 0));
+
+    /* Create an RGBA texture */
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width,
+                 height, 0, GL_RGBA, GL_UNSIGNED_BYTE, p_data);
+
+    /* Select the closest texel (see 'gl_create_rgb_texture') */
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    /* Unbind texture */
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    return texture;
+}
+
+GLuint gl_create_color_texture(uint32_t width, uint32_t height,
+                               GLenum format, size_t * p_size)
+{
+    GLuint texture = 0;
+
+    /* Format and type of pixel data, and bytes per pixel */
+    GLenum data_fmt  = GL_RGBA;
+    GLenum data_type = GL_UNSIGNED_BYTE;
+    uint32_t bpp     = 4;
+
+    /* Check parameters */
+    assert((width > 0) && (height > 0));
+
+    switch (format)
+    {
+        case GL_RGBA8:
+        {
+            /* Intentionally left blank */
+        }
+        break;
+
+        case GL_RGBA4:
+        {
+            data_type = GL_UNSIGNED_SHORT_4_4_4_4;
+            bpp       = 2;
+        }
+        break;
+
+        case GL_RGB5_A1:
+        {
+            data_type = GL_UNSIGNED_SHORT_5_5_5_1;
+            bpp       = 2;
+        }
+        break;
+
+        case GL_RGB565:
+        {
+            data_fmt  = GL_RGB;
+            data_type = GL_UNSIGNED_SHORT_5_6_5;
+            bpp       = 2;
+        }
+        break;
+
+        case GL_R8:
+        {
+            data_fmt = GL_RED;
+            bpp      = 1;
+        }
+        break;
+
+        case GL_RGB10_A2:
+        {
+            data_type = GL_UNSIGNED_INT_2_10_10_10_REV;
+        }
+        break;
+
+        case GL_RGBA16F:
+        {
+            data_type = GL_HALF_FLOAT;
+            bpp       = 8;
+        }
+        break;
+
+        default:
+        {
+            printf("Error: Texture format '0x%x' is not supported\n", format);
+            return 0;
+        }
+        break;
+    }
+
+    /* Create texture */
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+
+    glTexImage2D(GL_TEXTURE_2D, 0, format, width,
+                 height, 0, data_fmt, data_type, NULL);
+
+    /* Select the closest texel (see 'gl_create_rgb_texture') */
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    /* Unbind texture */
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    if (p_size != NULL)
+    {
+        *p_size = (size_t)width * height * bpp;
+    }
+
+    return texture;
+}
+
 void gl_delete_textures(GLuint * p_textures, uint32_t count)
 {
     /* Check parameter */
@@ -462,9 +680,19 @@ gl_res_t gl_create_resources(uint32_t width,
     /* Create projection matrix */
     glm_ortho(0, width, 0, height, 0, 1, res.projection_mat);
 
+    /* Render to framebuffers whose first row is the bottom of the image */
+    res.b_top_down = false;
+
+    /* Render entire textures to the viewport with the canvas quad */
+    res.p_scaler = NULL;
+    res.p_mesh   = NULL;
+
     /* Generate glyph array */
     res.pp_glyphs = ttf_generate(p_ttf);
 
+    /* Generate signed distance field font */
+    res.p_sdf_font = ttf_generate_sdf(p_ttf);
+
     /* Create vertex/index buffer objects and add data to it */
     glGenBuffers(1, &(res.vbo_rec_verts));
     glBindBuffer(GL_ARRAY_BUFFER, res.vbo_rec_verts);
@@ -474,9 +702,7 @@ gl_res_t gl_create_resources(uint32_t width,
     glBindBuffer(GL_ARRAY_BUFFER, res.vbo_canvas_verts);
     glBufferData(GL_ARRAY_BUFFER, sizeof(cnv_verts), cnv_verts, GL_STATIC_DRAW);
 
-    glGenBuffers(1, &(res.vbo_text_verts));
-    glBindBuffer(GL_ARRAY_BUFFER, res.vbo_text_verts);
-    glBufferData(GL_ARRAY_BUFFER, 4 * 4 * sizeof(float), NULL, GL_DYNAMIC_DRAW);
+    res.p_stream = stream_create(GL_STREAM_SIZE);
 
     glGenBuffers(1, &(res.ibo));
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, res.ibo);
@@ -500,10 +726,15 @@ void gl_delete_resources(gl_res_t res)
     /* Delete glyph array */
     ttf_delete_glyphs(res.pp_glyphs);
 
+    /* Delete signed distance field font */
+    ttf_delete_sdf_font(res.p_sdf_font);
+
     /* Delete vertex buffer objects */
     glDeleteBuffers(1, &(res.vbo_rec_verts));
     glDeleteBuffers(1, &(res.vbo_canvas_verts));
-    glDeleteBuffers(1, &(res.vbo_text_verts));
+
+    /* Delete streaming vertex buffer */
+    stream_delete(res.p_stream);
 
     /* Delete index buffer object */
     glDeleteBuffers(1, &(res.ibo));
@@ -513,41 +744,18 @@ void gl_draw_rectangle(GLuint prog, gl_res_t res)
 {
     GLint tmp_cnt = 0;
 
-    float move  = 0.0f;
-    float angle = 0.0f;
-    float scale = 0.0f;
-
     GLint u_transform = 0;
     mat4 transform_mat = GLM_MAT4_IDENTITY_INIT;
 
-    struct timeval draw_tv;
-
-    /* The number of seconds since 'res' is created */
-    double secs = 0.0;
-
     /* Check parameter */
     assert(prog != 0);
 
     /* Use program object for drawing rectangle */
     glUseProgram(prog);
 
-    /* Get current time */
-    gettimeofday(&draw_tv, NULL);
-    secs = TIMEVAL_TO_SECS(draw_tv) - TIMEVAL_TO_SECS(res.start_tv);
-
-    /* Translate between -0.5 and 0.5 every 5 seconds */
-    move = sinf(secs * (2 * GLM_PI / 5)) / 2;
-
-    /* Rotate 45 degrees per second */
-    angle = secs * 45;
-
-    /* Scale between 1 and 1.5 every 2 seconds */
-    scale = ((sinf(secs * (2 * GLM_PI / 2)) + 1) / 4) + 1;
-
     /* Calculate transformation matrix */
-    glm_translate(transform_mat, (vec3){ move, 0.0f, 0.0f });
-    glm_rotate(transform_mat, glm_rad(angle), GLM_ZUP);
-    glm_scale(transform_mat, (vec3){ scale, scale, 0.0f });
+    get_rectangle_transform(res, transform_mat);
+    apply_orientation(res, transform_mat);
 
     /* Set transformation matrix to uniform variable */
     u_transform = glGetUniformLocation(prog, "transform");
@@ -587,52 +795,146 @@ void gl_draw_rectangle(GLuint prog, gl_res_t res)
     glDisableVertexAttribArray(1);
 }
 
-void gl_render_texture(GLuint prog, GLenum target, GLuint tex, gl_res_t res)
+rect_t gl_get_rectangle_bounds(uint32_t width, uint32_t height, gl_res_t res)
 {
-    GLint tmp_cnt = 0;
+    uint32_t index = 0;
+    rect_t bounds;
 
-    /* Check parameter */
-    assert((prog != 0) && (tex != 0));
+    vec4 corner;
+    mat4 transform_mat = GLM_MAT4_IDENTITY_INIT;
 
-    /* Use program object for rendering texture 'tex' */
-    glUseProgram(prog);
+    /* Bounding box in normalized device coordinates */
+    float min_x =  1.0f;
+    float min_y =  1.0f;
+    float max_x = -1.0f;
+    float max_y = -1.0f;
 
-    /* Enable attribute 0 since it's disabled by default */
-    glEnableVertexAttribArray(0);
+    /* Check parameters */
+    assert((width > 0) && (height > 0));
 
-    /* Show OpenGL ES how the vertex array should be interpreted */
-    glBindBuffer(GL_ARRAY_BUFFER, res.vbo_canvas_verts);
+    /* Calculate transformation matrix */
+    get_rectangle_transform(res, transform_mat);
 
-    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE,
-                          4 * sizeof(GLfloat), (void *)0);
+    /* Transform 4 corners of rectangle (see 'gl_create_resources') */
+    for (index = 0; index < 4; index++)
+    {
+        corner[0] = ((index == 1) || (index == 2)) ? 0.2f : -0.2f;
+        corner[1] = (index >= 2) ? 0.2f : -0.2f;
+        corner[2] = 0.0f;
+        corner[3] = 1.0f;
 
-    /* Bind the texture */
-    glBindTexture(target, tex);
+        glm_mat4_mulv(transform_mat, corner, corner);
 
-    /* Render the texture */
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, res.ibo);
-    glGetBufferParameteriv(GL_ELEMENT_ARRAY_BUFFER, GL_BUFFER_SIZE, &tmp_cnt);
+        min_x = fminf(min_x, corner[0]);
+        min_y = fminf(min_y, corner[1]);
+        max_x = fmaxf(max_x, corner[0]);
+        max_y = fmaxf(max_y, corner[1]);
+    }
 
-    glDrawElements(GL_TRIANGLES, tmp_cnt, GL_UNSIGNED_BYTE, 0);
+    /* Convert to pixels. Extend 1 pixel on each side for antialiased edges
+     * and the time elapsed until the rectangle is actually drawn */
+    bounds.x = (int32_t)floorf(((min_x + 1.0f) / 2.0f) * width) - 1;
+    bounds.y = (int32_t)floorf(((min_y + 1.0f) / 2.0f) * height) - 1;
 
-    /* Wait until 'glDrawElements' finishes */
-    glFinish();
+    bounds.width  = (int32_t)ceilf(((max_x + 1.0f) / 2.0f) * width)
+                    - bounds.x + 1;
+    bounds.height = (int32_t)ceilf(((max_y + 1.0f) / 2.0f) * height)
+                    - bounds.y + 1;
 
-    /* Unbind texture */
-    glBindTexture(target, 0);
+    return bounds;
+}
 
-    /* Unbind buffers */
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+void gl_render_texture(GLuint prog, GLenum target, GLuint tex, gl_res_t res)
+{
+    /* Check parameter */
+    assert((prog != 0) && (tex != 0));
 
-    /* Disable attribute */
-    glDisableVertexAttribArray(0);
+    /* It's a pass with a single texture (in texture unit 0) */
+    gl_render_textures(prog, &target, &tex, 1, res);
+}
+
+void gl_render_textures(GLuint prog, const GLenum * p_targets,
+                        const GLuint * p_texs, uint32_t count, gl_res_t res)
+{
+    GLint tmp_cnt = 0;
+    GLint viewport[4];
+
+    uint32_t index = 0;
+
+    /* Check parameters */
+    assert((prog != 0) && (p_targets != NULL) && (p_texs != NULL));
+    assert(count > 0);
+
+    /* Use program object for rendering textures */
+    glUseProgram(prog);
+
+    /* Enable attribute 0 since it's disabled by default */
+    glEnableVertexAttribArray(0);
+
+    /* Show OpenGL ES how the vertex array should be interpreted.
+     * A mesh has the same vertex layout as the canvas quad */
+    glBindBuffer(GL_ARRAY_BUFFER, (res.p_mesh != NULL) ? res.p_mesh->vbo :
+                                                         res.vbo_canvas_verts);
+
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE,
+                          4 * sizeof(GLfloat), (void *)0);
+
+    glGetIntegerv(GL_VIEWPORT, viewport);
+
+    /* Bind each texture to its own texture unit */
+    for (index = 0; index < count; index++)
+    {
+        glActiveTexture(GL_TEXTURE0 + index);
+        glBindTexture(p_targets[index], p_texs[index]);
+    }
+
+    /* Crop and scale the source (texture unit 0). Other textures (such as
+     * overlay) cover the entire destination and keep their own filters */
+    glActiveTexture(GL_TEXTURE0);
+    apply_scaler(prog, p_targets[0], res);
+
+    /* Render the textures */
+    if (res.p_mesh != NULL)
+    {
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, res.p_mesh->ibo);
+        glDrawElements(GL_TRIANGLES, res.p_mesh->index_count,
+                       GL_UNSIGNED_SHORT, 0);
+    }
+    else
+    {
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, res.ibo);
+        glGetBufferParameteriv(GL_ELEMENT_ARRAY_BUFFER, GL_BUFFER_SIZE,
+                               &tmp_cnt);
+
+        glDrawElements(GL_TRIANGLES, tmp_cnt, GL_UNSIGNED_BYTE, 0);
+    }
+
+    /* Wait until 'glDrawElements' finishes */
+    glFinish();
+
+    /* Restore viewport */
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+
+    /* Unbind textures */
+    for (index = count; index > 0; index--)
+    {
+        glActiveTexture(GL_TEXTURE0 + index - 1);
+        glBindTexture(p_targets[index - 1], 0);
+    }
+
+    /* Unbind buffers */
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    /* Disable attribute */
+    glDisableVertexAttribArray(0);
 }
 
 void gl_draw_text(GLuint prog, const char * p_text,
                   float x, float y, color_t color, gl_res_t res)
 {
     uint32_t index = 0;
+    uint32_t count = 0;
 
     float pos_x = 0.0f;
     float pos_y = 0.0f;
@@ -640,41 +942,28 @@ void gl_draw_text(GLuint prog, const char * p_text,
     int width  = 0;
     int height = 0;
 
-    GLint tmp_cnt = 0;
-
     GLint u_text_color = 0;
     GLint u_projection = 0;
 
     glyph_t * p_glyph = NULL;
 
-    /* Check parameter */
-    assert((prog != 0) && (p_text != NULL));
-
-    /* Enable blending */
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-    /* Use program object for drawing text */
-    glUseProgram(prog);
-
-    /* Set text color to uniform variable */
-    u_text_color = glGetUniformLocation(prog, "textColor");
-    glUniform3f(u_text_color, color[0], color[1], color[2]);
+    /* Glyphs which are drawn and their vertices.
+     * There are 6 vertices (2 triangles) per glyph, each is <vec2 pos,
+     * vec2 tex> */
+    glyph_t ** pp_drawn = NULL;
+    float (* p_verts)[6][4] = NULL;
 
-    /* Set projection matrix to uniform variable */
-    u_projection = glGetUniformLocation(prog, "projection");
-    glUniformMatrix4fv(u_projection, 1, GL_FALSE, res.projection_mat[0]);
+    int32_t offset = -1;
 
-    /* Enable attribute 0 since it's disabled by default */
-    glEnableVertexAttribArray(0);
+    mat4 projection_mat;
 
-    /* Show OpenGL ES how the vertex array should be interpreted */
-    glBindBuffer(GL_ARRAY_BUFFER, res.vbo_text_verts);
+    /* Check parameter */
+    assert((prog != 0) && (p_text != NULL));
 
-    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE,
-                          4 * sizeof(GLfloat), (void *)0);
+    pp_drawn = (glyph_t **)malloc(strlen(p_text) * sizeof(glyph_t *));
+    p_verts  = malloc(strlen(p_text) * sizeof(*p_verts));
 
-    /* Iterate through all characters */
+    /* Lay out all characters */
     for (index = 0; index < strlen(p_text); index++)
     {
         p_glyph = res.pp_glyphs[(unsigned char)p_text[index]];
@@ -687,44 +976,664 @@ void gl_draw_text(GLuint prog, const char * p_text,
             pos_x = x + p_glyph->offset_x;
             pos_y = y - (height - p_glyph->offset_y);
 
-            float text_verts[4][4] =
+            float glyph_verts[6][4] =
             {
                 { pos_x        , pos_y + height, 0.0f, 0.0f }, /*Bottom-left */
                 { pos_x + width, pos_y + height, 1.0f, 0.0f }, /*Bottom-right*/
                 { pos_x + width, pos_y         , 1.0f, 1.0f }, /*Top-right   */
-                { pos_x        , pos_y         , 0.0f, 1.0f }  /*Top-left    */
+                { pos_x + width, pos_y         , 1.0f, 1.0f }, /*Top-right   */
+                { pos_x        , pos_y         , 0.0f, 1.0f }, /*Top-left    */
+                { pos_x        , pos_y + height, 0.0f, 0.0f }, /*Bottom-left */
             };
 
-            /* Update VBO */
-            glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(text_verts), text_verts);
+            memcpy(p_verts[count], glyph_verts, sizeof(glyph_verts));
+            pp_drawn[count] = p_glyph;
+            count++;
+
+            /* Prepare for the next character */
+            x += p_glyph->advance;
+        }
+    }
+
+    /* Upload vertices of all glyphs at once */
+    if (count > 0)
+    {
+        offset = stream_upload(res.p_stream, p_verts,
+                               count * sizeof(*p_verts));
+    }
+
+    if (offset >= 0)
+    {
+        /* Enable blending.
+         * Alpha is accumulated separately so that text drawn on a transparent
+         * framebuffer (such as 'overlay_t') results in premultiplied alpha */
+        glEnable(GL_BLEND);
+        glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA,
+                            GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+        /* Use program object for drawing text */
+        glUseProgram(prog);
+
+        /* Set text color to uniform variable */
+        u_text_color = glGetUniformLocation(prog, "textColor");
+        glUniform3f(u_text_color, color[0], color[1], color[2]);
+
+        /* Set projection matrix to uniform variable */
+        gl_get_projection_matrix(res, projection_mat);
+
+        u_projection = glGetUniformLocation(prog, "projection");
+        glUniformMatrix4fv(u_projection, 1, GL_FALSE, projection_mat[0]);
+
+        /* Enable attribute 0 since it's disabled by default */
+        glEnableVertexAttribArray(0);
+
+        /* Show OpenGL ES how the vertex array should be interpreted.
+         * Note: The stream's buffer is bound by 'stream_upload' */
+        glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE,
+                              4 * sizeof(GLfloat), (void *)(intptr_t)offset);
+
+        /* Each glyph has its own bitmap texture. So, they are drawn one by
+         * one, but without any further upload */
+        for (index = 0; index < count; index++)
+        {
+            glBindTexture(GL_TEXTURE_2D, pp_drawn[index]->tex_id);
+            glDrawArrays(GL_TRIANGLES, index * 6, 6);
+        }
+
+        /* Unbind texture */
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        /* Unbind VBO buffer */
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        /* Disable attribute */
+        glDisableVertexAttribArray(0);
+
+        /* Disable blending */
+        glDisable(GL_BLEND);
+    }
+
+    free(pp_drawn);
+    free(p_verts);
+}
+
+void gl_draw_sdf_text(GLuint prog, const char * p_text, float x, float y,
+                      float size, const text_style_t * p_style, gl_res_t res)
+{
+    ttf_sdf_font_t * p_font = res.p_sdf_font;
+    glyph_t * p_glyph = NULL;
+
+    uint32_t index = 0;
+    uint32_t count = 0;
 
-            /* Bind bitmap texture */
-            glBindTexture(GL_TEXTURE_2D, p_glyph->tex_id);
+    /* 6 vertices (2 triangles) per glyph, each is <vec2 pos, vec2 tex> */
+    float (* p_verts)[6][4] = NULL;
 
-            /* Draw texture */
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, res.ibo);
-            glGetBufferParameteriv(GL_ELEMENT_ARRAY_BUFFER,
-                                   GL_BUFFER_SIZE, &tmp_cnt);
+    int32_t offset = -1;
 
-            glDrawElements(GL_TRIANGLES, tmp_cnt, GL_UNSIGNED_BYTE, 0);
+    float left   = 0.0f;
+    float top    = 0.0f;
+    float right  = 0.0f;
+    float bottom = 0.0f;
+
+    /* Ratio between text on screen and glyphs of the font */
+    float scale = 0.0f;
+
+    /* Check parameters */
+    assert((prog != 0) && (p_text != NULL) && (p_style != NULL));
+    assert((p_font != NULL) && (size > 0.0f));
+
+    scale = size / p_font->size;
+
+    p_verts = malloc(strlen(p_text) * sizeof(*p_verts));
+
+    /* Lay out all characters */
+    for (index = 0; index < strlen(p_text); index++)
+    {
+        p_glyph = p_font->pp_glyphs[(unsigned char)p_text[index]];
+
+        if (p_glyph != NULL)
+        {
+            left   = x + (p_glyph->offset_x * scale);
+            top    = y + (p_glyph->offset_y * scale);
+            right  = left + (p_glyph->width  * scale);
+            bottom = top  - (p_glyph->height * scale);
+
+            float glyph_verts[6][4] =
+            {
+                { left,  top,    p_glyph->tex_left,  p_glyph->tex_top    },
+                { right, top,    p_glyph->tex_right, p_glyph->tex_top    },
+                { right, bottom, p_glyph->tex_right, p_glyph->tex_bottom },
+                { right, bottom, p_glyph->tex_right, p_glyph->tex_bottom },
+                { left,  bottom, p_glyph->tex_left,  p_glyph->tex_bottom },
+                { left,  top,    p_glyph->tex_left,  p_glyph->tex_top    },
+            };
+
+            memcpy(p_verts[count], glyph_verts, sizeof(glyph_verts));
+            count++;
 
             /* Prepare for the next character */
-            x += p_glyph->advance;
+            x += p_glyph->advance * scale;
         }
     }
 
-    /* Wait until 'glDrawElements' finishes */
-    glFinish();
+    /* Upload vertices of all glyphs at once */
+    if (count > 0)
+    {
+        offset = stream_upload(res.p_stream, p_verts,
+                               count * sizeof(*p_verts));
+    }
 
-    /* Unbind texture */
-    glBindTexture(GL_TEXTURE_2D, 0);
+    if (offset >= 0)
+    {
+        /* Enable blending (see 'gl_draw_text') */
+        glEnable(GL_BLEND);
+        glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA,
+                            GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
 
-    /* Unbind VBO buffer */
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+        /* Use program object for drawing text and set its uniforms */
+        gl_use_sdf_text_prog(prog, size, p_style, res);
 
-    /* Disable attribute */
-    glDisableVertexAttribArray(0);
+        /* Enable attribute 0 since it's disabled by default */
+        glEnableVertexAttribArray(0);
+
+        glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE,
+                              4 * sizeof(GLfloat), (void *)(intptr_t)offset);
+
+        /* Bind atlas and draw all glyphs */
+        glBindTexture(GL_TEXTURE_2D, p_font->tex_id);
+
+        glDrawArrays(GL_TRIANGLES, 0, count * 6);
+
+        /* Unbind texture */
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        /* Unbind VBO buffer */
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        /* Disable attribute */
+        glDisableVertexAttribArray(0);
+
+        /* Disable blending */
+        glDisable(GL_BLEND);
+    }
+
+    free(p_verts);
+}
+
+void gl_use_sdf_text_prog(GLuint prog, float size,
+                          const text_style_t * p_style, gl_res_t res)
+{
+    ttf_sdf_font_t * p_font = res.p_sdf_font;
+
+    /* Ratio between text on screen and glyphs of the font */
+    float scale = 0.0f;
+
+    /* Factor which converts pixels on screen to values of the field */
+    float px_to_dist = 0.0f;
+
+    /* Factor which converts pixels on screen to texture coordinates */
+    float px_to_tex_x = 0.0f;
+    float px_to_tex_y = 0.0f;
+
+    mat4 projection_mat;
+
+    /* Check parameters */
+    assert((prog != 0) && (p_style != NULL));
+    assert((p_font != NULL) && (size > 0.0f));
+
+    scale = size / p_font->size;
+
+    px_to_dist  = 1.0f / (2.0f * p_font->spread * scale);
+    px_to_tex_x = 1.0f / (scale * SDF_UPSCALE * p_font->width);
+    px_to_tex_y = 1.0f / (scale * SDF_UPSCALE * p_font->height);
+
+    glUseProgram(prog);
+
+    /* Set projection matrix and style to uniform variables */
+    gl_get_projection_matrix(res, projection_mat);
+
+    glUniformMatrix4fv(glGetUniformLocation(prog, "projection"),
+                       1, GL_FALSE, projection_mat[0]);
+
+    glUniform3fv(glGetUniformLocation(prog, "textColor"),
+                 1, p_style->color);
+
+    glUniform3fv(glGetUniformLocation(prog, "outlineColor"),
+                 1, p_style->outline_color);
+
+    glUniform1f(glGetUniformLocation(prog, "outlineWidth"),
+                p_style->outline_width * px_to_dist);
+
+    glUniform3fv(glGetUniformLocation(prog, "shadowColor"),
+                 1, p_style->shadow_color);
+
+    glUniform1f(glGetUniformLocation(prog, "shadowOpacity"),
+                p_style->shadow_opacity);
+
+    glUniform2f(glGetUniformLocation(prog, "shadowOffset"),
+                p_style->shadow_offset_x * px_to_tex_x,
+                p_style->shadow_offset_y * px_to_tex_y);
+}
+
+void gl_get_projection_matrix(gl_res_t res, mat4 projection_mat)
+{
+    glm_mat4_copy(res.projection_mat, projection_mat);
+    apply_orientation(res, projection_mat);
+}
+
+scaler_t gl_init_scaler(uint32_t src_width, uint32_t src_height,
+                        uint32_t dst_width, uint32_t dst_height,
+                        bool b_letterbox)
+{
+    scaler_t scaler;
+
+    /* Check parameters */
+    assert((src_width > 0) && (src_height > 0));
+    assert((dst_width > 0) && (dst_height > 0));
+
+    scaler.src_width  = src_width;
+    scaler.src_height = src_height;
+
+    /* Render entire texture */
+    scaler.crop_x      = 0.0f;
+    scaler.crop_y      = 0.0f;
+    scaler.crop_width  = src_width;
+    scaler.crop_height = src_height;
+
+    /* Keep orientation of texture */
+    scaler.rotation   = 0;
+    scaler.b_mirror_x = false;
+    scaler.b_mirror_y = false;
+
+    scaler.dst_width   = dst_width;
+    scaler.dst_height  = dst_height;
+    scaler.b_letterbox = b_letterbox;
+
+    scaler.filter = GL_LINEAR;
+
+    return scaler;
+}
+
+void gl_set_zoom(scaler_t * p_scaler, float zoom,
+                 float center_x, float center_y)
+{
+    /* Check parameter */
+    assert(p_scaler != NULL);
+
+    /* Zooming out would show areas outside the texture */
+    zoom = (zoom < 1.0f) ? 1.0f : zoom;
+
+    p_scaler->crop_width  = p_scaler->src_width / zoom;
+    p_scaler->crop_height = p_scaler->src_height / zoom;
+
+    /* Center the region, then move it back inside the texture */
+    p_scaler->crop_x = center_x - (p_scaler->crop_width / 2.0f);
+    p_scaler->crop_y = center_y - (p_scaler->crop_height / 2.0f);
+
+    p_scaler->crop_x = glm_clamp(p_scaler->crop_x, 0.0f,
+                                 p_scaler->src_width - p_scaler->crop_width);
+    p_scaler->crop_y = glm_clamp(p_scaler->crop_y, 0.0f,
+                                 p_scaler->src_height - p_scaler->crop_height);
+}
+
+void gl_set_orientation(scaler_t * p_scaler, uint32_t rotation,
+                        bool b_mirror_x, bool b_mirror_y)
+{
+    /* Check parameters */
+    assert(p_scaler != NULL);
+    assert((rotation == 0)   || (rotation == 90) ||
+           (rotation == 180) || (rotation == 270));
+
+    p_scaler->rotation   = rotation;
+    p_scaler->b_mirror_x = b_mirror_x;
+    p_scaler->b_mirror_y = b_mirror_y;
+}
+
+void gl_get_scaler_mapping(const scaler_t * p_scaler, vec4 dst_area,
+                           vec4 src_region, mat3 orientation)
+{
+    /* Note: Matrices of cglm are column-major ('mat[column][row]') */
+    mat3 rotation = GLM_MAT3_IDENTITY_INIT;
+    mat3 mirror   = GLM_MAT3_IDENTITY_INIT;
+
+    float crop_ratio = 0.0f;
+    float dst_ratio  = 0.0f;
+
+    /* By default, the entire texture fills the entire viewport */
+    glm_vec4_copy((vec4){ 0.0f, 0.0f, 1.0f, 1.0f }, dst_area);
+    glm_vec4_copy((vec4){ 0.0f, 0.0f, 1.0f, 1.0f }, src_region);
+    glm_mat3_identity(orientation);
+
+    if (p_scaler != NULL)
+    {
+        src_region[0] = p_scaler->crop_x / p_scaler->src_width;
+        src_region[1] = p_scaler->crop_y / p_scaler->src_height;
+        src_region[2] = p_scaler->crop_width / p_scaler->src_width;
+        src_region[3] = p_scaler->crop_height / p_scaler->src_height;
+
+        /* Undo mirroring first, then undo rotation */
+        if (p_scaler->b_mirror_x)
+        {
+            mirror[0][0] = -1.0f;
+            mirror[2][0] =  1.0f;
+        }
+
+        if (p_scaler->b_mirror_y)
+        {
+            mirror[1][1] = -1.0f;
+            mirror[2][1] =  1.0f;
+        }
+
+        switch (p_scaler->rotation)
+        {
+            case 90:
+            {
+                /* (x, y) = (v, 1 - u) */
+                rotation[0][0] =  0.0f;
+                rotation[1][0] =  1.0f;
+                rotation[0][1] = -1.0f;
+                rotation[1][1] =  0.0f;
+                rotation[2][1] =  1.0f;
+            }
+            break;
+
+            case 180:
+            {
+                /* (x, y) = (1 - u, 1 - v) */
+                rotation[0][0] = -1.0f;
+                rotation[2][0] =  1.0f;
+                rotation[1][1] = -1.0f;
+                rotation[2][1] =  1.0f;
+            }
+            break;
+
+            case 270:
+            {
+                /* (x, y) = (1 - v, u) */
+                rotation[0][0] =  0.0f;
+                rotation[1][0] = -1.0f;
+                rotation[2][0] =  1.0f;
+                rotation[0][1] =  1.0f;
+                rotation[1][1] =  0.0f;
+            }
+            break;
+
+            default:
+            {
+                /* Intentionally left blank */
+            }
+            break;
+        }
+
+        glm_mat3_mul(rotation, mirror, orientation);
+
+        /* Shrink the area along 1 axis to keep aspect ratio of region.
+         * The rest of framebuffer becomes black bars */
+        if (p_scaler->b_letterbox)
+        {
+            crop_ratio = p_scaler->crop_width / p_scaler->crop_height;
+
+            /* Region is sideways in the destination */
+            if ((p_scaler->rotation == 90) || (p_scaler->rotation == 270))
+            {
+                crop_ratio = 1.0f / crop_ratio;
+            }
+
+            dst_ratio  = (float)p_scaler->dst_width / p_scaler->dst_height;
+
+            if (crop_ratio > dst_ratio)
+            {
+                dst_area[3] = dst_ratio / crop_ratio;
+                dst_area[1] = (1.0f - dst_area[3]) / 2.0f;
+            }
+            else
+            {
+                dst_area[2] = crop_ratio / dst_ratio;
+                dst_area[0] = (1.0f - dst_area[2]) / 2.0f;
+            }
+        }
+
+    }
+}
+
+/******************************************************************************
+ *                         STATIC FUNCTION DEFINITION                         *
+ ******************************************************************************/
+
+static void get_rectangle_transform(gl_res_t res, mat4 transform_mat)
+{
+    float move  = 0.0f;
+    float angle = 0.0f;
+    float scale = 0.0f;
+
+    struct timeval draw_tv;
+
+    /* The number of seconds since 'res' is created */
+    double secs = 0.0;
+
+    /* Get current time */
+    gettimeofday(&draw_tv, NULL);
+    secs = TIMEVAL_TO_SECS(draw_tv) - TIMEVAL_TO_SECS(res.start_tv);
+
+    /* Translate between -0.5 and 0.5 every 5 seconds */
+    move = sinf(secs * (2 * GLM_PI / 5)) / 2;
+
+    /* Rotate 45 degrees per second */
+    angle = secs * 45;
+
+    /* Scale between 1 and 1.5 every 2 seconds */
+    scale = ((sinf(secs * (2 * GLM_PI / 2)) + 1) / 4) + 1;
+
+    /* Calculate transformation matrix */
+    glm_mat4_identity(transform_mat);
+
+    glm_translate(transform_mat, (vec3){ move, 0.0f, 0.0f });
+    glm_rotate(transform_mat, glm_rad(angle), GLM_ZUP);
+    glm_scale(transform_mat, (vec3){ scale, scale, 0.0f });
+}
+
+static void apply_orientation(gl_res_t res, mat4 mat)
+{
+    mat4 flip_mat = GLM_MAT4_IDENTITY_INIT;
+
+    if (res.b_top_down)
+    {
+        /* Mirror normalized device coordinates vertically. So, the image
+         * looks the same as on a framebuffer whose first row is the bottom */
+        glm_scale(flip_mat, (vec3){ 1.0f, -1.0f, 1.0f });
+        glm_mat4_mul(flip_mat, mat, mat);
+    }
+}
+
+static GLuint compile_shader(const char * p_src, GLenum type)
+{
+    GLuint shader = 0;
+
+    GLint log_len = 0;
+    char * p_log  = NULL;
+
+    GLint b_compile_ok = GL_FALSE;
+
+    /* Check parameter */
+    assert(p_src != NULL);
+
+    /* Create an empty shader object */
+    shader = glCreateShader(type);
+    if (shader == 0)
+    {
+        printf("Error: Failed to create shader object\n");
+        return 0;
+    }
+
+    /* Copy source code into the shader object */
+    glShaderSource(shader, 1, (const GLchar **)&p_src, NULL);
+
+    /* Compile the source code strings that was stored in the shader object */
+    glCompileShader(shader);
+
+    /* Get status of the last compile operation on the shader object */
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &b_compile_ok);
+    if (b_compile_ok == GL_FALSE)
+    {
+        glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &log_len);
+        p_log = (char *)malloc(log_len);
+
+        /* Get the compile error of the shader object */
+        glGetShaderInfoLog(shader, log_len, NULL, p_log);
+        printf("Error: Failed to compile shader:\n%s\n", p_log);
+        free(p_log);
+
+        glDeleteShader(shader);
+        return 0;
+    }
+
+    return shader;
+}
+
+static void get_prog_cache_file(const char * p_vs_src, const char * p_fs_src,
+                                char * p_file, size_t size)
+{
+    uint64_t hash = UTIL_HASH_INIT;
+
+    const char * p_renderer = (const char *)glGetString(GL_RENDERER);
+    const char * p_version  = (const char *)glGetString(GL_VERSION);
+
+    /* Hash strings including their null terminators, so that the boundary
+     * between 2 strings also changes the hash */
+    hash = util_hash(hash, p_vs_src, strlen(p_vs_src) + 1);
+    hash = util_hash(hash, p_fs_src, strlen(p_fs_src) + 1);
+
+    if (p_renderer != NULL)
+    {
+        hash = util_hash(hash, p_renderer, strlen(p_renderer) + 1);
+    }
+
+    if (p_version != NULL)
+    {
+        hash = util_hash(hash, p_version, strlen(p_version) + 1);
+    }
+
+    snprintf(p_file, size, "%s/%016" PRIx64 ".bin", GL_PROG_CACHE_DIR, hash);
+}
+
+static GLuint load_prog_binary(const char * p_file)
+{
+    GLuint program = 0;
+    GLint b_link_ok = GL_FALSE;
+
+    char * p_data = NULL;
+    size_t size = 0;
+
+    GLenum format = 0;
+
+    /* Check parameter */
+    assert(p_file != NULL);
+
+    /* The file contains format of binary, followed by the binary itself */
+    p_data = util_read_bin_file(p_file, &size);
+    if (p_data == NULL)
+    {
+        return 0;
+    }
+
+    if (size <= sizeof(format))
+    {
+        free(p_data);
+        return 0;
+    }
+
+    memcpy(&format, p_data, sizeof(format));
+
+    /* Load binary into an empty program object */
+    program = glCreateProgram();
+    if (program != 0)
+    {
+        glProgramBinary(program, format, p_data + sizeof(format),
+                        size - sizeof(format));
+
+        /* Loading fails if the driver rejects the binary (for example,
+         * different build). Then, the program is compiled again */
+        glGetProgramiv(program, GL_LINK_STATUS, &b_link_ok);
+        if (b_link_ok == GL_FALSE)
+        {
+            glDeleteProgram(program);
+            program = 0;
+        }
+    }
+
+    free(p_data);
+
+    return program;
+}
+
+static void save_prog_binary(GLuint prog, const char * p_file)
+{
+    GLint format_count = 0;
+    GLint size = 0;
+
+    GLenum format = 0;
+    char * p_data = NULL;
+
+    /* Check parameter */
+    assert((prog != 0) && (p_file != NULL));
+
+    /* Binaries cannot be retrieved if the driver supports no formats */
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &format_count);
+    glGetProgramiv(prog, GL_PROGRAM_BINARY_LENGTH, &size);
+
+    if ((format_count <= 0) || (size <= 0))
+    {
+        return;
+    }
+
+    /* Create cache directory if it doesn't exist */
+    if ((mkdir(GL_PROG_CACHE_DIR, 0755) != 0) && (errno != EEXIST))
+    {
+        printf("Error: Failed to create '%s'\n", GL_PROG_CACHE_DIR);
+        return;
+    }
+
+    /* Store format of binary, followed by the binary itself */
+    p_data = (char *)malloc(sizeof(format) + size);
+
+    glGetProgramBinary(prog, size, &size, &format, p_data + sizeof(format));
+    memcpy(p_data, &format, sizeof(format));
+
+    util_write_file(p_file, p_data, sizeof(format) + size);
+    free(p_data);
+}
+
+static void apply_scaler(GLuint prog, GLenum target, gl_res_t res)
+{
+    const scaler_t * p_scaler = res.p_scaler;
+
+    /* Area of destination and region of texture, both as <vec2 offset,
+     * vec2 size> in normalized coordinates (see 'texture.vs.glsl') */
+    vec4 dst_area;
+    vec4 src_region;
+
+    /* Map a position inside destination area to a position inside region */
+    mat3 orientation;
+
+    gl_get_scaler_mapping(p_scaler, dst_area, src_region, orientation);
+
+    if (p_scaler != NULL)
+    {
+        glViewport(0, 0, p_scaler->dst_width, p_scaler->dst_height);
+
+        /* Interpolate texels when the region is resized (unless the
+         * source is sampled as packed YUYV, see 'scaler_t') */
+        glTexParameteri(target, GL_TEXTURE_MIN_FILTER, p_scaler->filter);
+        glTexParameteri(target, GL_TEXTURE_MAG_FILTER, p_scaler->filter);
+    }
+
+    glUniform4fv(glGetUniformLocation(prog, "dstArea"), 1, dst_area);
+    glUniform4fv(glGetUniformLocation(prog, "srcRegion"), 1, src_region);
+
+    glUniformMatrix3fv(glGetUniformLocation(prog, "orientation"), 1, GL_FALSE,
+                       (float *)orientation);
 
-    /* Disable blending */
-    glDisable(GL_BLEND);
+    /* Texture coordinates of a mesh already include all of the above */
+    glUniform1i(glGetUniformLocation(prog, "warped"), res.p_mesh != NULL);
 }
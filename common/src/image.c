@@ -0,0 +1,235 @@
+/* Copyright (c) 2023 Renesas Electronics Corp.
+ * SPDX-License-Identifier: MIT-0 */
+
+/*******************************************************************************
+ * FILENAME: image.c
+ *
+ * DESCRIPTION:
+ *   Image atlas function definition.
+ * 
+ * NOTE:
+ *   For function usage, please refer to 'image.h'.
+ * 
+ * AUTHOR: RVC       START DATE: 15/03/2023
+ *
+ ******************************************************************************/
+
+#include <png.h>
+#include <stdio.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "image.h"
+
+/******************************************************************************
+ *                            FUNCTION DEFINITION                             *
+ ******************************************************************************/
+
+image_atlas_t image_atlas_create(uint32_t width, uint32_t height)
+{
+    image_atlas_t atlas;
+
+    /* Check parameters */
+    assert((width > 0) && (height > 0));
+
+    memset(&atlas, 0, sizeof(atlas));
+
+    atlas.width  = width;
+    atlas.height = height;
+
+    /* Leave a gap at the top-left corner too */
+    atlas.pos_x = IMAGE_ATLAS_GAP;
+    atlas.pos_y = IMAGE_ATLAS_GAP;
+
+    /* Create an empty (transparent) texture */
+    atlas.tex = gl_create_rgba_texture(width, height, NULL);
+    if (atlas.tex == 0)
+    {
+        printf("Error: Failed to create texture of image atlas\n");
+        return atlas;
+    }
+
+    glBindTexture(GL_TEXTURE_2D, atlas.tex);
+
+    /* Images may be scaled when drawn */
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    /* Unbind texture */
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    return atlas;
+}
+
+void image_atlas_delete(image_atlas_t * p_atlas)
+{
+    /* Check parameter */
+    assert(p_atlas != NULL);
+
+    glDeleteTextures(1, &(p_atlas->tex));
+
+    p_atlas->tex   = 0;
+    p_atlas->count = 0;
+}
+
+int image_atlas_add_rgba(image_atlas_t * p_atlas, const uint8_t * p_data,
+                         uint32_t width, uint32_t height,
+                         uint32_t cols, uint32_t rows)
+{
+    image_t * p_image = NULL;
+    uint8_t * p_premul = NULL;
+
+    uint32_t index = 0;
+    uint32_t alpha = 0;
+
+    /* Check parameters */
+    assert((p_atlas != NULL) && (p_data != NULL));
+    assert((width > 0) && (height > 0) && (cols > 0) && (rows > 0));
+
+    if (p_atlas->count >= IMAGE_ATLAS_MAX_COUNT)
+    {
+        printf("Error: Image atlas cannot hold more than %d images\n",
+               IMAGE_ATLAS_MAX_COUNT);
+        return -1;
+    }
+
+    /* Move to next shelf if the image does not fit in the current one */
+    if ((p_atlas->pos_x + width + IMAGE_ATLAS_GAP) > p_atlas->width)
+    {
+        p_atlas->pos_x = IMAGE_ATLAS_GAP;
+        p_atlas->pos_y += p_atlas->shelf_height + IMAGE_ATLAS_GAP;
+
+        p_atlas->shelf_height = 0;
+    }
+
+    if (((p_atlas->pos_x + width + IMAGE_ATLAS_GAP) > p_atlas->width) ||
+        ((p_atlas->pos_y + height + IMAGE_ATLAS_GAP) > p_atlas->height))
+    {
+        printf("Error: No space for %dx%d image in atlas\n", width, height);
+        return -1;
+    }
+
+    /* Premultiply color by alpha, so that blending and linear filtering
+     * do not produce dark or bright fringes around transparent pixels */
+    p_premul = (uint8_t *)malloc(width * height * 4);
+
+    for (index = 0; index < (width * height); index++)
+    {
+        alpha = p_data[(index * 4) + 3];
+
+        p_premul[(index * 4) + 0] = (p_data[(index * 4) + 0] * alpha) / 255;
+        p_premul[(index * 4) + 1] = (p_data[(index * 4) + 1] * alpha) / 255;
+        p_premul[(index * 4) + 2] = (p_data[(index * 4) + 2] * alpha) / 255;
+        p_premul[(index * 4) + 3] = alpha;
+    }
+
+    /* Upload image once */
+    glBindTexture(GL_TEXTURE_2D, p_atlas->tex);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    glTexSubImage2D(GL_TEXTURE_2D, 0, p_atlas->pos_x, p_atlas->pos_y,
+                    width, height, GL_RGBA, GL_UNSIGNED_BYTE, p_premul);
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    free(p_premul);
+
+    /* Save location of image */
+    p_image = &(p_atlas->images[p_atlas->count]);
+
+    p_image->tex_left   = (float)p_atlas->pos_x / p_atlas->width;
+    p_image->tex_top    = (float)p_atlas->pos_y / p_atlas->height;
+    p_image->tex_right  = (float)(p_atlas->pos_x + width)  / p_atlas->width;
+    p_image->tex_bottom = (float)(p_atlas->pos_y + height) / p_atlas->height;
+
+    p_image->width  = width  / cols;
+    p_image->height = height / rows;
+    p_image->cols   = cols;
+    p_image->rows   = rows;
+
+    /* Move to the right of the image */
+    p_atlas->pos_x += width + IMAGE_ATLAS_GAP;
+
+    if (height > p_atlas->shelf_height)
+    {
+        p_atlas->shelf_height = height;
+    }
+
+    return (int)(p_atlas->count++);
+}
+
+int image_atlas_add_png(image_atlas_t * p_atlas, const char * p_file,
+                        uint32_t cols, uint32_t rows)
+{
+    int index = -1;
+
+    png_image png;
+    png_bytep p_data = NULL;
+
+    /* Check parameters */
+    assert((p_atlas != NULL) && (p_file != NULL));
+
+    memset(&png, 0, sizeof(png));
+    png.version = PNG_IMAGE_VERSION;
+
+    /* Read header of PNG file */
+    if (png_image_begin_read_from_file(&png, p_file) == 0)
+    {
+        printf("Error: Failed to open '%s': %s\n", p_file, png.message);
+        return -1;
+    }
+
+    /* Decode PNG file to RGBA pixels */
+    png.format = PNG_FORMAT_RGBA;
+    p_data = (png_bytep)malloc(PNG_IMAGE_SIZE(png));
+
+    if (png_image_finish_read(&png, NULL, p_data, 0, NULL) == 0)
+    {
+        printf("Error: Failed to decode '%s': %s\n", p_file, png.message);
+
+        free(p_data);
+        return -1;
+    }
+
+    index = image_atlas_add_rgba(p_atlas, p_data, png.width, png.height,
+                                 cols, rows);
+    free(p_data);
+
+    return index;
+}
+
+void image_get_frame_uv(const image_atlas_t * p_atlas, uint32_t index,
+                        uint32_t frame, float uv[4])
+{
+    const image_t * p_image = NULL;
+
+    float frame_u = 0.0f;
+    float frame_v = 0.0f;
+
+    /* Check parameters */
+    assert((p_atlas != NULL) && (index < p_atlas->count));
+
+    p_image = &(p_atlas->images[index]);
+
+    /* Wrap around, so that animations can just increase 'frame' */
+    frame %= (p_image->cols * p_image->rows);
+
+    /* Size of 1 frame in texture coordinates */
+    frame_u = (p_image->tex_right - p_image->tex_left) / p_image->cols;
+    frame_v = (p_image->tex_bottom - p_image->tex_top) / p_image->rows;
+
+    /* Offset of the frame inside the sprite sheet */
+    uv[0] = p_image->tex_left + ((frame % p_image->cols) * frame_u);
+    uv[1] = p_image->tex_top  + ((frame / p_image->cols) * frame_v);
+    uv[2] = uv[0] + frame_u;
+    uv[3] = uv[1] + frame_v;
+
+    /* Sample at centers of border texels, so that linear filtering does not
+     * read neighbor frames */
+    uv[0] += 0.5f / p_atlas->width;
+    uv[1] += 0.5f / p_atlas->height;
+    uv[2] -= 0.5f / p_atlas->width;
+    uv[3] -= 0.5f / p_atlas->height;
+}
@@ -0,0 +1,653 @@
+/* Copyright (c) 2023 Renesas Electronics Corp.
+ * SPDX-License-Identifier: MIT-0 */
+
+/*******************************************************************************
+ * FILENAME: ipc.c
+ *
+ * DESCRIPTION:
+ *   Shared-memory overlay command function definition.
+ *
+ * NOTE:
+ *   For function usage, please refer to 'ipc.h'.
+ *
+ * AUTHOR: RVC       START DATE: 15/03/2023
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "ipc.h"
+#include "util.h"
+
+/******************************************************************************
+ *                              MACRO VARIABLES                               *
+ ******************************************************************************/
+
+/* Size (in bytes) of the shared memory object */
+#define IPC_SHM_SIZE sizeof(ipc_shm_t)
+
+/* Access permissions of the shared memory object (only the user who runs
+ * the demo can publish commands) */
+#define IPC_SHM_MODE 0600
+
+/* Coordinates and sizes of commands must be within this value (in pixels).
+ * It keeps bounds of the list within 'int32_t' */
+#define IPC_COORD_LIMIT 65536.0f
+
+/* Extra area around estimated labels (relative to their size), which covers
+ * outline and shadow */
+#define IPC_LABEL_MARGIN 0.5f
+
+/******************************************************************************
+ *                        STATIC FUNCTION DECLARATION                         *
+ ******************************************************************************/
+
+/* Map shared memory object 'p_name' which was opened as 'fd'.
+ * Return NULL if failed */
+static ipc_t * map_shm(const char * p_name, int fd, bool b_owner);
+
+/* Copy timestamp (or the entire list if 'b_full' is true) of 'p_slot' to
+ * 'p_list', and its sequence number to 'p_seq'.
+ * Return false if the slot has never been written, or if it was being
+ * written during the copy (the copy is torn) */
+static bool read_slot(const ipc_slot_t * p_slot, ipc_list_t * p_list,
+                      bool b_full, uint32_t * p_seq);
+
+/* Return true if all values of 'p_cmd' are finite and within
+ * 'IPC_COORD_LIMIT', and its type and number of points are valid */
+static bool check_cmd(const ipc_cmd_t * p_cmd);
+
+/* Return true if 'value' is finite and within ['min', 'max'] */
+static bool check_value(float value, float min, float max);
+
+/* Return the absolute difference of 2 timestamps */
+static uint64_t get_distance(uint64_t a, uint64_t b);
+
+/******************************************************************************
+ *                            FUNCTION DEFINITION                             *
+ ******************************************************************************/
+
+ipc_t * ipc_create(const char * p_name, uint32_t width, uint32_t height)
+{
+    ipc_t * p_ipc = NULL;
+    int fd = -1;
+
+    /* Check parameters */
+    assert((p_name != NULL) && (width > 0) && (height > 0));
+
+    /* Remove the object of a previous run (its layout may be different) */
+    shm_unlink(p_name);
+
+    fd = shm_open(p_name, O_CREAT | O_EXCL | O_RDWR, IPC_SHM_MODE);
+    if (fd == -1)
+    {
+        util_print_errno();
+        printf("Error: Failed to create shared memory '%s'\n", p_name);
+        return NULL;
+    }
+
+    if (ftruncate(fd, IPC_SHM_SIZE) == -1)
+    {
+        util_print_errno();
+        printf("Error: Failed to resize shared memory '%s'\n", p_name);
+
+        close(fd);
+        shm_unlink(p_name);
+        return NULL;
+    }
+
+    p_ipc = map_shm(p_name, fd, true);
+    if (p_ipc == NULL)
+    {
+        shm_unlink(p_name);
+        return NULL;
+    }
+
+    /* 'ftruncate' fills the object with zeros, so all slots are empty */
+    p_ipc->p_shm->version = IPC_VERSION;
+    p_ipc->p_shm->width   = width;
+    p_ipc->p_shm->height  = height;
+
+    /* Publishers check 'magic' first, so it's written last */
+    __atomic_store_n(&(p_ipc->p_shm->magic), IPC_MAGIC, __ATOMIC_RELEASE);
+
+    return p_ipc;
+}
+
+ipc_t * ipc_open(const char * p_name)
+{
+    ipc_t * p_ipc = NULL;
+    struct stat info;
+    int fd = -1;
+
+    /* Check parameter */
+    assert(p_name != NULL);
+
+    fd = shm_open(p_name, O_RDWR, 0);
+    if (fd == -1)
+    {
+        util_print_errno();
+        printf("Error: Failed to open shared memory '%s'\n", p_name);
+        return NULL;
+    }
+
+    if ((fstat(fd, &info) == -1) || (info.st_size != IPC_SHM_SIZE))
+    {
+        printf("Error: Shared memory '%s' has a different size\n", p_name);
+
+        close(fd);
+        return NULL;
+    }
+
+    p_ipc = map_shm(p_name, fd, false);
+    if (p_ipc == NULL)
+    {
+        return NULL;
+    }
+
+    if ((__atomic_load_n(&(p_ipc->p_shm->magic), __ATOMIC_ACQUIRE) !=
+         IPC_MAGIC) || (p_ipc->p_shm->version != IPC_VERSION))
+    {
+        printf("Error: Shared memory '%s' has a different layout\n", p_name);
+
+        ipc_delete(p_ipc);
+        return NULL;
+    }
+
+    return p_ipc;
+}
+
+void ipc_delete(ipc_t * p_ipc)
+{
+    if (p_ipc == NULL)
+    {
+        return;
+    }
+
+    munmap(p_ipc->p_shm, IPC_SHM_SIZE);
+
+    if (p_ipc->b_owner)
+    {
+        shm_unlink(p_ipc->p_name);
+    }
+
+    free(p_ipc->p_name);
+    free(p_ipc);
+}
+
+void ipc_publish(ipc_t * p_ipc, const ipc_list_t * p_list)
+{
+    ipc_shm_t * p_shm = NULL;
+    ipc_slot_t * p_slot = NULL;
+
+    uint32_t count = 0;
+    uint32_t seq = 0;
+    uint32_t cmd_count = 0;
+
+    /* Check parameters */
+    assert((p_ipc != NULL) && (p_list != NULL));
+
+    p_shm = p_ipc->p_shm;
+
+    /* There is only 1 publisher, so nobody else changes these values */
+    count  = __atomic_load_n(&(p_shm->publish_count), __ATOMIC_RELAXED);
+    p_slot = &(p_shm->slots[count % IPC_SLOT_COUNT]);
+    seq    = __atomic_load_n(&(p_slot->seq), __ATOMIC_RELAXED);
+
+    /* Odd sequence number: readers discard what they copy from now on.
+     * The fence keeps the list from being written before it */
+    __atomic_store_n(&(p_slot->seq), seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    cmd_count = (p_list->count > IPC_MAX_CMDS) ? IPC_MAX_CMDS : p_list->count;
+
+    p_slot->list.timestamp_us   = p_list->timestamp_us;
+    p_slot->list.frame_sequence = p_list->frame_sequence;
+    p_slot->list.count          = cmd_count;
+
+    memcpy(p_slot->list.cmds, p_list->cmds, cmd_count * sizeof(ipc_cmd_t));
+
+    /* Even again: the list is complete. Then, it becomes the newest one */
+    __atomic_store_n(&(p_slot->seq), seq + 2, __ATOMIC_RELEASE);
+    __atomic_store_n(&(p_shm->publish_count), count + 1, __ATOMIC_RELEASE);
+}
+
+bool ipc_update(ipc_t * p_ipc, uint64_t timestamp_us, uint32_t sequence)
+{
+    ipc_shm_t * p_shm = NULL;
+
+    uint32_t count = 0;
+    uint32_t slot = 0;
+    uint32_t best_slot = 0;
+    uint32_t seq = 0;
+    uint32_t attempt = 0;
+    uint32_t index = 0;
+
+    uint64_t distance = 0;
+    uint64_t best_distance = UINT64_MAX;
+
+    bool b_read = false;
+    bool b_changed = false;
+
+    /* Check parameter */
+    assert(p_ipc != NULL);
+
+    p_shm = p_ipc->p_shm;
+
+    /* Tell publishers which frame is being drawn */
+    __atomic_store_n(&(p_shm->frame_timestamp_us), timestamp_us,
+                     __ATOMIC_RELAXED);
+    __atomic_store_n(&(p_shm->frame_sequence), sequence, __ATOMIC_RELAXED);
+
+    count = __atomic_load_n(&(p_shm->publish_count), __ATOMIC_ACQUIRE);
+
+    if (count > 0)
+    {
+        /* Look for the list of this frame (only timestamps are copied).
+         * Otherwise, take the newest one */
+        best_slot = (count - 1) % IPC_SLOT_COUNT;
+
+        for (slot = 0; slot < IPC_SLOT_COUNT; slot++)
+        {
+            if (!read_slot(&(p_shm->slots[slot]), &(p_ipc->scratch),
+                           false, &seq))
+            {
+                continue;
+            }
+
+            distance = get_distance(p_ipc->scratch.timestamp_us,
+                                    timestamp_us);
+
+            if ((distance <= IPC_MATCH_TOLERANCE_US) &&
+                (distance < best_distance))
+            {
+                best_slot     = slot;
+                best_distance = distance;
+            }
+        }
+
+        /* Copy the list unless it is the one which is already drawn */
+        if ((best_slot != p_ipc->last_slot) ||
+            (__atomic_load_n(&(p_shm->slots[best_slot].seq),
+                             __ATOMIC_ACQUIRE) != p_ipc->last_seq))
+        {
+            for (attempt = 0; attempt < IPC_READ_RETRIES; attempt++)
+            {
+                b_read = read_slot(&(p_shm->slots[best_slot]),
+                                   &(p_ipc->scratch), true, &seq);
+                if (b_read)
+                {
+                    break;
+                }
+            }
+
+            /* The publisher is too fast. Keep the previous list */
+            if (b_read)
+            {
+                p_ipc->last_slot = best_slot;
+                p_ipc->last_seq  = seq;
+
+                p_ipc->list.timestamp_us   = p_ipc->scratch.timestamp_us;
+                p_ipc->list.frame_sequence = p_ipc->scratch.frame_sequence;
+                p_ipc->list.count          = 0;
+
+                /* Commands come from another process. Skip invalid ones
+                 * (such as NaN or huge coordinates) */
+                for (index = 0; index < p_ipc->scratch.count; index++)
+                {
+                    if (check_cmd(&(p_ipc->scratch.cmds[index])))
+                    {
+                        p_ipc->list.cmds[p_ipc->list.count] =
+                            p_ipc->scratch.cmds[index];
+                        p_ipc->list.count++;
+                    }
+                }
+
+                b_changed = true;
+            }
+        }
+    }
+
+    /* Drop the list if the publisher has stopped */
+    if ((p_ipc->list.count > 0) &&
+        (timestamp_us > p_ipc->list.timestamp_us) &&
+        ((timestamp_us - p_ipc->list.timestamp_us) > IPC_MAX_AGE_US))
+    {
+        p_ipc->list.count = 0;
+        b_changed = true;
+    }
+
+    return b_changed;
+}
+
+rect_t ipc_get_bounds(const ipc_t * p_ipc)
+{
+    const ipc_cmd_t * p_cmd = NULL;
+    float height = 0.0f;
+
+    float left   = 0.0f;
+    float right  = 0.0f;
+    float bottom = 0.0f;
+    float top    = 0.0f;
+
+    /* Area of the current command (origin at the top-left corner) */
+    float cmd_left   = 0.0f;
+    float cmd_right  = 0.0f;
+    float cmd_top    = 0.0f;
+    float cmd_bottom = 0.0f;
+
+    rect_t bounds = { 0 };
+    bool b_empty = true;
+
+    uint32_t index = 0;
+    uint32_t point = 0;
+
+    /* Check parameter */
+    assert(p_ipc != NULL);
+
+    height = p_ipc->p_shm->height;
+
+    for (index = 0; index < p_ipc->list.count; index++)
+    {
+        p_cmd = &(p_ipc->list.cmds[index]);
+
+        switch (p_cmd->type)
+        {
+            case IPC_CMD_BOX:
+            {
+                cmd_left   = p_cmd->x - p_cmd->outline_width;
+                cmd_top    = p_cmd->y - p_cmd->outline_width;
+                cmd_right  = p_cmd->x + p_cmd->width + p_cmd->outline_width;
+                cmd_bottom = p_cmd->y + p_cmd->height + p_cmd->outline_width;
+            }
+            break;
+
+            case IPC_CMD_LABEL:
+            {
+                /* Glyphs are narrower than their size */
+                cmd_left   = p_cmd->x - (p_cmd->height * IPC_LABEL_MARGIN);
+                cmd_top    = p_cmd->y - (p_cmd->height *
+                                         (1.0f + IPC_LABEL_MARGIN));
+                cmd_right  = p_cmd->x + (p_cmd->height *
+                                         (strnlen(p_cmd->text,
+                                                  IPC_LABEL_MAX_LEN) +
+                                          IPC_LABEL_MARGIN));
+                cmd_bottom = p_cmd->y + (p_cmd->height *
+                                         (0.5f + IPC_LABEL_MARGIN));
+            }
+            break;
+
+            case IPC_CMD_MASK:
+            {
+                if (p_cmd->point_count == 0)
+                {
+                    continue;
+                }
+
+                cmd_left = cmd_right  = p_cmd->points[0][0];
+                cmd_top  = cmd_bottom = p_cmd->points[0][1];
+
+                for (point = 1; point < p_cmd->point_count; point++)
+                {
+                    cmd_left   = glm_min(cmd_left,   p_cmd->points[point][0]);
+                    cmd_right  = glm_max(cmd_right,  p_cmd->points[point][0]);
+                    cmd_top    = glm_min(cmd_top,    p_cmd->points[point][1]);
+                    cmd_bottom = glm_max(cmd_bottom, p_cmd->points[point][1]);
+                }
+            }
+            break;
+
+            default:
+            {
+                continue;
+            }
+            break;
+        }
+
+        /* Convert to origin at the bottom-left corner and merge */
+        if (b_empty)
+        {
+            left   = cmd_left;
+            right  = cmd_right;
+            bottom = height - cmd_bottom;
+            top    = height - cmd_top;
+        }
+        else
+        {
+            left   = glm_min(left,   cmd_left);
+            right  = glm_max(right,  cmd_right);
+            bottom = glm_min(bottom, height - cmd_bottom);
+            top    = glm_max(top,    height - cmd_top);
+        }
+
+        b_empty = false;
+    }
+
+    /* Round outwards, with 1 more pixel for antialiased edges */
+    if (!b_empty)
+    {
+        bounds.x      = (int32_t)floorf(left) - 1;
+        bounds.y      = (int32_t)floorf(bottom) - 1;
+        bounds.width  = (int32_t)ceilf(right) + 1 - bounds.x;
+        bounds.height = (int32_t)ceilf(top) + 1 - bounds.y;
+    }
+
+    return bounds;
+}
+
+void ipc_add_shapes(const ipc_t * p_ipc, batch_t * p_batch)
+{
+    const ipc_cmd_t * p_cmd = NULL;
+
+    /* Points of mask (origin at the bottom-left corner) */
+    float points[IPC_MAX_POINTS * 2];
+    color_t color;
+
+    float height = 0.0f;
+    uint32_t index = 0;
+    uint32_t point = 0;
+
+    /* Check parameters */
+    assert((p_ipc != NULL) && (p_batch != NULL));
+
+    height = p_ipc->p_shm->height;
+
+    for (index = 0; index < p_ipc->list.count; index++)
+    {
+        p_cmd = &(p_ipc->list.cmds[index]);
+
+        memcpy(color, p_cmd->color, sizeof(color));
+
+        if (p_cmd->type == IPC_CMD_BOX)
+        {
+            batch_add_rect(p_batch, p_cmd->x,
+                           height - p_cmd->y - p_cmd->height,
+                           p_cmd->width, p_cmd->height, 0.0f,
+                           color, p_cmd->opacity, p_cmd->outline_width);
+        }
+        else if (p_cmd->type == IPC_CMD_MASK)
+        {
+            for (point = 0; point < p_cmd->point_count; point++)
+            {
+                points[point * 2]       = p_cmd->points[point][0];
+                points[(point * 2) + 1] = height - p_cmd->points[point][1];
+            }
+
+            /* A polygon needs 3 points */
+            if (p_cmd->point_count >= 3)
+            {
+                batch_add_polygon(p_batch, points, p_cmd->point_count,
+                                  color, p_cmd->opacity, 0.0f);
+            }
+        }
+    }
+}
+
+void ipc_draw_labels(const ipc_t * p_ipc, GLuint prog,
+                     const text_style_t * p_style, gl_res_t res)
+{
+    const ipc_cmd_t * p_cmd = NULL;
+    text_style_t style;
+
+    /* Label which is always null-terminated */
+    char text[IPC_LABEL_MAX_LEN];
+
+    uint32_t index = 0;
+
+    /* Check parameters */
+    assert((p_ipc != NULL) && (prog != 0) && (p_style != NULL));
+
+    style = *p_style;
+
+    for (index = 0; index < p_ipc->list.count; index++)
+    {
+        p_cmd = &(p_ipc->list.cmds[index]);
+
+        if ((p_cmd->type != IPC_CMD_LABEL) || (p_cmd->height <= 0.0f))
+        {
+            continue;
+        }
+
+        memcpy(text, p_cmd->text, IPC_LABEL_MAX_LEN);
+        text[IPC_LABEL_MAX_LEN - 1] = '\0';
+
+        memcpy(style.color, p_cmd->color, sizeof(style.color));
+
+        gl_draw_sdf_text(prog, text, p_cmd->x,
+                         p_ipc->p_shm->height - p_cmd->y,
+                         p_cmd->height, &style, res);
+    }
+}
+
+/******************************************************************************
+ *                         STATIC FUNCTION DEFINITION                         *
+ ******************************************************************************/
+
+static ipc_t * map_shm(const char * p_name, int fd, bool b_owner)
+{
+    ipc_t * p_ipc = NULL;
+    void * p_addr = NULL;
+
+    p_addr = mmap(NULL, IPC_SHM_SIZE, PROT_READ | PROT_WRITE,
+                  MAP_SHARED, fd, 0);
+
+    /* The mapping stays valid after the file descriptor is closed */
+    close(fd);
+
+    if (p_addr == MAP_FAILED)
+    {
+        util_print_errno();
+        printf("Error: Failed to map shared memory '%s'\n", p_name);
+        return NULL;
+    }
+
+    p_ipc = (ipc_t *)calloc(1, sizeof(ipc_t));
+    assert(p_ipc != NULL);
+
+    p_ipc->p_shm   = (ipc_shm_t *)p_addr;
+    p_ipc->p_name  = strdup(p_name);
+    p_ipc->b_owner = b_owner;
+
+    /* No list has been copied yet */
+    p_ipc->last_slot = IPC_SLOT_COUNT;
+
+    return p_ipc;
+}
+
+static bool read_slot(const ipc_slot_t * p_slot, ipc_list_t * p_list,
+                      bool b_full, uint32_t * p_seq)
+{
+    uint32_t seq_begin = 0;
+    uint32_t seq_end = 0;
+
+    seq_begin = __atomic_load_n(&(p_slot->seq), __ATOMIC_ACQUIRE);
+
+    /* Never written, or being written */
+    if ((seq_begin == 0) || ((seq_begin & 1) != 0))
+    {
+        return false;
+    }
+
+    p_list->timestamp_us = p_slot->list.timestamp_us;
+
+    if (b_full)
+    {
+        p_list->frame_sequence = p_slot->list.frame_sequence;
+        p_list->count          = p_slot->list.count;
+
+        /* The count may be garbage if the copy is torn */
+        if (p_list->count > IPC_MAX_CMDS)
+        {
+            p_list->count = IPC_MAX_CMDS;
+        }
+
+        memcpy(p_list->cmds, p_slot->list.cmds,
+               p_list->count * sizeof(ipc_cmd_t));
+    }
+
+    /* The fence keeps the copy from being moved after the second load */
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    seq_end = __atomic_load_n(&(p_slot->seq), __ATOMIC_RELAXED);
+
+    *p_seq = seq_begin;
+
+    return (seq_begin == seq_end);
+}
+
+static bool check_cmd(const ipc_cmd_t * p_cmd)
+{
+    bool b_valid = true;
+    uint32_t index = 0;
+
+    if ((p_cmd->type != IPC_CMD_BOX) && (p_cmd->type != IPC_CMD_LABEL) &&
+        (p_cmd->type != IPC_CMD_MASK))
+    {
+        return false;
+    }
+
+    if (p_cmd->point_count > IPC_MAX_POINTS)
+    {
+        return false;
+    }
+
+    for (index = 0; index < 3; index++)
+    {
+        b_valid &= check_value(p_cmd->color[index], 0.0f, 1.0f);
+    }
+
+    b_valid &= check_value(p_cmd->opacity, 0.0f, 1.0f);
+    b_valid &= check_value(p_cmd->outline_width, 0.0f, IPC_COORD_LIMIT);
+
+    b_valid &= check_value(p_cmd->x, -IPC_COORD_LIMIT, IPC_COORD_LIMIT);
+    b_valid &= check_value(p_cmd->y, -IPC_COORD_LIMIT, IPC_COORD_LIMIT);
+    b_valid &= check_value(p_cmd->width,  0.0f, IPC_COORD_LIMIT);
+    b_valid &= check_value(p_cmd->height, 0.0f, IPC_COORD_LIMIT);
+
+    for (index = 0; index < p_cmd->point_count; index++)
+    {
+        b_valid &= check_value(p_cmd->points[index][0],
+                               -IPC_COORD_LIMIT, IPC_COORD_LIMIT);
+        b_valid &= check_value(p_cmd->points[index][1],
+                               -IPC_COORD_LIMIT, IPC_COORD_LIMIT);
+    }
+
+    return b_valid;
+}
+
+static bool check_value(float value, float min, float max)
+{
+    return isfinite(value) && (value >= min) && (value <= max);
+}
+
+static uint64_t get_distance(uint64_t a, uint64_t b)
+{
+    return (a > b) ? (a - b) : (b - a);
+}
@@ -0,0 +1,177 @@
+/* Copyright (c) 2023 Renesas Electronics Corp.
+ * SPDX-License-Identifier: MIT-0 */
+
+/*******************************************************************************
+ * FILENAME: lens.c
+ *
+ * DESCRIPTION:
+ *   Lens distortion correction function definition.
+ * 
+ * NOTE:
+ *   For function usage, please refer to 'lens.h'.
+ * 
+ * AUTHOR: RVC       START DATE: 15/03/2023
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <assert.h>
+#include <stdlib.h>
+
+#include "lens.h"
+
+/******************************************************************************
+ *                              MACRO VARIABLES                               *
+ ******************************************************************************/
+
+/* Number of vertices and indices of mesh (2 triangles per cell) */
+#define LENS_VERT_COUNT  ((LENS_MESH_COLS + 1) * (LENS_MESH_ROWS + 1))
+#define LENS_INDEX_COUNT (LENS_MESH_COLS * LENS_MESH_ROWS * 6)
+
+/******************************************************************************
+ *                            FUNCTION DEFINITION                             *
+ ******************************************************************************/
+
+mesh_t lens_create_mesh(float k1, float k2,
+                        const scaler_t * p_scaler, bool b_flip_y)
+{
+    mesh_t mesh = { 0 };
+
+    /* Vertices <vec2 pos, vec2 tex> and indices of mesh */
+    GLfloat  * p_verts = NULL;
+    GLushort * p_idxs  = NULL;
+
+    uint32_t col = 0;
+    uint32_t row = 0;
+    uint32_t vert = 0;
+    uint32_t idx = 0;
+
+    /* Mapping of scaler (see 'texture.vs.glsl') */
+    vec4 dst_area;
+    vec4 src_region;
+    mat3 orientation;
+
+    vec3 area_pos;
+    vec3 region_pos;
+
+    float u = 0.0f;
+    float v = 0.0f;
+    float x = 0.0f;
+    float y = 0.0f;
+    float r2 = 0.0f;
+    float scale = 0.0f;
+    float aspect = 0.0f;
+
+    /* Check parameter */
+    assert(p_scaler != NULL);
+
+    /* Vertices must fit in GL_UNSIGNED_SHORT indices */
+    assert(LENS_VERT_COUNT <= 65536);
+
+    p_verts = (GLfloat *)malloc(LENS_VERT_COUNT * 4 * sizeof(GLfloat));
+    p_idxs  = (GLushort *)malloc(LENS_INDEX_COUNT * sizeof(GLushort));
+
+    if ((p_verts == NULL) || (p_idxs == NULL))
+    {
+        printf("Error: Failed to allocate lens mesh\n");
+
+        free(p_verts);
+        free(p_idxs);
+
+        return mesh;
+    }
+
+    gl_get_scaler_mapping(p_scaler, dst_area, src_region, orientation);
+
+    /* Height of camera frame relative to its width */
+    aspect = (float)p_scaler->src_height / p_scaler->src_width;
+
+    for (row = 0; row <= LENS_MESH_ROWS; row++)
+    {
+        for (col = 0; col <= LENS_MESH_COLS; col++)
+        {
+            /* Position on destination (in texture coordinates of output
+             * image). 'texture.vs.glsl' gets it back from vertex position */
+            u = (float)col / LENS_MESH_COLS;
+            v = (float)row / LENS_MESH_ROWS;
+
+            p_verts[(4 * vert) + 0] = (2.0f * u) - 1.0f;
+            p_verts[(4 * vert) + 1] = b_flip_y ? 1.0f - (2.0f * v) :
+                                                 (2.0f * v) - 1.0f;
+
+            /* Corrected position in camera frame (as the scaler maps it) */
+            area_pos[0] = (u - dst_area[0]) / dst_area[2];
+            area_pos[1] = (v - dst_area[1]) / dst_area[3];
+            area_pos[2] = 1.0f;
+
+            glm_mat3_mulv(orientation, area_pos, region_pos);
+
+            x = src_region[0] + (region_pos[0] * src_region[2]);
+            y = src_region[1] + (region_pos[1] * src_region[3]);
+
+            /* Distort it (relative to the center, half width is 1) */
+            x = (x - 0.5f) * 2.0f;
+            y = (y - 0.5f) * 2.0f * aspect;
+
+            r2 = (x * x) + (y * y);
+            scale = 1.0f + (k1 * r2) + (k2 * r2 * r2);
+
+            p_verts[(4 * vert) + 2] = 0.5f + ((x * scale) / 2.0f);
+            p_verts[(4 * vert) + 3] = 0.5f + ((y * scale) / (2.0f * aspect));
+
+            vert++;
+        }
+    }
+
+    /* 2 triangles per cell */
+    for (row = 0; row < LENS_MESH_ROWS; row++)
+    {
+        for (col = 0; col < LENS_MESH_COLS; col++)
+        {
+            vert = (row * (LENS_MESH_COLS + 1)) + col;
+
+            p_idxs[idx++] = vert;
+            p_idxs[idx++] = vert + 1;
+            p_idxs[idx++] = vert + LENS_MESH_COLS + 2;
+
+            p_idxs[idx++] = vert + LENS_MESH_COLS + 2;
+            p_idxs[idx++] = vert + LENS_MESH_COLS + 1;
+            p_idxs[idx++] = vert;
+        }
+    }
+
+    /* Create vertex/index buffer objects and add data to it */
+    glGenBuffers(1, &(mesh.vbo));
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
+    glBufferData(GL_ARRAY_BUFFER, LENS_VERT_COUNT * 4 * sizeof(GLfloat),
+                 p_verts, GL_STATIC_DRAW);
+
+    glGenBuffers(1, &(mesh.ibo));
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ibo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, LENS_INDEX_COUNT * sizeof(GLushort),
+                 p_idxs, GL_STATIC_DRAW);
+
+    mesh.index_count = LENS_INDEX_COUNT;
+
+    /* Unbind buffers */
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    free(p_verts);
+    free(p_idxs);
+
+    return mesh;
+}
+
+void lens_delete_mesh(mesh_t * p_mesh)
+{
+    /* Check parameter */
+    assert(p_mesh != NULL);
+
+    glDeleteBuffers(1, &(p_mesh->vbo));
+    glDeleteBuffers(1, &(p_mesh->ibo));
+
+    p_mesh->vbo = 0;
+    p_mesh->ibo = 0;
+    p_mesh->index_count = 0;
+}
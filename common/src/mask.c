@@ -0,0 +1,741 @@
+/* Copyright (c) 2023 Renesas Electronics Corp.
+ * SPDX-License-Identifier: MIT-0 */
+
+/*******************************************************************************
+ * FILENAME: mask.c
+ *
+ * DESCRIPTION:
+ *   Privacy mask function definition.
+ *
+ * NOTE:
+ *   For function usage, please refer to 'mask.h'.
+ *
+ * AUTHOR: RVC       START DATE: 15/03/2023
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "mask.h"
+#include "util.h"
+
+/******************************************************************************
+ *                              MACRO VARIABLES                               *
+ ******************************************************************************/
+
+/* Max number of vertices of triangles of a polygon */
+#define MASK_MAX_TRIANGLE_VERTS ((MASK_MAX_POLYGON_VERTS - 2) * 3)
+
+/* Texels around a region which the blur filter samples (see 'blur.fs.glsl') */
+#define MASK_BLUR_MARGIN 5
+
+/******************************************************************************
+ *                              FUNCTION MACROS                               *
+ ******************************************************************************/
+
+/* Return the smaller or bigger of 2 values */
+#define MIN(A, B) (((A) < (B)) ? (A) : (B))
+#define MAX(A, B) (((A) > (B)) ? (A) : (B))
+
+/******************************************************************************
+ *                        STATIC FUNCTION DECLARATION                         *
+ ******************************************************************************/
+
+/* Read up to 'max_count' numbers from 'p_str' into 'p_nums'.
+ * Return the number of read numbers */
+static uint32_t parse_numbers(const char * p_str, float * p_nums,
+                              uint32_t max_count);
+
+/* Add polygon whose 'count' vertices are in 'p_points' { x0, y0, x1, y1...}
+ * to masks. Its triangles are written to 'p_verts' after 'vert_count'
+ * vertices. Return false if it cannot be added */
+static bool add_region(mask_t * p_mask, const float * p_points,
+                       uint32_t count, GLfloat * p_verts);
+
+/* Return twice the signed area of polygon whose 'count' vertices are in
+ * 'p_points'. It's positive if vertices are counter-clockwise */
+static float get_area(const float * p_points, uint32_t count);
+
+/* Split polygon into triangles (ear clipping) and write their vertices to
+ * 'p_tris'. Duplicate and collinear vertices are dropped. Return the number
+ * of vertices, or 0 if edges cross each other */
+static uint32_t triangulate(const float * p_points, uint32_t count,
+                            GLfloat * p_tris);
+
+/* Return cross product of (B - A) and (C - A), where A, B and C are vertices
+ * 'a', 'b' and 'c' of 'p_points' */
+static float cross(const float * p_points, uint32_t a, uint32_t b, uint32_t c);
+
+/* Draw triangles of all regions with 'prog' ('SHADER_PROG_MASK'). They
+ * sample the low resolution frame in texture unit 0, or they are white if
+ * 'b_coverage' is true */
+static void draw_regions(const mask_t * p_mask, GLuint prog, bool b_coverage,
+                         gl_res_t res);
+
+/* Limit rendering to the bounding box of all regions in low resolution
+ * frames, extended by 'margin' texels */
+static void set_work_scissor(const mask_t * p_mask, int32_t margin);
+
+/******************************************************************************
+ *                            FUNCTION DEFINITION                             *
+ ******************************************************************************/
+
+mask_t mask_create(uint32_t width, uint32_t height, const char * p_file)
+{
+    mask_t mask = { 0 };
+
+    char * p_content = NULL;
+    char * p_line    = NULL;
+    char * p_save    = NULL;
+    char * p_comment = NULL;
+
+    char keyword[16];
+    int offset = 0;
+
+    /* Numbers of a line (1 more than a polygon can have) */
+    float nums[(2 * MASK_MAX_POLYGON_VERTS) + 1];
+    uint32_t count = 0;
+
+    /* Corners of rectangle */
+    float corners[8];
+
+    /* Triangles of all regions */
+    GLfloat * p_verts = NULL;
+
+    uint32_t scale = 0;
+    uint32_t index = 0;
+
+    /* Right and top edges of bounding box of all regions */
+    int32_t right = 0;
+    int32_t top   = 0;
+
+    bool b_ok = true;
+
+    /* Check parameters */
+    assert((width > 0) && (height > 0) && (p_file != NULL));
+
+    mask.width  = width;
+    mask.height = height;
+    mask.style  = MASK_STYLE_PIXELATE;
+
+    p_content = util_read_file(p_file);
+    if (p_content == NULL)
+    {
+        printf("Error: Failed to read masks from '%s'\n", p_file);
+        return mask;
+    }
+
+    p_verts = (GLfloat *)malloc(MASK_MAX_REGIONS * MASK_MAX_TRIANGLE_VERTS *
+                                2 * sizeof(GLfloat));
+    assert(p_verts != NULL);
+
+    for (p_line = strtok_r(p_content, "\n", &p_save);
+         b_ok && (p_line != NULL);
+         p_line = strtok_r(NULL, "\n", &p_save))
+    {
+        /* Remove comment */
+        p_comment = strchr(p_line, '#');
+        if (p_comment != NULL)
+        {
+            *p_comment = '\0';
+        }
+
+        /* Skip empty line */
+        if (sscanf(p_line, "%15s%n", keyword, &offset) != 1)
+        {
+            continue;
+        }
+
+        count = parse_numbers(p_line + offset, nums,
+                              (2 * MASK_MAX_POLYGON_VERTS) + 1);
+
+        if (strcmp(keyword, "style") == 0)
+        {
+            if (strstr(p_line + offset, "blur") != NULL)
+            {
+                mask.style = MASK_STYLE_BLUR;
+            }
+            else if (strstr(p_line + offset, "pixelate") != NULL)
+            {
+                mask.style = MASK_STYLE_PIXELATE;
+            }
+            else
+            {
+                printf("Error: Style of masks must be pixelate or blur\n");
+                b_ok = false;
+            }
+        }
+        else if ((strcmp(keyword, "rect") == 0) && (count == 4) &&
+                 (nums[2] > 0.0f) && (nums[3] > 0.0f))
+        {
+            /* Counter-clockwise from the bottom-left corner */
+            corners[0] = nums[0];
+            corners[1] = nums[1];
+            corners[2] = nums[0] + nums[2];
+            corners[3] = nums[1];
+            corners[4] = nums[0] + nums[2];
+            corners[5] = nums[1] + nums[3];
+            corners[6] = nums[0];
+            corners[7] = nums[1] + nums[3];
+
+            b_ok = add_region(&mask, corners, 4, p_verts);
+        }
+        else if ((strcmp(keyword, "poly") == 0) && (count >= 6) &&
+                 (count <= 2 * MASK_MAX_POLYGON_VERTS) && ((count % 2) == 0))
+        {
+            b_ok = add_region(&mask, nums, count / 2, p_verts);
+        }
+        else
+        {
+            printf("Error: Invalid mask '%s'\n", p_line);
+            b_ok = false;
+        }
+    }
+
+    free(p_content);
+
+    if (b_ok && (mask.region_count == 0))
+    {
+        printf("Error: There is no mask in '%s'\n", p_file);
+        b_ok = false;
+    }
+
+    if (!b_ok)
+    {
+        free(p_verts);
+        return mask;
+    }
+
+    /* Get bounding box of all regions */
+    mask.area = mask.bounds[0];
+
+    for (index = 1; index < mask.region_count; index++)
+    {
+        right = MAX(mask.area.x + mask.area.width,
+                    mask.bounds[index].x + mask.bounds[index].width);
+        top   = MAX(mask.area.y + mask.area.height,
+                    mask.bounds[index].y + mask.bounds[index].height);
+
+        mask.area.x = MIN(mask.area.x, mask.bounds[index].x);
+        mask.area.y = MIN(mask.area.y, mask.bounds[index].y);
+
+        mask.area.width  = right - mask.area.x;
+        mask.area.height = top - mask.area.y;
+    }
+
+    /* Create vertex buffer of triangles */
+    glGenBuffers(1, &(mask.vbo));
+    glBindBuffer(GL_ARRAY_BUFFER, mask.vbo);
+    glBufferData(GL_ARRAY_BUFFER, mask.vert_count * 2 * sizeof(GLfloat),
+                 p_verts, GL_STATIC_DRAW);
+
+    /* Unbind buffer */
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    free(p_verts);
+
+    /* Create low resolution frames. Masked content needs no precision,
+     * so 16-bit RGB is enough */
+    scale = (mask.style == MASK_STYLE_BLUR) ? MASK_BLUR_SCALE :
+                                              MASK_PIXEL_SIZE;
+
+    mask.work_width  = (width + scale - 1) / scale;
+    mask.work_height = (height + scale - 1) / scale;
+
+    for (index = 0; index < 2; index++)
+    {
+        mask.texs[index] = gl_create_color_texture(mask.work_width,
+                                                   mask.work_height,
+                                                   GL_RGB565, NULL);
+        if (mask.texs[index] == 0)
+        {
+            printf("Error: Failed to create texture of masks\n");
+            break;
+        }
+
+        mask.fbs[index] = gl_create_framebuffer(GL_TEXTURE_2D,
+                                                mask.texs[index]);
+        if (mask.fbs[index] == 0)
+        {
+            printf("Error: Failed to create framebuffer of masks\n");
+            break;
+        }
+    }
+
+    if (index < 2)
+    {
+        mask_delete(&mask);
+    }
+
+    return mask;
+}
+
+void mask_delete(mask_t * p_mask)
+{
+    uint32_t index = 0;
+
+    /* Check parameter */
+    assert(p_mask != NULL);
+
+    for (index = 0; index < 2; index++)
+    {
+        glDeleteFramebuffers(1, &(p_mask->fbs[index]));
+        glDeleteTextures(1, &(p_mask->texs[index]));
+
+        p_mask->fbs[index]  = 0;
+        p_mask->texs[index] = 0;
+    }
+
+    glDeleteFramebuffers(1, &(p_mask->cover_fb));
+    glDeleteTextures(1, &(p_mask->cover_tex));
+
+    p_mask->cover_fb  = 0;
+    p_mask->cover_tex = 0;
+
+    glDeleteBuffers(1, &(p_mask->vbo));
+
+    p_mask->vbo        = 0;
+    p_mask->vert_count = 0;
+}
+
+void mask_update(mask_t * p_mask, GLuint src_prog, GLuint blur_prog,
+                 GLenum target, GLuint tex, gl_res_t res)
+{
+    scaler_t src_scaler;
+    scaler_t work_scaler;
+
+    gl_res_t work_res;
+
+    bool b_blur = false;
+
+    /* Check parameters */
+    assert((p_mask != NULL) && (src_prog != 0) && (tex != 0));
+    assert(res.p_scaler != NULL);
+
+    b_blur = (p_mask->style == MASK_STYLE_BLUR);
+    assert(!b_blur || (blur_prog != 0));
+
+    glEnable(GL_SCISSOR_TEST);
+
+    /* Render camera frame at low resolution, the same way as the conversion
+     * pass. It's drawn without 'SHADER_FLIP_Y', so its first row is the top
+     * of the image. The blur filter also needs texels around regions.
+     * All regions are covered by 1 draw call (each draw call waits for the
+     * GPU), and low resolution frames are small anyway */
+    src_scaler = *(res.p_scaler);
+    src_scaler.dst_width  = p_mask->work_width;
+    src_scaler.dst_height = p_mask->work_height;
+
+    res.p_scaler = &src_scaler;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, p_mask->fbs[0]);
+
+    set_work_scissor(p_mask, b_blur ? MASK_BLUR_MARGIN : 0);
+    gl_render_texture(src_prog, target, tex, res);
+
+    if (b_blur)
+    {
+        work_scaler = gl_init_scaler(p_mask->work_width, p_mask->work_height,
+                                     p_mask->work_width, p_mask->work_height,
+                                     false);
+
+        work_res = res;
+        work_res.p_scaler = &work_scaler;
+        work_res.p_mesh   = NULL;
+
+        /* Blur horizontally to the second frame. The vertical pass samples
+         * texels around regions, so they are blurred too */
+        glUseProgram(blur_prog);
+        glUniform2f(glGetUniformLocation(blur_prog, "blurStep"),
+                    1.0f / p_mask->work_width, 0.0f);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, p_mask->fbs[1]);
+
+        set_work_scissor(p_mask, MASK_BLUR_MARGIN);
+        gl_render_texture(blur_prog, GL_TEXTURE_2D,
+                          p_mask->texs[0], work_res);
+
+        /* Blur vertically back to the first frame */
+        glUseProgram(blur_prog);
+        glUniform2f(glGetUniformLocation(blur_prog, "blurStep"),
+                    0.0f, 1.0f / p_mask->work_height);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, p_mask->fbs[0]);
+
+        set_work_scissor(p_mask, 0);
+        gl_render_texture(blur_prog, GL_TEXTURE_2D,
+                          p_mask->texs[1], work_res);
+    }
+
+    glDisable(GL_SCISSOR_TEST);
+
+    /* Unbind framebuffer */
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    /* Blocks of pixelated regions keep sharp edges. Blurred regions are
+     * interpolated. Passes above may have changed the filter */
+    glBindTexture(GL_TEXTURE_2D, p_mask->texs[0]);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
+                    b_blur ? GL_LINEAR : GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER,
+                    b_blur ? GL_LINEAR : GL_NEAREST);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void mask_draw(const mask_t * p_mask, GLuint prog, gl_res_t res)
+{
+    /* Check parameters */
+    assert((p_mask != NULL) && (prog != 0));
+
+    /* Bind low resolution frame ('mask_update' has set its filter) */
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, p_mask->texs[0]);
+
+    draw_regions(p_mask, prog, false, res);
+
+    /* Unbind texture */
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+bool mask_draw_coverage(mask_t * p_mask, GLuint prog, gl_res_t res)
+{
+    GLint viewport[4];
+
+    /* Check parameters */
+    assert((p_mask != NULL) && (p_mask->vbo != 0) && (prog != 0));
+
+    /* Create R8 texture and framebuffer of coverage */
+    p_mask->cover_tex = gl_create_color_texture(p_mask->width, p_mask->height,
+                                                GL_R8, NULL);
+    if (p_mask->cover_tex != 0)
+    {
+        p_mask->cover_fb = gl_create_framebuffer(GL_TEXTURE_2D,
+                                                 p_mask->cover_tex);
+    }
+
+    if (p_mask->cover_fb == 0)
+    {
+        printf("Error: Failed to create coverage of masks\n");
+        return false;
+    }
+
+    glGetIntegerv(GL_VIEWPORT, viewport);
+
+    /* Clear coverage, then draw triangles of all regions */
+    glBindFramebuffer(GL_FRAMEBUFFER, p_mask->cover_fb);
+    glViewport(0, 0, p_mask->width, p_mask->height);
+
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    draw_regions(p_mask, prog, true, res);
+
+    /* Unbind framebuffer and restore viewport */
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+
+    return true;
+}
+
+/******************************************************************************
+ *                         STATIC FUNCTION DEFINITION                         *
+ ******************************************************************************/
+
+static uint32_t parse_numbers(const char * p_str, float * p_nums,
+                              uint32_t max_count)
+{
+    uint32_t count = 0;
+    char * p_end = NULL;
+
+    while (count < max_count)
+    {
+        p_nums[count] = strtof(p_str, &p_end);
+
+        /* Stop at the end of line or at something which is not a number */
+        if (p_end == p_str)
+        {
+            break;
+        }
+
+        p_str = p_end;
+        count++;
+    }
+
+    return count;
+}
+
+static bool add_region(mask_t * p_mask, const float * p_points,
+                       uint32_t count, GLfloat * p_verts)
+{
+    uint32_t vert_count = 0;
+    uint32_t index = 0;
+
+    float left   = p_points[0];
+    float bottom = p_points[1];
+    float right  = p_points[0];
+    float top    = p_points[1];
+
+    rect_t * p_box = NULL;
+
+    if (p_mask->region_count == MASK_MAX_REGIONS)
+    {
+        printf("Error: There are more than %d masks\n", MASK_MAX_REGIONS);
+        return false;
+    }
+
+    if (get_area(p_points, count) == 0.0f)
+    {
+        printf("Error: Mask %u has no area (all vertices are collinear)\n",
+               p_mask->region_count);
+        return false;
+    }
+
+    vert_count = triangulate(p_points, count,
+                             p_verts + (p_mask->vert_count * 2));
+    if (vert_count == 0)
+    {
+        printf("Error: Edges of mask %u cross each other\n",
+               p_mask->region_count);
+        return false;
+    }
+
+    p_mask->vert_count += vert_count;
+
+    /* Get bounding box of polygon and clip it to the output */
+    for (index = 1; index < count; index++)
+    {
+        left   = MIN(left,   p_points[2 * index]);
+        bottom = MIN(bottom, p_points[(2 * index) + 1]);
+        right  = MAX(right,  p_points[2 * index]);
+        top    = MAX(top,    p_points[(2 * index) + 1]);
+    }
+
+    left   = MAX(floorf(left), 0.0f);
+    bottom = MAX(floorf(bottom), 0.0f);
+    right  = MIN(ceilf(right), (float)p_mask->width);
+    top    = MIN(ceilf(top), (float)p_mask->height);
+
+    p_box = &(p_mask->bounds[p_mask->region_count]);
+
+    p_box->x      = left;
+    p_box->y      = bottom;
+    p_box->width  = MAX(right - left, 0.0f);
+    p_box->height = MAX(top - bottom, 0.0f);
+
+    p_mask->region_count++;
+
+    return true;
+}
+
+static uint32_t triangulate(const float * p_points, uint32_t count,
+                            GLfloat * p_tris)
+{
+    /* Vertices which are not clipped yet */
+    uint32_t idxs[MASK_MAX_POLYGON_VERTS];
+    uint32_t remaining = count;
+
+    /* Twice the signed area. It's positive if vertices are counter-clockwise
+     * (and 0 if polygon has no area) */
+    float area = get_area(p_points, count);
+
+    uint32_t vert_count = 0;
+    uint32_t index = 0;
+    uint32_t other = 0;
+    uint32_t prev  = 0;
+    uint32_t cur   = 0;
+    uint32_t next  = 0;
+    uint32_t tri   = 0;
+
+    uint32_t tri_idxs[3];
+
+    bool b_ear = false;
+
+    for (index = 0; index < count; index++)
+    {
+        idxs[index] = index;
+    }
+
+    if (area == 0.0f)
+    {
+        return 0;
+    }
+
+    while (remaining >= 3)
+    {
+        /* Drop duplicate and collinear vertices. They add no area, but they
+         * are never convex, so they could leave no ear to clip */
+        index = 0;
+        while ((index < remaining) && (remaining >= 3))
+        {
+            prev = idxs[(index + remaining - 1) % remaining];
+            cur  = idxs[index];
+            next = idxs[(index + 1) % remaining];
+
+            if (cross(p_points, prev, cur, next) == 0.0f)
+            {
+                memmove(&(idxs[index]), &(idxs[index + 1]),
+                        (remaining - index - 1) * sizeof(uint32_t));
+                remaining--;
+
+                /* Neighbours of the dropped vertex may be collinear now */
+                index = 0;
+            }
+            else
+            {
+                index++;
+            }
+        }
+
+        if (remaining < 3)
+        {
+            break;
+        }
+
+        /* The last triangle is always clipped */
+        b_ear = (remaining == 3);
+
+        for (index = 0; (index < remaining) && !b_ear; index++)
+        {
+            prev = idxs[(index + remaining - 1) % remaining];
+            cur  = idxs[index];
+            next = idxs[(index + 1) % remaining];
+
+            /* An ear is convex... */
+            b_ear = ((cross(p_points, prev, cur, next) * area) > 0.0f);
+
+            /* ...and has no other vertex inside it */
+            for (other = 0; (other < remaining) && b_ear; other++)
+            {
+                if ((idxs[other] == prev) || (idxs[other] == cur) ||
+                    (idxs[other] == next))
+                {
+                    continue;
+                }
+
+                b_ear = !(((cross(p_points, prev, cur, idxs[other]) *
+                            area) >= 0.0f) &&
+                          ((cross(p_points, cur, next, idxs[other]) *
+                            area) >= 0.0f) &&
+                          ((cross(p_points, next, prev, idxs[other]) *
+                            area) >= 0.0f));
+            }
+        }
+
+        if (!b_ear)
+        {
+            return 0;
+        }
+
+        /* Index of the ear ('index' is 1 past it, or 0 for the last one) */
+        index = (remaining == 3) ? 1 : index;
+
+        tri_idxs[0] = idxs[(index + remaining - 2) % remaining];
+        tri_idxs[1] = idxs[index - 1];
+        tri_idxs[2] = idxs[index % remaining];
+
+        for (tri = 0; tri < 3; tri++)
+        {
+            p_tris[(2 * vert_count)]     = p_points[2 * tri_idxs[tri]];
+            p_tris[(2 * vert_count) + 1] = p_points[(2 * tri_idxs[tri]) + 1];
+            vert_count++;
+        }
+
+        /* Clip the ear */
+        memmove(&(idxs[index - 1]), &(idxs[index]),
+                (remaining - index) * sizeof(uint32_t));
+        remaining--;
+    }
+
+    return vert_count;
+}
+
+static float get_area(const float * p_points, uint32_t count)
+{
+    float area = 0.0f;
+
+    uint32_t index = 0;
+    uint32_t next  = 0;
+
+    for (index = 0; index < count; index++)
+    {
+        next = (index + 1) % count;
+        area += (p_points[2 * index] * p_points[(2 * next) + 1]) -
+                (p_points[2 * next] * p_points[(2 * index) + 1]);
+    }
+
+    return area;
+}
+
+static float cross(const float * p_points, uint32_t a, uint32_t b, uint32_t c)
+{
+    float ab_x = p_points[2 * b] - p_points[2 * a];
+    float ab_y = p_points[(2 * b) + 1] - p_points[(2 * a) + 1];
+    float ac_x = p_points[2 * c] - p_points[2 * a];
+    float ac_y = p_points[(2 * c) + 1] - p_points[(2 * a) + 1];
+
+    return (ab_x * ac_y) - (ab_y * ac_x);
+}
+
+static void draw_regions(const mask_t * p_mask, GLuint prog, bool b_coverage,
+                         gl_res_t res)
+{
+    mat4 projection_mat;
+
+    /* Use program object for drawing masks */
+    glUseProgram(prog);
+
+    /* Set uniform variables */
+    gl_get_projection_matrix(res, projection_mat);
+
+    glUniformMatrix4fv(glGetUniformLocation(prog, "projection"),
+                       1, GL_FALSE, projection_mat[0]);
+
+    glUniform2f(glGetUniformLocation(prog, "frameSize"),
+                p_mask->width, p_mask->height);
+
+    glUniform1i(glGetUniformLocation(prog, "maskTexture"), 0);
+    glUniform1i(glGetUniformLocation(prog, "coverage"), b_coverage);
+
+    /* Enable attribute 0 since it's disabled by default */
+    glEnableVertexAttribArray(0);
+
+    /* Show OpenGL ES how the vertex array should be interpreted */
+    glBindBuffer(GL_ARRAY_BUFFER, p_mask->vbo);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE,
+                          2 * sizeof(GLfloat), (void *)0);
+
+    /* Draw triangles of all regions */
+    glDrawArrays(GL_TRIANGLES, 0, p_mask->vert_count);
+
+    /* Unbind VBO buffer */
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    /* Disable attribute */
+    glDisableVertexAttribArray(0);
+}
+
+static void set_work_scissor(const mask_t * p_mask, int32_t margin)
+{
+    const rect_t * p_box = &(p_mask->area);
+
+    /* Low resolution frames start with the top row of the image, but
+     * bounding boxes start with the bottom row */
+    int32_t top = p_mask->height - (p_box->y + p_box->height);
+
+    /* Bounding box in texels (rounded outward) */
+    int32_t left   = (p_box->x * p_mask->work_width) / p_mask->width;
+    int32_t first  = (top * p_mask->work_height) / p_mask->height;
+    int32_t right  = (((p_box->x + p_box->width) * p_mask->work_width) +
+                      p_mask->width - 1) / p_mask->width;
+    int32_t last   = (((top + p_box->height) * p_mask->work_height) +
+                      p_mask->height - 1) / p_mask->height;
+
+    glScissor(left - margin, first - margin,
+              (right - left) + (2 * margin), (last - first) + (2 * margin));
+}
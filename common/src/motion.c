@@ -0,0 +1,369 @@
+/* Copyright (c) 2023 Renesas Electronics Corp.
+ * SPDX-License-Identifier: MIT-0 */
+
+/*******************************************************************************
+ * FILENAME: motion.c
+ *
+ * DESCRIPTION:
+ *   Motion detection function definition.
+ *
+ * NOTE:
+ *   For function usage, please refer to 'motion.h'.
+ *
+ * AUTHOR: RVC       START DATE: 15/03/2023
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+
+#include "motion.h"
+
+/******************************************************************************
+ *                              MACRO VARIABLES                               *
+ ******************************************************************************/
+
+/* Size (in pixels of luma frame) of a cell */
+#define MOTION_CELL_WIDTH  (MOTION_WIDTH / MOTION_GRID_COLS)
+#define MOTION_CELL_HEIGHT (MOTION_HEIGHT / MOTION_GRID_ROWS)
+
+/* Size (in bytes) of luma frame read by the CPU (RGBA) */
+#define MOTION_FRAME_SIZE (MOTION_WIDTH * MOTION_HEIGHT * 4)
+
+/* Timeout (in nanoseconds) of each wait for fence */
+#define MOTION_WAIT_TIMEOUT_NS 1000000
+
+/******************************************************************************
+ *                        STATIC FUNCTION DECLARATION                         *
+ ******************************************************************************/
+
+/* Read result of the oldest pixel buffer object.
+ * If 'b_wait' is false, return false if the GPU has not finished it yet.
+ * Otherwise, wait for it. Return true if the result is updated */
+static bool read_result(motion_t * p_motion, bool b_wait);
+
+/* Count changed pixels of luma frame 'p_pixels' (RGBA) and update result */
+static void analyze(motion_t * p_motion, const uint8_t * p_pixels);
+
+/******************************************************************************
+ *                            FUNCTION DEFINITION                             *
+ ******************************************************************************/
+
+motion_t motion_create(void)
+{
+    motion_t motion = { 0 };
+    uint32_t index = 0;
+
+    /* Create RGBA textures and framebuffers */
+    for (index = 0; index < 2; index++)
+    {
+        motion.texs[index] = gl_create_color_texture(MOTION_WIDTH,
+                                                     MOTION_HEIGHT,
+                                                     GL_RGBA8, NULL);
+        if (motion.texs[index] == 0)
+        {
+            printf("Error: Failed to create texture of motion detection\n");
+            break;
+        }
+
+        motion.fbs[index] = gl_create_framebuffer(GL_TEXTURE_2D,
+                                                  motion.texs[index]);
+        if (motion.fbs[index] == 0)
+        {
+            printf("Error: Failed to create framebuffer of "
+                   "motion detection\n");
+            break;
+        }
+    }
+
+    if (index < 2)
+    {
+        motion_delete(&motion);
+        return motion;
+    }
+
+    /* Create pixel buffer objects. They are only read by the CPU */
+    glGenBuffers(MOTION_READBACK_COUNT, motion.pbos);
+
+    for (index = 0; index < MOTION_READBACK_COUNT; index++)
+    {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, motion.pbos[index]);
+        glBufferData(GL_PIXEL_PACK_BUFFER, MOTION_FRAME_SIZE,
+                     NULL, GL_STREAM_READ);
+    }
+
+    /* Unbind buffer */
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    return motion;
+}
+
+void motion_delete(motion_t * p_motion)
+{
+    uint32_t index = 0;
+
+    /* Check parameter */
+    assert(p_motion != NULL);
+
+    for (index = 0; index < MOTION_READBACK_COUNT; index++)
+    {
+        if (p_motion->fences[index] != NULL)
+        {
+            glDeleteSync(p_motion->fences[index]);
+            p_motion->fences[index] = NULL;
+        }
+
+        glDeleteBuffers(1, &(p_motion->pbos[index]));
+        p_motion->pbos[index] = 0;
+    }
+
+    for (index = 0; index < 2; index++)
+    {
+        glDeleteFramebuffers(1, &(p_motion->fbs[index]));
+        glDeleteTextures(1, &(p_motion->texs[index]));
+
+        p_motion->fbs[index]  = 0;
+        p_motion->texs[index] = 0;
+    }
+
+    p_motion->pending = 0;
+}
+
+bool motion_update(motion_t * p_motion, GLuint prog,
+                   GLenum target, GLuint tex, gl_res_t res)
+{
+    scaler_t scaler;
+
+    /* Write to one texture while reading the other (ping-pong) */
+    uint32_t cur  = 0;
+    uint32_t prev = 0;
+
+    GLenum targets[2] = { 0, GL_TEXTURE_2D };
+    GLuint texs[2]    = { 0, 0 };
+
+    uint32_t slot = 0;
+    bool b_updated = false;
+
+    /* Check parameters */
+    assert((p_motion != NULL) && (prog != 0) && (tex != 0));
+    assert(res.p_scaler != NULL);
+
+    cur  = p_motion->frame % 2;
+    prev = 1 - cur;
+
+    /* Camera frame from texture unit 0 and previous frame from unit 1 */
+    targets[0] = target;
+    texs[0]    = tex;
+    texs[1]    = p_motion->texs[prev];
+
+    glUseProgram(prog);
+    glUniform1i(glGetUniformLocation(prog, "yuyvTexture"), 0);
+    glUniform1i(glGetUniformLocation(prog, "historyTexture"), 1);
+
+    /* There is no previous frame at the first frame */
+    glUniform1i(glGetUniformLocation(prog, "firstFrame"),
+                p_motion->frame == 0);
+
+    /* Render luma frame with the crop, scaling and lens correction of the
+     * conversion pass, so cells match the output. It's drawn without
+     * 'SHADER_FLIP_Y', so its first row is the top of the image */
+    scaler = *(res.p_scaler);
+    scaler.dst_width  = MOTION_WIDTH;
+    scaler.dst_height = MOTION_HEIGHT;
+
+    /* Only luma is used, so texels can be interpolated even if the camera
+     * frame is sampled as packed YUYV (see 'scaler_t') */
+    scaler.filter = GL_LINEAR;
+
+    res.p_scaler = &scaler;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, p_motion->fbs[cur]);
+
+    gl_render_textures(prog, targets, texs, 2, res);
+
+    /* All buffers are in use. The oldest one was copied
+     * 'MOTION_READBACK_COUNT' frames ago, so this normally does not block */
+    if (p_motion->pending == MOTION_READBACK_COUNT)
+    {
+        b_updated = read_result(p_motion, true);
+    }
+
+    /* Copy luma frame to the next buffer. With a pixel buffer object bound,
+     * 'glReadPixels' returns without waiting for the GPU */
+    slot = (p_motion->first + p_motion->pending) % MOTION_READBACK_COUNT;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, p_motion->pbos[slot]);
+    glReadPixels(0, 0, MOTION_WIDTH, MOTION_HEIGHT,
+                 GL_RGBA, GL_UNSIGNED_BYTE, (void *)0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    p_motion->fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    p_motion->pbo_frames[slot] = p_motion->frame;
+    p_motion->pending++;
+
+    /* Unbind framebuffer */
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    p_motion->frame++;
+
+    /* Read all results which are ready (the newest one is normally not) */
+    while ((p_motion->pending > 0) && read_result(p_motion, false))
+    {
+        b_updated = true;
+    }
+
+    return b_updated;
+}
+
+bool motion_is_cell_moving(const motion_t * p_motion,
+                           uint32_t col, uint32_t row)
+{
+    /* Check parameters */
+    assert(p_motion != NULL);
+    assert((col < MOTION_GRID_COLS) && (row < MOTION_GRID_ROWS));
+
+    return ((p_motion->grid[row] >> col) & 1) != 0;
+}
+
+rect_t motion_get_cell_rect(uint32_t col, uint32_t row,
+                            uint32_t width, uint32_t height)
+{
+    rect_t rect;
+
+    /* Check parameters */
+    assert((col < MOTION_GRID_COLS) && (row < MOTION_GRID_ROWS));
+
+    /* Edges are rounded the same way for neighbouring cells, so there is no
+     * gap between them. Row 0 is at the top */
+    rect.x      = (col * width) / MOTION_GRID_COLS;
+    rect.width  = (((col + 1) * width) / MOTION_GRID_COLS) - rect.x;
+    rect.y      = height - (((row + 1) * height) / MOTION_GRID_ROWS);
+    rect.height = (height - ((row * height) / MOTION_GRID_ROWS)) - rect.y;
+
+    return rect;
+}
+
+void motion_write_result(const motion_t * p_motion, FILE * p_file)
+{
+    uint32_t row = 0;
+
+    /* Check parameters */
+    assert((p_motion != NULL) && (p_file != NULL));
+
+    fprintf(p_file, "%u %.3f", p_motion->result_frame, p_motion->score);
+
+    for (row = 0; row < MOTION_GRID_ROWS; row++)
+    {
+        fprintf(p_file, " %04x", p_motion->grid[row]);
+    }
+
+    fprintf(p_file, "\n");
+    fflush(p_file);
+}
+
+/******************************************************************************
+ *                         STATIC FUNCTION DEFINITION                         *
+ ******************************************************************************/
+
+static bool read_result(motion_t * p_motion, bool b_wait)
+{
+    uint32_t slot = p_motion->first;
+    GLenum status = GL_WAIT_FAILED;
+
+    const uint8_t * p_pixels = NULL;
+
+    if (b_wait)
+    {
+        while (glClientWaitSync(p_motion->fences[slot],
+                                GL_SYNC_FLUSH_COMMANDS_BIT,
+                                MOTION_WAIT_TIMEOUT_NS) == GL_TIMEOUT_EXPIRED)
+        {
+            /* Wait until the GPU catches up */
+        }
+    }
+    else
+    {
+        /* Only check the fence */
+        status = glClientWaitSync(p_motion->fences[slot], 0, 0);
+
+        if ((status != GL_ALREADY_SIGNALED) &&
+            (status != GL_CONDITION_SATISFIED))
+        {
+            return false;
+        }
+    }
+
+    glDeleteSync(p_motion->fences[slot]);
+    p_motion->fences[slot] = NULL;
+
+    /* Read luma frame */
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, p_motion->pbos[slot]);
+
+    p_pixels = (const uint8_t *)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0,
+                                                 MOTION_FRAME_SIZE,
+                                                 GL_MAP_READ_BIT);
+    if (p_pixels != NULL)
+    {
+        analyze(p_motion, p_pixels);
+        p_motion->result_frame = p_motion->pbo_frames[slot];
+
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    else
+    {
+        printf("Error: Failed to read result of motion detection\n");
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    /* The buffer can be reused */
+    p_motion->first = (slot + 1) % MOTION_READBACK_COUNT;
+    p_motion->pending--;
+
+    return (p_pixels != NULL);
+}
+
+static void analyze(motion_t * p_motion, const uint8_t * p_pixels)
+{
+    /* The number of changed pixels of each cell and of the entire frame */
+    uint32_t counts[MOTION_GRID_ROWS][MOTION_GRID_COLS];
+    uint32_t total = 0;
+
+    uint32_t x = 0;
+    uint32_t y = 0;
+    uint32_t col = 0;
+    uint32_t row = 0;
+
+    memset(counts, 0, sizeof(counts));
+
+    /* Difference from previous frame is in the green channel */
+    for (y = 0; y < MOTION_HEIGHT; y++)
+    {
+        for (x = 0; x < MOTION_WIDTH; x++)
+        {
+            if (p_pixels[(((y * MOTION_WIDTH) + x) * 4) + 1] >
+                MOTION_PIXEL_THRESHOLD)
+            {
+                counts[y / MOTION_CELL_HEIGHT][x / MOTION_CELL_WIDTH]++;
+                total++;
+            }
+        }
+    }
+
+    p_motion->score = (float)total / (MOTION_WIDTH * MOTION_HEIGHT);
+
+    for (row = 0; row < MOTION_GRID_ROWS; row++)
+    {
+        p_motion->grid[row] = 0;
+
+        for (col = 0; col < MOTION_GRID_COLS; col++)
+        {
+            if (counts[row][col] >= (MOTION_CELL_THRESHOLD *
+                                     MOTION_CELL_WIDTH * MOTION_CELL_HEIGHT))
+            {
+                p_motion->grid[row] |= (1 << col);
+            }
+        }
+    }
+}
@@ -0,0 +1,195 @@
+/* Copyright (c) 2023 Renesas Electronics Corp.
+ * SPDX-License-Identifier: MIT-0 */
+
+/*******************************************************************************
+ * FILENAME: overlay.c
+ *
+ * DESCRIPTION:
+ *   Persistent overlay layer function definition.
+ * 
+ * NOTE:
+ *   For function usage, please refer to 'overlay.h'.
+ * 
+ * AUTHOR: RVC       START DATE: 15/03/2023
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <assert.h>
+
+#include "overlay.h"
+
+/******************************************************************************
+ *                              FUNCTION MACROS                               *
+ ******************************************************************************/
+
+/* Return the smaller or bigger of 2 values */
+#define MIN(A, B) (((A) < (B)) ? (A) : (B))
+#define MAX(A, B) (((A) > (B)) ? (A) : (B))
+
+/******************************************************************************
+ *                            FUNCTION DEFINITION                             *
+ ******************************************************************************/
+
+overlay_t overlay_create(uint32_t width, uint32_t height, GLenum format)
+{
+    overlay_t overlay = { 0 };
+
+    /* Check parameters */
+    assert((width > 0) && (height > 0));
+    assert(format != GL_RGB565);
+
+    overlay.width  = width;
+    overlay.height = height;
+    overlay.format = format;
+
+    /* Create RGBA texture */
+    overlay.tex = gl_create_color_texture(width, height,
+                                          format, &(overlay.size));
+    if (overlay.tex == 0)
+    {
+        printf("Error: Failed to create texture of overlay\n");
+        return overlay;
+    }
+
+    /* Create framebuffer */
+    overlay.fb = gl_create_framebuffer(GL_TEXTURE_2D, overlay.tex);
+    if (overlay.fb == 0)
+    {
+        printf("Error: Failed to create framebuffer of overlay\n");
+
+        glDeleteTextures(1, &(overlay.tex));
+        overlay.tex = 0;
+
+        return overlay;
+    }
+
+    /* Nothing is drawn yet. So, the entire overlay must be drawn */
+    overlay_invalidate_all(&overlay);
+
+    return overlay;
+}
+
+void overlay_delete(overlay_t * p_overlay)
+{
+    /* Check parameter */
+    assert(p_overlay != NULL);
+
+    glDeleteFramebuffers(1, &(p_overlay->fb));
+    glDeleteTextures(1, &(p_overlay->tex));
+
+    p_overlay->fb  = 0;
+    p_overlay->tex = 0;
+}
+
+void overlay_invalidate(overlay_t * p_overlay, rect_t rect)
+{
+    int32_t left   = 0;
+    int32_t bottom = 0;
+    int32_t right  = 0;
+    int32_t top    = 0;
+
+    /* Check parameter */
+    assert(p_overlay != NULL);
+
+    /* Clip 'rect' to the overlay */
+    left   = MAX(rect.x, 0);
+    bottom = MAX(rect.y, 0);
+    right  = MIN(rect.x + rect.width,  (int32_t)p_overlay->width);
+    top    = MIN(rect.y + rect.height, (int32_t)p_overlay->height);
+
+    if ((right <= left) || (top <= bottom))
+    {
+        return;
+    }
+
+    /* Merge it with the current dirty box */
+    if (overlay_is_dirty(p_overlay))
+    {
+        left   = MIN(left,   p_overlay->dirty.x);
+        bottom = MIN(bottom, p_overlay->dirty.y);
+        right  = MAX(right,  p_overlay->dirty.x + p_overlay->dirty.width);
+        top    = MAX(top,    p_overlay->dirty.y + p_overlay->dirty.height);
+    }
+
+    p_overlay->dirty.x      = left;
+    p_overlay->dirty.y      = bottom;
+    p_overlay->dirty.width  = right - left;
+    p_overlay->dirty.height = top - bottom;
+}
+
+void overlay_invalidate_all(overlay_t * p_overlay)
+{
+    /* Check parameter */
+    assert(p_overlay != NULL);
+
+    p_overlay->dirty.x      = 0;
+    p_overlay->dirty.y      = 0;
+    p_overlay->dirty.width  = p_overlay->width;
+    p_overlay->dirty.height = p_overlay->height;
+}
+
+bool overlay_is_dirty(const overlay_t * p_overlay)
+{
+    /* Check parameter */
+    assert(p_overlay != NULL);
+
+    return (p_overlay->dirty.width > 0) && (p_overlay->dirty.height > 0);
+}
+
+bool overlay_begin(const overlay_t * p_overlay)
+{
+    /* Check parameter */
+    assert(p_overlay != NULL);
+
+    if (!overlay_is_dirty(p_overlay))
+    {
+        return false;
+    }
+
+    /* Render to RGBA texture of overlay */
+    glBindFramebuffer(GL_FRAMEBUFFER, p_overlay->fb);
+
+    /* Only touch pixels inside dirty areas */
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(p_overlay->dirty.x, p_overlay->dirty.y,
+              p_overlay->dirty.width, p_overlay->dirty.height);
+
+    /* Make dirty areas transparent */
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    return true;
+}
+
+void overlay_end(overlay_t * p_overlay)
+{
+    /* Check parameter */
+    assert(p_overlay != NULL);
+
+    glDisable(GL_SCISSOR_TEST);
+
+    /* Unbind framebuffer */
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    /* Mark overlay as clean */
+    p_overlay->dirty.width  = 0;
+    p_overlay->dirty.height = 0;
+}
+
+void overlay_composite(GLuint prog, const overlay_t * p_overlay,
+                       gl_res_t res)
+{
+    /* Check parameters */
+    assert((prog != 0) && (p_overlay != NULL));
+
+    /* The texture contains premultiplied alpha */
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+    /* Render overlay on top of current content of framebuffer */
+    gl_render_texture(prog, GL_TEXTURE_2D, p_overlay->tex, res);
+
+    /* Disable blending */
+    glDisable(GL_BLEND);
+}
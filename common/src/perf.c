@@ -0,0 +1,309 @@
+/* Copyright (c) 2023 Renesas Electronics Corp.
+ * SPDX-License-Identifier: MIT-0 */
+
+/*******************************************************************************
+ * FILENAME: perf.c
+ *
+ * DESCRIPTION:
+ *   Render pass profiling function definition.
+ * 
+ * NOTE:
+ *   For function usage, please refer to 'perf.h'.
+ * 
+ * AUTHOR: RVC       START DATE: 15/03/2023
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "perf.h"
+#include "util.h"
+
+/******************************************************************************
+ *                            OPENGL ES EXTENSIONS                            *
+ ******************************************************************************/
+
+static PFNGLGETQUERYOBJECTUI64VEXTPROC glGetQueryObjectui64vEXT;
+
+/******************************************************************************
+ *                        STATIC FUNCTION DECLARATION                         *
+ ******************************************************************************/
+
+/* Collect results of queries issued 'PERF_QUERY_DEPTH - 1' frames ago.
+ * If 'b_discard' is true, results are dropped */
+static void collect_results(perf_t * p_perf, uint32_t slot, bool b_discard);
+
+/* Print statistics of all passes and reset them */
+static void print_report(perf_t * p_perf);
+
+/* Compare 2 floats (for 'qsort') */
+static int compare_floats(const void * p_a, const void * p_b);
+
+/* Get current CPU time in microseconds */
+static int64_t get_time_us();
+
+/******************************************************************************
+ *                            FUNCTION DEFINITION                             *
+ ******************************************************************************/
+
+perf_t * perf_create(bool b_enabled)
+{
+    perf_t * p_perf = (perf_t *)calloc(1, sizeof(perf_t));
+
+    if (p_perf == NULL)
+    {
+        printf("Error: Failed to allocate profiler\n");
+        return NULL;
+    }
+
+    if (!b_enabled)
+    {
+        return p_perf;
+    }
+
+    glGetQueryObjectui64vEXT = (PFNGLGETQUERYOBJECTUI64VEXTPROC)
+                               eglGetProcAddress("glGetQueryObjectui64vEXT");
+
+    if ((glGetQueryObjectui64vEXT == NULL) ||
+        !gl_is_ext_supported("GL_EXT_disjoint_timer_query"))
+    {
+        printf("Error: GPU profiling is not supported. It is disabled\n");
+        return p_perf;
+    }
+
+    p_perf->b_enabled = true;
+
+    return p_perf;
+}
+
+void perf_delete(perf_t * p_perf)
+{
+    uint32_t index = 0;
+
+    if (p_perf == NULL)
+    {
+        return;
+    }
+
+    for (index = 0; index < p_perf->pass_count; index++)
+    {
+        glDeleteQueries(PERF_QUERY_DEPTH, p_perf->passes[index].queries);
+    }
+
+    free(p_perf);
+}
+
+int perf_add_pass(perf_t * p_perf, const char * p_name)
+{
+    perf_pass_t * p_pass = NULL;
+
+    /* Check parameters */
+    assert((p_perf != NULL) && (p_name != NULL));
+
+    if (p_perf->pass_count >= PERF_MAX_PASSES)
+    {
+        printf("Error: Failed to add pass '%s'\n", p_name);
+        return -1;
+    }
+
+    p_pass = &(p_perf->passes[p_perf->pass_count]);
+    p_pass->p_name = p_name;
+
+    if (p_perf->b_enabled)
+    {
+        glGenQueries(PERF_QUERY_DEPTH, p_pass->queries);
+    }
+
+    return p_perf->pass_count++;
+}
+
+void perf_begin(perf_t * p_perf, int pass)
+{
+    perf_pass_t * p_pass = NULL;
+    uint32_t slot = 0;
+
+    /* Check parameter */
+    assert(p_perf != NULL);
+
+    if (!p_perf->b_enabled || (pass < 0))
+    {
+        return;
+    }
+
+    p_pass = &(p_perf->passes[pass]);
+    slot = p_perf->frame % PERF_QUERY_DEPTH;
+
+    /* The query of this slot is still in flight if the GPU is more than
+     * 'PERF_QUERY_DEPTH' frames behind. It's skipped instead of waiting */
+    if (!p_pass->b_pending[slot])
+    {
+        glBeginQuery(GL_TIME_ELAPSED_EXT, p_pass->queries[slot]);
+    }
+
+    p_pass->cpu_start_us = get_time_us();
+}
+
+void perf_end(perf_t * p_perf, int pass)
+{
+    perf_pass_t * p_pass = NULL;
+    uint32_t slot = 0;
+
+    /* Check parameter */
+    assert(p_perf != NULL);
+
+    if (!p_perf->b_enabled || (pass < 0))
+    {
+        return;
+    }
+
+    p_pass = &(p_perf->passes[pass]);
+    slot = p_perf->frame % PERF_QUERY_DEPTH;
+
+    p_pass->cpu_total_us += get_time_us() - p_pass->cpu_start_us;
+    p_pass->cpu_count++;
+
+    if (!p_pass->b_pending[slot])
+    {
+        glEndQuery(GL_TIME_ELAPSED_EXT);
+        p_pass->b_pending[slot] = true;
+    }
+}
+
+void perf_end_frame(perf_t * p_perf)
+{
+    GLint b_disjoint = GL_FALSE;
+
+    /* Check parameter */
+    assert(p_perf != NULL);
+
+    if (!p_perf->b_enabled)
+    {
+        return;
+    }
+
+    /* Results are meaningless if a disjoint operation (such as a change of
+     * GPU frequency) happened while queries were in flight */
+    glGetIntegerv(GL_GPU_DISJOINT_EXT, &b_disjoint);
+
+    p_perf->frame++;
+
+    /* The next slot was used 'PERF_QUERY_DEPTH' frames ago */
+    collect_results(p_perf, p_perf->frame % PERF_QUERY_DEPTH,
+                    b_disjoint == GL_TRUE);
+
+    if ((p_perf->frame - p_perf->report_frame) >= PERF_REPORT_FRAMES)
+    {
+        print_report(p_perf);
+        p_perf->report_frame = p_perf->frame;
+    }
+}
+
+/******************************************************************************
+ *                         STATIC FUNCTION DEFINITION                         *
+ ******************************************************************************/
+
+static void collect_results(perf_t * p_perf, uint32_t slot, bool b_discard)
+{
+    perf_pass_t * p_pass = NULL;
+    uint32_t index = 0;
+
+    GLuint b_available = GL_FALSE;
+    GLuint64 elapsed_ns = 0;
+
+    for (index = 0; index < p_perf->pass_count; index++)
+    {
+        p_pass = &(p_perf->passes[index]);
+
+        if (!p_pass->b_pending[slot])
+        {
+            continue;
+        }
+
+        /* Leave the query in flight if its result is not available yet */
+        glGetQueryObjectuiv(p_pass->queries[slot],
+                            GL_QUERY_RESULT_AVAILABLE, &b_available);
+
+        if (b_available == GL_FALSE)
+        {
+            continue;
+        }
+
+        glGetQueryObjectui64vEXT(p_pass->queries[slot],
+                                 GL_QUERY_RESULT, &elapsed_ns);
+
+        p_pass->b_pending[slot] = false;
+
+        if (!b_discard && (p_pass->gpu_count < PERF_REPORT_FRAMES))
+        {
+            p_pass->gpu_us[p_pass->gpu_count++] = elapsed_ns / 1000.0f;
+        }
+    }
+}
+
+static void print_report(perf_t * p_perf)
+{
+    perf_pass_t * p_pass = NULL;
+    uint32_t index = 0;
+    uint32_t sample = 0;
+
+    float min_us = 0.0f;
+    float avg_us = 0.0f;
+    float p99_us = 0.0f;
+
+    printf("%-12s %10s %10s %10s %10s\n", "Pass (ms)",
+           "GPU min", "GPU avg", "GPU p99", "CPU avg");
+
+    for (index = 0; index < p_perf->pass_count; index++)
+    {
+        p_pass = &(p_perf->passes[index]);
+
+        min_us = 0.0f;
+        avg_us = 0.0f;
+        p99_us = 0.0f;
+
+        if (p_pass->gpu_count > 0)
+        {
+            qsort(p_pass->gpu_us, p_pass->gpu_count, sizeof(float),
+                  compare_floats);
+
+            for (sample = 0; sample < p_pass->gpu_count; sample++)
+            {
+                avg_us += p_pass->gpu_us[sample];
+            }
+
+            min_us = p_pass->gpu_us[0];
+            avg_us = avg_us / p_pass->gpu_count;
+            p99_us = p_pass->gpu_us[(p_pass->gpu_count * 99) / 100];
+        }
+
+        printf("%-12s %10.3f %10.3f %10.3f %10.3f\n", p_pass->p_name,
+               min_us / 1000.0f, avg_us / 1000.0f, p99_us / 1000.0f,
+               (p_pass->cpu_count > 0) ?
+               (p_pass->cpu_total_us / 1000.0f) / p_pass->cpu_count : 0.0f);
+
+        /* Start collecting again */
+        p_pass->gpu_count = 0;
+        p_pass->cpu_total_us = 0;
+        p_pass->cpu_count = 0;
+    }
+}
+
+static int compare_floats(const void * p_a, const void * p_b)
+{
+    float a = *(const float *)p_a;
+    float b = *(const float *)p_b;
+
+    return (a > b) - (a < b);
+}
+
+static int64_t get_time_us()
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+
+    return TIMEVAL_TO_USECS(tv);
+}
@@ -0,0 +1,212 @@
+/* Copyright (c) 2023 Renesas Electronics Corp.
+ * SPDX-License-Identifier: MIT-0 */
+
+/*******************************************************************************
+ * FILENAME: pip.c
+ *
+ * DESCRIPTION:
+ *   Picture-in-picture function definition.
+ *
+ * NOTE:
+ *   For function usage, please refer to 'pip.h'.
+ *
+ * AUTHOR: RVC       START DATE: 15/03/2023
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <assert.h>
+#include <unistd.h>
+
+#include "pip.h"
+
+/******************************************************************************
+ *                            FUNCTION DEFINITION                             *
+ ******************************************************************************/
+
+pip_t pip_create(EGLDisplay display, const char * p_dev, rect_t area,
+                 uint32_t out_width, uint32_t out_height)
+{
+    pip_t pip = { 0 };
+    struct v4l2_format fmt;
+    uint32_t buf_cnt = PIP_BUFFER_COUNT;
+
+    /* Check parameters */
+    assert((display != EGL_NO_DISPLAY) && (p_dev != NULL));
+    assert((out_width > 0) && (out_height > 0));
+
+    if ((area.width <= 0) || (area.height <= 0))
+    {
+        area.width  = out_width / PIP_DEFAULT_SCALE;
+        area.height = (area.width * PIP_CAM_HEIGHT) / PIP_CAM_WIDTH;
+        area.x      = out_width - area.width - PIP_MARGIN;
+        area.y      = PIP_MARGIN;
+    }
+
+    pip.cam_fd     = -1;
+    pip.display    = display;
+    pip.index      = -1;
+    pip.area       = area;
+    pip.out_width  = out_width;
+    pip.out_height = out_height;
+
+    /* Open camera and set its format (the same as the main camera, but at
+     * a fixed size) */
+    pip.cam_fd = v4l2_open_dev(p_dev);
+    if (pip.cam_fd == -1)
+    {
+        printf("Error: Failed to open second camera '%s'\n", p_dev);
+        return pip;
+    }
+
+    if (!v4l2_verify_dev(pip.cam_fd) ||
+        !v4l2_set_format(pip.cam_fd, PIP_CAM_WIDTH, PIP_CAM_HEIGHT,
+                         V4L2_PIX_FMT_YUYV, V4L2_FIELD_NONE) ||
+        !v4l2_get_format(pip.cam_fd, &fmt) ||
+        (fmt.fmt.pix.pixelformat != V4L2_PIX_FMT_YUYV) ||
+        (fmt.fmt.pix.width != PIP_CAM_WIDTH) ||
+        (fmt.fmt.pix.height != PIP_CAM_HEIGHT))
+    {
+        printf("Error: Second camera does not support YUYV %ux%u\n",
+               PIP_CAM_WIDTH, PIP_CAM_HEIGHT);
+
+        pip_delete(&pip);
+        return pip;
+    }
+
+    /* Allocate buffers. Mali library requires that both address and size of
+     * dmabuf are multiples of page size (see the main camera) */
+    assert(util_is_aligned_to_page_size(YUYV_FRAME_SZ(PIP_CAM_WIDTH,
+                                                      PIP_CAM_HEIGHT)));
+
+    pip.p_bufs = v4l2_alloc_dmabufs(pip.cam_fd, &buf_cnt);
+    if ((pip.p_bufs == NULL) || (buf_cnt != PIP_BUFFER_COUNT))
+    {
+        printf("Error: Failed to allocate buffers of second camera\n");
+
+        pip_delete(&pip);
+        return pip;
+    }
+
+    /* Create YUYV EGLImage objects and textures */
+    pip.p_imgs = egl_create_yuyv_images(display, PIP_CAM_WIDTH, PIP_CAM_HEIGHT,
+                                        pip.p_bufs, PIP_BUFFER_COUNT);
+    if (pip.p_imgs == NULL)
+    {
+        pip_delete(&pip);
+        return pip;
+    }
+
+    pip.p_texs = gl_create_external_textures(pip.p_imgs, PIP_BUFFER_COUNT);
+    if (pip.p_texs == NULL)
+    {
+        pip_delete(&pip);
+        return pip;
+    }
+
+    /* Start capturing */
+    if (!v4l2_enqueue_bufs(pip.cam_fd, PIP_BUFFER_COUNT) ||
+        !v4l2_enable_capturing(pip.cam_fd))
+    {
+        printf("Error: Failed to start second camera\n");
+
+        pip_delete(&pip);
+        return pip;
+    }
+
+    return pip;
+}
+
+void pip_delete(pip_t * p_pip)
+{
+    /* Check parameter */
+    assert(p_pip != NULL);
+
+    /* Camera is not opened (or the struct is zero-initialized) */
+    if (p_pip->cam_fd <= 0)
+    {
+        return;
+    }
+
+    /* Stop capturing (nothing happens if it's not started) */
+    v4l2_disable_capturing(p_pip->cam_fd);
+
+    if (p_pip->p_texs != NULL)
+    {
+        gl_delete_textures(p_pip->p_texs, PIP_BUFFER_COUNT);
+    }
+
+    if (p_pip->p_imgs != NULL)
+    {
+        egl_delete_images(p_pip->display, p_pip->p_imgs, PIP_BUFFER_COUNT);
+    }
+
+    if (p_pip->p_bufs != NULL)
+    {
+        v4l2_dealloc_dmabufs(p_pip->p_bufs, PIP_BUFFER_COUNT);
+    }
+
+    close(p_pip->cam_fd);
+
+    p_pip->cam_fd = -1;
+    p_pip->p_texs = NULL;
+    p_pip->p_imgs = NULL;
+    p_pip->p_bufs = NULL;
+    p_pip->index  = -1;
+}
+
+bool pip_update(pip_t * p_pip)
+{
+    struct v4l2_buffer buf;
+    bool b_updated = false;
+
+    /* Check parameter */
+    assert((p_pip != NULL) && (p_pip->p_texs != NULL));
+
+    /* Skip frames which were never drawn, so the inset is not delayed */
+    while (v4l2_is_buf_ready(p_pip->cam_fd) &&
+           v4l2_dequeue_buf(p_pip->cam_fd, &buf))
+    {
+        /* The GPU has finished drawing the previous frame */
+        if (p_pip->index != -1)
+        {
+            assert(v4l2_enqueue_buf(p_pip->cam_fd, p_pip->index));
+        }
+
+        p_pip->index = buf.index;
+        b_updated = true;
+    }
+
+    return b_updated;
+}
+
+void pip_draw(const pip_t * p_pip, GLuint prog, gl_res_t res)
+{
+    GLint viewport[4];
+    GLint y = 0;
+
+    /* Check parameters */
+    assert((p_pip != NULL) && (prog != 0));
+
+    if (p_pip->index == -1)
+    {
+        return;
+    }
+
+    /* The area is counted from the bottom of the image, which is the last
+     * row of top-down framebuffers */
+    y = res.b_top_down ? ((GLint)p_pip->out_height - p_pip->area.y -
+                          p_pip->area.height) : p_pip->area.y;
+
+    /* Without scaler, the entire texture fills the current viewport */
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    glViewport(p_pip->area.x, y, p_pip->area.width, p_pip->area.height);
+
+    res.p_scaler = NULL;
+    res.p_mesh   = NULL;
+
+    gl_render_texture(prog, GL_TEXTURE_EXTERNAL_OES,
+                      p_pip->p_texs[p_pip->index], res);
+
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+}
@@ -20,6 +20,7 @@
 #include <getopt.h>
 
 #include "prog.h"
+#include "denoise.h"
 
 /******************************************************************************
  *                            FUNCTION DEFINITION                             *
@@ -34,15 +35,37 @@ void prog_parse_options(int argc, char * p_argv[], prog_opts_t * p_opts)
     int tmp_num    = 0;
     int tmp_den    = 0;
 
-    const char * p_opt_str = "h:w:d:f:";
+    int tmp_rotation = 0;
+
+    float tmp_zoom = 0.0f;
+    float tmp_denoise = 0.0f;
+
+    const char * p_opt_str = "h:w:d:f:o:s:z:r:m:n:l:t:k:a:j:i:g:bcx:p";
 
     const struct option options[] = 
     {
-        { "device", required_argument, NULL, 'd' },
-        { "width",  required_argument, NULL, 'w' },
-        { "height", required_argument, NULL, 'h' },
-        { "fps",    required_argument, NULL, 'f' },
-        { NULL,     0,                 NULL,  0  } /* Terminate the array */
+        { "device",    required_argument, NULL, 'd' },
+        { "width",     required_argument, NULL, 'w' },
+        { "height",    required_argument, NULL, 'h' },
+        { "fps",       required_argument, NULL, 'f' },
+        { "output",    required_argument, NULL, 'o' },
+        { "sub",       required_argument, NULL, 's' },
+        { "zoom",      required_argument, NULL, 'z' },
+        { "rotate",    required_argument, NULL, 'r' },
+        { "mirror",    required_argument, NULL, 'm' },
+        { "nv12",      required_argument, NULL, 'n' },
+        { "lens",      required_argument, NULL, 'l' },
+        { "denoise",   required_argument, NULL, 't' },
+        { "mask",      required_argument, NULL, 'k' },
+        { "motion",    required_argument, NULL, 'a' },
+        { "snapshot",  required_argument, NULL, 'j' },
+        { "pip",       required_argument, NULL, 'i' },
+        { "pip-area",  required_argument, NULL, 'g' },
+        { "stabilize", no_argument,       NULL, 'b' },
+        { "timestamp", no_argument,       NULL, 'c' },
+        { "ipc",       required_argument, NULL, 'x' },
+        { "perf",      no_argument,       NULL, 'p' },
+        { NULL,        0,                 NULL,  0  } /* Terminate array */
     };
  
     /* Check parameters */
@@ -82,6 +105,169 @@ void prog_parse_options(int argc, char * p_argv[], prog_opts_t * p_opts)
             }
             break;
 
+            case 'o':
+            {
+                tmp_width  = 0;
+                tmp_height = 0;
+
+                sscanf(optarg, "%dx%d", &tmp_width, &tmp_height);
+                p_opts->out_width  = (tmp_width <= 0) ? 0 : tmp_width;
+                p_opts->out_height = (tmp_height <= 0) ? 0 : tmp_height;
+            }
+            break;
+
+            case 's':
+            {
+                tmp_width  = 0;
+                tmp_height = 0;
+
+                sscanf(optarg, "%dx%d", &tmp_width, &tmp_height);
+                p_opts->sub_width  = (tmp_width <= 0) ? 0 : tmp_width;
+                p_opts->sub_height = (tmp_height <= 0) ? 0 : tmp_height;
+            }
+            break;
+
+            case 'z':
+            {
+                tmp_zoom = atof(optarg);
+                p_opts->zoom = (tmp_zoom < 1.0f) ? 1.0f : tmp_zoom;
+            }
+            break;
+
+            case 'r':
+            {
+                tmp_rotation = atoi(optarg);
+
+                if ((tmp_rotation == 0)   || (tmp_rotation == 90) ||
+                    (tmp_rotation == 180) || (tmp_rotation == 270))
+                {
+                    p_opts->rotation = tmp_rotation;
+                }
+                else
+                {
+                    printf("Error: Rotation must be 0, 90, 180, or 270. "
+                           "It is ignored\n");
+                }
+            }
+            break;
+
+            case 'm':
+            {
+                /* 'h': horizontally, 'v': vertically, 'hv': both */
+                p_opts->b_mirror_x = (strchr(optarg, 'h') != NULL);
+                p_opts->b_mirror_y = (strchr(optarg, 'v') != NULL);
+            }
+            break;
+
+            case 'n':
+            {
+                /* 'auto', 'planes', or 'bench' */
+                if (strcmp(optarg, "planes") == 0)
+                {
+                    p_opts->nv12_writer = NV12_WRITER_PLANES;
+                }
+                else if (strcmp(optarg, "bench") == 0)
+                {
+                    p_opts->nv12_writer = NV12_WRITER_BENCH;
+                }
+                else
+                {
+                    p_opts->nv12_writer = NV12_WRITER_AUTO;
+                }
+            }
+            break;
+
+            case 'l':
+            {
+                /* 'K1' or 'K1,K2' */
+                p_opts->lens_k1 = 0.0f;
+                p_opts->lens_k2 = 0.0f;
+
+                sscanf(optarg, "%f,%f", &(p_opts->lens_k1),
+                                        &(p_opts->lens_k2));
+            }
+            break;
+
+            case 't':
+            {
+                /* Some of the current frame must always be kept. The
+                 * precision of denoised frames may cap it further */
+                tmp_denoise = atof(optarg);
+                p_opts->denoise =
+                    (tmp_denoise < 0.0f) ? 0.0f :
+                    (tmp_denoise > DENOISE_MAX_STRENGTH_HALF_FLOAT) ?
+                    DENOISE_MAX_STRENGTH_HALF_FLOAT : tmp_denoise;
+            }
+            break;
+
+            case 'k':
+            {
+                strncpy(p_opts->mask_file, optarg, MASK_FILE_MAX_LEN - 1);
+                p_opts->mask_file[MASK_FILE_MAX_LEN - 1] = '\0';
+            }
+            break;
+
+            case 'a':
+            {
+                strncpy(p_opts->motion_file, optarg, MOTION_FILE_MAX_LEN - 1);
+                p_opts->motion_file[MOTION_FILE_MAX_LEN - 1] = '\0';
+            }
+            break;
+
+            case 'j':
+            {
+                strncpy(p_opts->snapshot_prefix, optarg,
+                        SNAPSHOT_PREFIX_MAX_LEN - 1);
+                p_opts->snapshot_prefix[SNAPSHOT_PREFIX_MAX_LEN - 1] = '\0';
+            }
+            break;
+
+            case 'i':
+            {
+                strncpy(p_opts->pip_dev, optarg, CAM_DEV_MAX_LEN - 1);
+                p_opts->pip_dev[CAM_DEV_MAX_LEN - 1] = '\0';
+            }
+            break;
+
+            case 'g':
+            {
+                /* 'WIDTHxHEIGHT+X+Y' */
+                tmp_width  = 0;
+                tmp_height = 0;
+
+                sscanf(optarg, "%dx%d+%d+%d", &tmp_width, &tmp_height,
+                                              &(p_opts->pip_x),
+                                              &(p_opts->pip_y));
+                p_opts->pip_width  = (tmp_width <= 0) ? 0 : tmp_width;
+                p_opts->pip_height = (tmp_height <= 0) ? 0 : tmp_height;
+            }
+            break;
+
+            case 'b':
+            {
+                p_opts->b_stabilize = true;
+            }
+            break;
+
+            case 'c':
+            {
+                p_opts->b_timestamp = true;
+            }
+            break;
+
+            case 'x':
+            {
+                strncpy(p_opts->ipc_name, optarg, IPC_NAME_MAX_LEN - 1);
+                p_opts->ipc_name[IPC_NAME_MAX_LEN - 1] = '\0';
+            }
+            break;
+
+            case 'p':
+            {
+                p_opts->b_perf = true;
+            }
+            break;
+
             default:
             {
                 /* Intentionally left blank */
@@ -89,4 +275,31 @@ void prog_parse_options(int argc, char * p_argv[], prog_opts_t * p_opts)
             break;
         }
     }
+
+    /* Lens correction mesh is computed once from the crop of the conversion
+     * pass, so it cannot follow the moving crop of stabilization */
+    if (p_opts->b_stabilize &&
+        ((p_opts->lens_k1 != 0.0f) || (p_opts->lens_k2 != 0.0f)))
+    {
+        printf("Warning: Stabilization cannot be used with lens correction. "
+               "It is ignored\n");
+
+        p_opts->b_stabilize = false;
+    }
+
+    /* Output has the same size as camera frame by default.
+     * It's sideways if camera frame is rotated by 90 or 270 degrees */
+    if ((p_opts->out_width == 0) || (p_opts->out_height == 0))
+    {
+        if ((p_opts->rotation == 90) || (p_opts->rotation == 270))
+        {
+            p_opts->out_width  = p_opts->height;
+            p_opts->out_height = p_opts->width;
+        }
+        else
+        {
+            p_opts->out_width  = p_opts->width;
+            p_opts->out_height = p_opts->height;
+        }
+    }
 }
@@ -0,0 +1,271 @@
+/* Copyright (c) 2023 Renesas Electronics Corp.
+ * SPDX-License-Identifier: MIT-0 */
+
+/*******************************************************************************
+ * FILENAME: shader.c
+ *
+ * DESCRIPTION:
+ *   Embedded shader function definition.
+ * 
+ * NOTE:
+ *   For function usage, please refer to 'shader.h'.
+ * 
+ * AUTHOR: RVC       START DATE: 15/03/2023
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "shader.h"
+
+/******************************************************************************
+ *                              MACRO VARIABLES                               *
+ ******************************************************************************/
+
+/* Header of all shaders. Shader files do not have it, so the definitions of
+ * variant can be inserted between it and the source code */
+#define SHADER_VERSION "#version 300 es\n"
+
+/* Additional header of fragment shaders. Extensions are only enabled, so
+ * variants which do not use them still compile on GPUs without them.
+ * Note: 'color.glsl' is inserted after it */
+#define SHADER_FS_HEADER \
+        "#extension GL_EXT_YUV_target : enable\n" \
+        "#extension GL_OES_EGL_image_external_essl3 : enable\n" \
+        "precision mediump float;\n"
+
+/* Flags of color standard and range (see 'color.glsl') */
+#define COLOR_FLAGS (SHADER_BT709 | SHADER_LIMITED_RANGE)
+
+/******************************************************************************
+ *                           STRUCTURE DEFINITIONS                            *
+ ******************************************************************************/
+
+typedef struct
+{
+    /* Source code of vertex shader and fragment shader */
+    const char * p_vs_src;
+    const char * p_fs_src;
+
+    /* Flags which apply to the program */
+    uint32_t flags;
+
+    /* Flags which are always set for the program */
+    uint32_t forced_flags;
+
+} shader_prog_info_t;
+
+/******************************************************************************
+ *                              EMBEDDED SHADERS                              *
+ ******************************************************************************/
+
+/* They are generated from 'common/shaders' (see 'Makefile') */
+extern const char g_color_glsl[];
+
+extern const char g_batch_vs_glsl[];
+extern const char g_batch_fs_glsl[];
+extern const char g_blur_fs_glsl[];
+extern const char g_denoise_fs_glsl[];
+extern const char g_mask_vs_glsl[];
+extern const char g_mask_fs_glsl[];
+extern const char g_motion_fs_glsl[];
+extern const char g_overlay_fs_glsl[];
+extern const char g_rectangle_vs_glsl[];
+extern const char g_stabilize_fs_glsl[];
+extern const char g_rectangle_fs_glsl[];
+extern const char g_text_vs_glsl[];
+extern const char g_text_fs_glsl[];
+extern const char g_text_sdf_fs_glsl[];
+extern const char g_texture_vs_glsl[];
+extern const char g_yuv_to_rgb_fs_glsl[];
+extern const char g_yuyv_to_nv12_fs_glsl[];
+
+static const shader_prog_info_t g_progs[SHADER_PROG_COUNT] =
+{
+    [SHADER_PROG_RECTANGLE] =
+    {
+        g_rectangle_vs_glsl, g_rectangle_fs_glsl,
+        SHADER_YUV_OUTPUT | COLOR_FLAGS, 0
+    },
+
+    [SHADER_PROG_TEXT] =
+    {
+        g_text_vs_glsl, g_text_fs_glsl,
+        SHADER_YUV_OUTPUT | COLOR_FLAGS, 0
+    },
+
+    [SHADER_PROG_SDF_TEXT] =
+    {
+        g_text_vs_glsl, g_text_sdf_fs_glsl,
+        SHADER_YUV_OUTPUT | COLOR_FLAGS, 0
+    },
+
+    [SHADER_PROG_BATCH] =
+    {
+        g_batch_vs_glsl, g_batch_fs_glsl,
+        SHADER_YUV_OUTPUT | COLOR_FLAGS, 0
+    },
+
+    [SHADER_PROG_YUV_TO_RGB] =
+    {
+        g_texture_vs_glsl, g_yuv_to_rgb_fs_glsl,
+        SHADER_FLIP_Y | SHADER_RGB_INPUT | COLOR_FLAGS, 0
+    },
+
+    [SHADER_PROG_YUYV_TO_NV12] =
+    {
+        g_texture_vs_glsl, g_yuyv_to_nv12_fs_glsl,
+        SHADER_FLIP_Y | SHADER_OVERLAY | SHADER_RGB_INPUT |
+        SHADER_RGBA_INPUT | SHADER_LUMA_OUTPUT | SHADER_CHROMA_OUTPUT |
+        SHADER_MASK | COLOR_FLAGS, SHADER_YUV_OUTPUT
+    },
+
+    [SHADER_PROG_OVERLAY] =
+    {
+        g_texture_vs_glsl, g_overlay_fs_glsl,
+        SHADER_FLIP_Y, 0
+    },
+
+    [SHADER_PROG_DENOISE] =
+    {
+        g_texture_vs_glsl, g_denoise_fs_glsl,
+        SHADER_FLIP_Y | SHADER_RGB_INPUT | COLOR_FLAGS, 0
+    },
+
+    [SHADER_PROG_BLUR] =
+    {
+        g_texture_vs_glsl, g_blur_fs_glsl,
+        0, 0
+    },
+
+    [SHADER_PROG_MASK] =
+    {
+        g_mask_vs_glsl, g_mask_fs_glsl,
+        SHADER_YUV_OUTPUT | COLOR_FLAGS, 0
+    },
+
+    [SHADER_PROG_MOTION] =
+    {
+        g_texture_vs_glsl, g_motion_fs_glsl,
+        SHADER_RGB_INPUT | COLOR_FLAGS, 0
+    },
+
+    [SHADER_PROG_STABILIZE] =
+    {
+        g_texture_vs_glsl, g_stabilize_fs_glsl,
+        0, 0
+    },
+};
+
+/******************************************************************************
+ *                        STATIC FUNCTION DECLARATION                         *
+ ******************************************************************************/
+
+/* Write definitions of variant 'flags' to 'p_defines' */
+static void get_defines(uint32_t flags, char * p_defines, size_t size);
+
+/* Concatenate 'count' strings in 'pp_strs'.
+ * Note: The returned string must be freed when no longer used */
+static char * concat_strs(const char ** pp_strs, uint32_t count);
+
+/******************************************************************************
+ *                            FUNCTION DEFINITION                             *
+ ******************************************************************************/
+
+GLuint shader_create_prog(uint32_t prog, uint32_t flags)
+{
+    GLuint prog_object = 0;
+
+    char defines[256];
+
+    char * p_vs_src = NULL;
+    char * p_fs_src = NULL;
+
+    const char * vs_strs[3];
+    const char * fs_strs[5];
+
+    /* Check parameter */
+    assert(prog < SHADER_PROG_COUNT);
+
+    /* Keep flags which apply to the program */
+    flags = (flags & g_progs[prog].flags) | g_progs[prog].forced_flags;
+
+    /* Writing a single plane of NV12 replaces writing YUV */
+    if ((flags & (SHADER_LUMA_OUTPUT | SHADER_CHROMA_OUTPUT)) != 0)
+    {
+        flags &= ~SHADER_YUV_OUTPUT;
+    }
+
+    get_defines(flags, defines, sizeof(defines));
+
+    /* Vertex shader: Version, definitions, and source code */
+    vs_strs[0] = SHADER_VERSION;
+    vs_strs[1] = defines;
+    vs_strs[2] = g_progs[prog].p_vs_src;
+
+    /* Fragment shader: Version, definitions, header, color conversion, and
+     * source code */
+    fs_strs[0] = SHADER_VERSION;
+    fs_strs[1] = defines;
+    fs_strs[2] = SHADER_FS_HEADER;
+    fs_strs[3] = g_color_glsl;
+    fs_strs[4] = g_progs[prog].p_fs_src;
+
+    p_vs_src = concat_strs(vs_strs, 3);
+    p_fs_src = concat_strs(fs_strs, 5);
+
+    prog_object = gl_create_prog_from_str(p_vs_src, p_fs_src);
+
+    free(p_vs_src);
+    free(p_fs_src);
+
+    return prog_object;
+}
+
+/******************************************************************************
+ *                         STATIC FUNCTION DEFINITION                         *
+ ******************************************************************************/
+
+static void get_defines(uint32_t flags, char * p_defines, size_t size)
+{
+    snprintf(p_defines, size, "%s%s%s%s%s%s%s%s%s%s",
+             (flags & SHADER_YUV_OUTPUT)    ? "#define YUV_OUTPUT\n"    : "",
+             (flags & SHADER_BT709)         ? "#define BT709\n"         : "",
+             (flags & SHADER_LIMITED_RANGE) ? "#define LIMITED_RANGE\n" : "",
+             (flags & SHADER_FLIP_Y)        ? "#define FLIP_Y\n"        : "",
+             (flags & SHADER_OVERLAY)       ? "#define OVERLAY\n"       : "",
+             (flags & SHADER_RGB_INPUT)     ? "#define RGB_INPUT\n"     : "",
+             (flags & SHADER_LUMA_OUTPUT)   ? "#define LUMA_OUTPUT\n"   : "",
+             (flags & SHADER_CHROMA_OUTPUT) ? "#define CHROMA_OUTPUT\n" : "",
+             (flags & SHADER_RGBA_INPUT)    ? "#define RGBA_INPUT\n"    : "",
+             (flags & SHADER_MASK)          ? "#define MASK\n"          : "");
+}
+
+static char * concat_strs(const char ** pp_strs, uint32_t count)
+{
+    char * p_str = NULL;
+
+    size_t len = 0;
+    uint32_t index = 0;
+
+    /* Check parameter */
+    assert(pp_strs != NULL);
+
+    for (index = 0; index < count; index++)
+    {
+        len += strlen(pp_strs[index]);
+    }
+
+    p_str = (char *)malloc(len + 1);
+    p_str[0] = '\0';
+
+    for (index = 0; index < count; index++)
+    {
+        strcat(p_str, pp_strs[index]);
+    }
+
+    return p_str;
+}
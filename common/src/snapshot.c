@@ -0,0 +1,455 @@
+/* Copyright (c) 2023 Renesas Electronics Corp.
+ * SPDX-License-Identifier: MIT-0 */
+
+/*******************************************************************************
+ * FILENAME: snapshot.c
+ *
+ * DESCRIPTION:
+ *   Snapshot function definition.
+ *
+ * NOTE:
+ *   For function usage, please refer to 'snapshot.h'.
+ *
+ * AUTHOR: RVC       START DATE: 15/03/2023
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <errno.h>
+#include <unistd.h>
+#include <setjmp.h>
+#include <jpeglib.h>
+
+#include "snapshot.h"
+
+/******************************************************************************
+ *                              MACRO VARIABLES                               *
+ ******************************************************************************/
+
+/* Nice value of the worker thread (19: lowest priority) */
+#define SNAPSHOT_WORKER_NICE 19
+
+/* Max length of file names */
+#define SNAPSHOT_FILE_MAX_LEN 300
+
+/******************************************************************************
+ *                           STRUCTURE DEFINITIONS                            *
+ ******************************************************************************/
+
+typedef struct
+{
+    /* Error manager of libjpeg (it must be the first member, libjpeg only
+     * knows about it) */
+    struct jpeg_error_mgr mgr;
+
+    /* Context which 'error_exit' jumps back to */
+    jmp_buf jump;
+
+} jpeg_error_t;
+
+/******************************************************************************
+ *                        STATIC FUNCTION DECLARATION                         *
+ ******************************************************************************/
+
+/* Worker thread. It encodes mapped buffers to JPEG files */
+static void * thread_worker(void * p_param);
+
+/* Encode 'width' x 'height' RGBA pixels (first row at the top) to JPEG file
+ * 'p_file'. Return true if successful */
+static bool write_jpeg(const char * p_file, const uint8_t * p_pixels,
+                       uint32_t width, uint32_t height);
+
+/* Print fatal error of libjpeg and jump back to 'write_jpeg'. It replaces
+ * the default 'error_exit', which would exit the whole process */
+static void jpeg_error_exit(j_common_ptr p_cinfo);
+
+/******************************************************************************
+ *                            FUNCTION DEFINITION                             *
+ ******************************************************************************/
+
+snapshot_t * snapshot_create(uint32_t width, uint32_t height,
+                             const char * p_prefix)
+{
+    snapshot_t * p_snapshot = NULL;
+
+    /* Check parameters */
+    assert((width > 0) && (height > 0) && (p_prefix != NULL));
+
+    p_snapshot = (snapshot_t *)calloc(1, sizeof(snapshot_t));
+    if (p_snapshot == NULL)
+    {
+        printf("Error: Failed to allocate snapshot\n");
+        return NULL;
+    }
+
+    p_snapshot->width    = width;
+    p_snapshot->height   = height;
+    p_snapshot->p_prefix = p_prefix;
+    p_snapshot->state    = SNAPSHOT_STATE_IDLE;
+
+    /* Start worker thread */
+    pthread_mutex_init(&(p_snapshot->mutex), NULL);
+    pthread_cond_init(&(p_snapshot->cond), NULL);
+
+    if (pthread_create(&(p_snapshot->thread), NULL,
+                       thread_worker, p_snapshot) != 0)
+    {
+        printf("Error: Failed to create worker thread of snapshot\n");
+
+        pthread_cond_destroy(&(p_snapshot->cond));
+        pthread_mutex_destroy(&(p_snapshot->mutex));
+
+        free(p_snapshot);
+        return NULL;
+    }
+
+    /* Create RGBA texture and framebuffer */
+    p_snapshot->tex = gl_create_color_texture(width, height, GL_RGBA8, NULL);
+    if (p_snapshot->tex == 0)
+    {
+        printf("Error: Failed to create texture of snapshot\n");
+
+        snapshot_delete(p_snapshot);
+        return NULL;
+    }
+
+    p_snapshot->fb = gl_create_framebuffer(GL_TEXTURE_2D, p_snapshot->tex);
+    if (p_snapshot->fb == 0)
+    {
+        printf("Error: Failed to create framebuffer of snapshot\n");
+
+        snapshot_delete(p_snapshot);
+        return NULL;
+    }
+
+    /* The output is copied 1:1 */
+    p_snapshot->scaler = gl_init_scaler(width, height, width, height, false);
+
+    /* Create pixel buffer object. It's only read by the CPU */
+    glGenBuffers(1, &(p_snapshot->pbo));
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, p_snapshot->pbo);
+    glBufferData(GL_PIXEL_PACK_BUFFER, width * height * 4,
+                 NULL, GL_STREAM_READ);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    return p_snapshot;
+}
+
+void snapshot_delete(snapshot_t * p_snapshot)
+{
+    if (p_snapshot == NULL)
+    {
+        return;
+    }
+
+    /* Stop worker thread. It finishes the snapshot being encoded first */
+    assert(pthread_mutex_lock(&(p_snapshot->mutex)) == 0);
+
+    p_snapshot->b_quit = true;
+    assert(pthread_cond_signal(&(p_snapshot->cond)) == 0);
+
+    assert(pthread_mutex_unlock(&(p_snapshot->mutex)) == 0);
+
+    pthread_join(p_snapshot->thread, NULL);
+
+    pthread_cond_destroy(&(p_snapshot->cond));
+    pthread_mutex_destroy(&(p_snapshot->mutex));
+
+    /* Release the buffer */
+    if (p_snapshot->fence != NULL)
+    {
+        glDeleteSync(p_snapshot->fence);
+    }
+
+    if (p_snapshot->state == SNAPSHOT_STATE_ENCODED)
+    {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, p_snapshot->pbo);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    }
+
+    glDeleteBuffers(1, &(p_snapshot->pbo));
+    glDeleteFramebuffers(1, &(p_snapshot->fb));
+    glDeleteTextures(1, &(p_snapshot->tex));
+
+    free(p_snapshot);
+}
+
+bool snapshot_capture(snapshot_t * p_snapshot, GLuint prog,
+                      GLenum target, GLuint tex, gl_res_t res)
+{
+    uint32_t state = SNAPSHOT_STATE_IDLE;
+
+    /* Check parameters */
+    assert((p_snapshot != NULL) && (prog != 0) && (tex != 0));
+
+    assert(pthread_mutex_lock(&(p_snapshot->mutex)) == 0);
+    state = p_snapshot->state;
+    assert(pthread_mutex_unlock(&(p_snapshot->mutex)) == 0);
+
+    if (state != SNAPSHOT_STATE_IDLE)
+    {
+        return false;
+    }
+
+    /* Render output frame to RGBA texture. It's drawn without
+     * 'SHADER_FLIP_Y', so its first row is the top of the image */
+    res.p_scaler = &(p_snapshot->scaler);
+    res.p_mesh   = NULL;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, p_snapshot->fb);
+
+    gl_render_texture(prog, target, tex, res);
+
+    /* Copy it to the buffer. With a pixel buffer object bound,
+     * 'glReadPixels' returns without waiting for the GPU */
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, p_snapshot->pbo);
+    glReadPixels(0, 0, p_snapshot->width, p_snapshot->height,
+                 GL_RGBA, GL_UNSIGNED_BYTE, (void *)0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    p_snapshot->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    /* Unbind framebuffer */
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    assert(pthread_mutex_lock(&(p_snapshot->mutex)) == 0);
+    p_snapshot->state = SNAPSHOT_STATE_READING;
+    assert(pthread_mutex_unlock(&(p_snapshot->mutex)) == 0);
+
+    return true;
+}
+
+void snapshot_update(snapshot_t * p_snapshot)
+{
+    uint32_t state = SNAPSHOT_STATE_IDLE;
+    GLenum status = GL_WAIT_FAILED;
+
+    const uint8_t * p_pixels = NULL;
+
+    /* Check parameter */
+    assert(p_snapshot != NULL);
+
+    assert(pthread_mutex_lock(&(p_snapshot->mutex)) == 0);
+    state = p_snapshot->state;
+    assert(pthread_mutex_unlock(&(p_snapshot->mutex)) == 0);
+
+    if (state == SNAPSHOT_STATE_READING)
+    {
+        /* Only check the fence */
+        status = glClientWaitSync(p_snapshot->fence, 0, 0);
+
+        if ((status != GL_ALREADY_SIGNALED) &&
+            (status != GL_CONDITION_SATISFIED))
+        {
+            return;
+        }
+
+        glDeleteSync(p_snapshot->fence);
+        p_snapshot->fence = NULL;
+
+        /* Map the buffer. It stays mapped while the worker thread reads it,
+         * so the frame is never copied on this thread */
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, p_snapshot->pbo);
+
+        p_pixels = (const uint8_t *)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0,
+                                                     p_snapshot->width *
+                                                     p_snapshot->height * 4,
+                                                     GL_MAP_READ_BIT);
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        assert(pthread_mutex_lock(&(p_snapshot->mutex)) == 0);
+
+        if (p_pixels != NULL)
+        {
+            p_snapshot->p_pixels = p_pixels;
+            p_snapshot->state    = SNAPSHOT_STATE_ENCODING;
+
+            assert(pthread_cond_signal(&(p_snapshot->cond)) == 0);
+        }
+        else
+        {
+            printf("Error: Failed to read snapshot\n");
+
+            p_snapshot->state = SNAPSHOT_STATE_IDLE;
+        }
+
+        assert(pthread_mutex_unlock(&(p_snapshot->mutex)) == 0);
+    }
+    else if (state == SNAPSHOT_STATE_ENCODED)
+    {
+        /* The worker thread is done with the buffer */
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, p_snapshot->pbo);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        assert(pthread_mutex_lock(&(p_snapshot->mutex)) == 0);
+
+        p_snapshot->p_pixels = NULL;
+        p_snapshot->state    = SNAPSHOT_STATE_IDLE;
+
+        assert(pthread_mutex_unlock(&(p_snapshot->mutex)) == 0);
+    }
+}
+
+/******************************************************************************
+ *                         STATIC FUNCTION DEFINITION                         *
+ ******************************************************************************/
+
+static void * thread_worker(void * p_param)
+{
+    snapshot_t * p_snapshot = (snapshot_t *)p_param;
+    char file[SNAPSHOT_FILE_MAX_LEN];
+
+    /* Lower priority of this thread only (Linux threads have their own nice
+     * values), so encoding never delays rendering */
+    errno = 0;
+    if ((nice(SNAPSHOT_WORKER_NICE) == -1) && (errno != 0))
+    {
+        printf("Error: Failed to lower priority of snapshot\n");
+    }
+
+    while (true)
+    {
+        assert(pthread_mutex_lock(&(p_snapshot->mutex)) == 0);
+
+        while (!p_snapshot->b_quit &&
+               (p_snapshot->state != SNAPSHOT_STATE_ENCODING))
+        {
+            /* Thread will sleep until a frame is copied or it's stopped */
+            assert(pthread_cond_wait(&(p_snapshot->cond),
+                                     &(p_snapshot->mutex)) == 0);
+        }
+
+        if (p_snapshot->state != SNAPSHOT_STATE_ENCODING)
+        {
+            assert(pthread_mutex_unlock(&(p_snapshot->mutex)) == 0);
+            break;
+        }
+
+        assert(pthread_mutex_unlock(&(p_snapshot->mutex)) == 0);
+
+        /* The buffer is not touched by the render thread while encoding */
+        snprintf(file, sizeof(file), "%s-%04u.jpg",
+                 p_snapshot->p_prefix, p_snapshot->count);
+
+        if (write_jpeg(file, p_snapshot->p_pixels,
+                       p_snapshot->width, p_snapshot->height))
+        {
+            printf("Snapshot: %s\n", file);
+            p_snapshot->count++;
+        }
+
+        assert(pthread_mutex_lock(&(p_snapshot->mutex)) == 0);
+        p_snapshot->state = SNAPSHOT_STATE_ENCODED;
+        assert(pthread_mutex_unlock(&(p_snapshot->mutex)) == 0);
+    }
+
+    return NULL;
+}
+
+static bool write_jpeg(const char * p_file, const uint8_t * p_pixels,
+                       uint32_t width, uint32_t height)
+{
+    struct jpeg_compress_struct cinfo;
+    jpeg_error_t jerr;
+
+    FILE * p_fp = NULL;
+
+    /* Row of RGB pixels (JPEG has no alpha) */
+    JSAMPROW p_row = NULL;
+    const uint8_t * p_src = NULL;
+
+    uint32_t x = 0;
+
+    p_fp = fopen(p_file, "wb");
+    if (p_fp == NULL)
+    {
+        printf("Error: Failed to open '%s'\n", p_file);
+        return false;
+    }
+
+    p_row = (JSAMPROW)malloc(width * 3);
+    if (p_row == NULL)
+    {
+        printf("Error: Failed to allocate row of snapshot\n");
+
+        fclose(p_fp);
+        return false;
+    }
+
+    cinfo.err = jpeg_std_error(&(jerr.mgr));
+    jerr.mgr.error_exit = jpeg_error_exit;
+
+    /* Fatal errors of libjpeg (such as a full disk) come back here.
+     * Note: 'p_fp' and 'p_row' are not changed after this point */
+    if (setjmp(jerr.jump) != 0)
+    {
+        jpeg_destroy_compress(&cinfo);
+
+        free(p_row);
+        fclose(p_fp);
+
+        /* Do not leave a truncated file */
+        unlink(p_file);
+        return false;
+    }
+
+    jpeg_create_compress(&cinfo);
+    jpeg_stdio_dest(&cinfo, p_fp);
+
+    cinfo.image_width      = width;
+    cinfo.image_height     = height;
+    cinfo.input_components = 3;
+    cinfo.in_color_space   = JCS_RGB;
+
+    jpeg_set_defaults(&cinfo);
+    jpeg_set_quality(&cinfo, SNAPSHOT_JPEG_QUALITY, TRUE);
+
+    jpeg_start_compress(&cinfo, TRUE);
+
+    while (cinfo.next_scanline < cinfo.image_height)
+    {
+        p_src = p_pixels + ((size_t)cinfo.next_scanline * width * 4);
+
+        for (x = 0; x < width; x++)
+        {
+            p_row[(x * 3) + 0] = p_src[(x * 4) + 0];
+            p_row[(x * 3) + 1] = p_src[(x * 4) + 1];
+            p_row[(x * 3) + 2] = p_src[(x * 4) + 2];
+        }
+
+        jpeg_write_scanlines(&cinfo, &p_row, 1);
+    }
+
+    jpeg_finish_compress(&cinfo);
+    jpeg_destroy_compress(&cinfo);
+
+    free(p_row);
+
+    /* Buffered data is written when the file is closed */
+    if (fclose(p_fp) != 0)
+    {
+        printf("Error: Failed to write '%s'\n", p_file);
+
+        unlink(p_file);
+        return false;
+    }
+
+    return true;
+}
+
+static void jpeg_error_exit(j_common_ptr p_cinfo)
+{
+    jpeg_error_t * p_err = (jpeg_error_t *)p_cinfo->err;
+    char msg[JMSG_LENGTH_MAX];
+
+    (*(p_cinfo->err->format_message))(p_cinfo, msg);
+    printf("Error: Failed to encode snapshot (%s)\n", msg);
+
+    longjmp(p_err->jump, 1);
+}
@@ -0,0 +1,316 @@
+/* Copyright (c) 2023 Renesas Electronics Corp.
+ * SPDX-License-Identifier: MIT-0 */
+
+/*******************************************************************************
+ * FILENAME: stabilize.c
+ *
+ * DESCRIPTION:
+ *   Digital image stabilization function definition.
+ *
+ * NOTE:
+ *   For function usage, please refer to 'stabilize.h'.
+ *
+ * AUTHOR: RVC       START DATE: 15/03/2023
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <assert.h>
+#include <float.h>
+
+#include "stabilize.h"
+
+/******************************************************************************
+ *                              MACRO VARIABLES                               *
+ ******************************************************************************/
+
+/* Number of shifts in the search window */
+#define STABILIZE_SHIFT_COUNT (STABILIZE_WINDOW * STABILIZE_WINDOW)
+
+/******************************************************************************
+ *                        STATIC FUNCTION DECLARATION                         *
+ ******************************************************************************/
+
+/* Return the sub-pixel offset (-0.5 to 0.5) of the minimum of the parabola
+ * through costs 'prev', 'cur' and 'next' of 3 neighbouring shifts */
+static float refine_shift(float prev, float cur, float next);
+
+/* Move the crop against the shake of content. The content moved by
+ * ('shift_x', 'shift_y') pixels of camera frame since the previous frame */
+static void update_offset(stabilize_t * p_stab, float shift_x, float shift_y);
+
+/******************************************************************************
+ *                            FUNCTION DEFINITION                             *
+ ******************************************************************************/
+
+stabilize_t stabilize_create(uint32_t cam_width, uint32_t cam_height)
+{
+    stabilize_t stab = { 0 };
+    uint32_t index = 0;
+
+    /* Check parameters */
+    assert((cam_width > 0) && (cam_height > 0));
+
+    stab.cam_width  = cam_width;
+    stab.cam_height = cam_height;
+
+    /* Create RGBA textures and framebuffers of luma frames */
+    for (index = 0; index < 2; index++)
+    {
+        stab.texs[index] = gl_create_color_texture(STABILIZE_WIDTH,
+                                                   STABILIZE_HEIGHT,
+                                                   GL_RGBA8, NULL);
+        if (stab.texs[index] == 0)
+        {
+            printf("Error: Failed to create texture of stabilization\n");
+            break;
+        }
+
+        stab.fbs[index] = gl_create_framebuffer(GL_TEXTURE_2D,
+                                                stab.texs[index]);
+        if (stab.fbs[index] == 0)
+        {
+            printf("Error: Failed to create framebuffer of stabilization\n");
+            break;
+        }
+    }
+
+    if (index < 2)
+    {
+        stabilize_delete(&stab);
+        return stab;
+    }
+
+    /* Create RGBA texture and framebuffer of costs */
+    stab.cost_tex = gl_create_color_texture(STABILIZE_WINDOW, STABILIZE_WINDOW,
+                                            GL_RGBA8, NULL);
+    if (stab.cost_tex != 0)
+    {
+        stab.cost_fb = gl_create_framebuffer(GL_TEXTURE_2D, stab.cost_tex);
+    }
+
+    if (stab.cost_fb == 0)
+    {
+        printf("Error: Failed to create costs of stabilization\n");
+
+        stabilize_delete(&stab);
+        return stab;
+    }
+
+    return stab;
+}
+
+void stabilize_delete(stabilize_t * p_stab)
+{
+    uint32_t index = 0;
+
+    /* Check parameter */
+    assert(p_stab != NULL);
+
+    for (index = 0; index < 2; index++)
+    {
+        glDeleteFramebuffers(1, &(p_stab->fbs[index]));
+        glDeleteTextures(1, &(p_stab->texs[index]));
+
+        p_stab->fbs[index]  = 0;
+        p_stab->texs[index] = 0;
+    }
+
+    glDeleteFramebuffers(1, &(p_stab->cost_fb));
+    glDeleteTextures(1, &(p_stab->cost_tex));
+
+    p_stab->cost_fb  = 0;
+    p_stab->cost_tex = 0;
+}
+
+void stabilize_update(stabilize_t * p_stab, GLuint luma_prog,
+                      GLuint match_prog, GLenum target, GLuint tex,
+                      gl_res_t res)
+{
+    scaler_t scaler;
+
+    /* Write to one texture while reading the other (ping-pong) */
+    uint32_t cur  = 0;
+    uint32_t prev = 0;
+
+    GLenum targets[2] = { 0, GL_TEXTURE_2D };
+    GLuint texs[2]    = { 0, 0 };
+
+    /* Costs (RGBA) of shifts, the best one, and its position */
+    uint8_t pixels[STABILIZE_SHIFT_COUNT * 4];
+    float costs[STABILIZE_SHIFT_COUNT];
+
+    float best_cost = FLT_MAX;
+    int best_x = 0;
+    int best_y = 0;
+
+    float shift_x = 0.0f;
+    float shift_y = 0.0f;
+
+    int x = 0;
+    int y = 0;
+    int index = 0;
+
+    /* Check parameters */
+    assert((p_stab != NULL) && (luma_prog != 0) && (match_prog != 0));
+    assert(tex != 0);
+
+    cur  = p_stab->frame % 2;
+    prev = 1 - cur;
+
+    /* Render the entire camera frame (whatever the crop of the conversion
+     * pass is) as a luma frame, without lens correction. It's drawn without
+     * 'SHADER_FLIP_Y', so its first row is the top of the image */
+    targets[0] = target;
+    texs[0]    = tex;
+    texs[1]    = p_stab->texs[prev];
+
+    glUseProgram(luma_prog);
+    glUniform1i(glGetUniformLocation(luma_prog, "yuyvTexture"), 0);
+    glUniform1i(glGetUniformLocation(luma_prog, "historyTexture"), 1);
+
+    /* Only luma (red channel) is used, so history is never sampled */
+    glUniform1i(glGetUniformLocation(luma_prog, "firstFrame"), 1);
+
+    scaler = gl_init_scaler(p_stab->cam_width, p_stab->cam_height,
+                            STABILIZE_WIDTH, STABILIZE_HEIGHT, false);
+
+    res.p_scaler = &scaler;
+    res.p_mesh   = NULL;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, p_stab->fbs[cur]);
+
+    gl_render_textures(luma_prog, targets, texs, 2, res);
+
+    /* There is no previous frame at the first frame */
+    if (p_stab->frame == 0)
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+        p_stab->frame++;
+        return;
+    }
+
+    /* Compute cost of every shift. Each output pixel is a shift, so the
+     * viewport is the search window */
+    texs[0]    = p_stab->texs[cur];
+    targets[0] = GL_TEXTURE_2D;
+
+    glUseProgram(match_prog);
+    glUniform1i(glGetUniformLocation(match_prog, "currentTexture"), 0);
+    glUniform1i(glGetUniformLocation(match_prog, "previousTexture"), 1);
+    glUniform1i(glGetUniformLocation(match_prog, "searchRadius"),
+                STABILIZE_SEARCH_RADIUS);
+
+    scaler = gl_init_scaler(STABILIZE_WIDTH, STABILIZE_HEIGHT,
+                            STABILIZE_WINDOW, STABILIZE_WINDOW, false);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, p_stab->cost_fb);
+
+    gl_render_textures(match_prog, targets, texs, 2, res);
+
+    /* Read costs. They are only a few hundred pixels and the GPU has
+     * already finished them, so this does not stall the pipeline */
+    glReadPixels(0, 0, STABILIZE_WINDOW, STABILIZE_WINDOW,
+                 GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+
+    /* Unbind framebuffer */
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    p_stab->frame++;
+
+    /* Unpack costs (R: high byte, G: low byte) and find the best shift */
+    for (index = 0; index < STABILIZE_SHIFT_COUNT; index++)
+    {
+        costs[index] = pixels[index * 4] + (pixels[(index * 4) + 1] / 255.0f);
+
+        if (costs[index] < best_cost)
+        {
+            best_cost = costs[index];
+            best_x    = index % STABILIZE_WINDOW;
+            best_y    = index / STABILIZE_WINDOW;
+        }
+    }
+
+    /* Refine it between neighbouring shifts (not at the edge of window) */
+    x = best_x;
+    y = best_y;
+    index = (y * STABILIZE_WINDOW) + x;
+
+    shift_x = (float)(x - STABILIZE_SEARCH_RADIUS);
+    shift_y = (float)(y - STABILIZE_SEARCH_RADIUS);
+
+    if ((x > 0) && (x < (STABILIZE_WINDOW - 1)))
+    {
+        shift_x += refine_shift(costs[index - 1], costs[index],
+                                costs[index + 1]);
+    }
+
+    if ((y > 0) && (y < (STABILIZE_WINDOW - 1)))
+    {
+        shift_y += refine_shift(costs[index - STABILIZE_WINDOW], costs[index],
+                                costs[index + STABILIZE_WINDOW]);
+    }
+
+    /* Convert shift to pixels of camera frame */
+    update_offset(p_stab,
+                  shift_x * p_stab->cam_width / STABILIZE_WIDTH,
+                  shift_y * p_stab->cam_height / STABILIZE_HEIGHT);
+}
+
+void stabilize_apply(const stabilize_t * p_stab, scaler_t * p_scaler,
+                     float zoom, float center_x, float center_y)
+{
+    /* Check parameters */
+    assert((p_stab != NULL) && (p_scaler != NULL));
+
+    /* 'gl_set_zoom' keeps the crop inside the camera frame */
+    gl_set_zoom(p_scaler, zoom * STABILIZE_ZOOM,
+                center_x + p_stab->offset_x, center_y + p_stab->offset_y);
+}
+
+/******************************************************************************
+ *                         STATIC FUNCTION DEFINITION                         *
+ ******************************************************************************/
+
+static float refine_shift(float prev, float cur, float next)
+{
+    float curvature = prev - (2.0f * cur) + next;
+
+    /* Flat costs (such as a uniform scene) have no clear minimum */
+    if (curvature <= 0.0f)
+    {
+        return 0.0f;
+    }
+
+    return glm_clamp((prev - next) / (2.0f * curvature), -0.5f, 0.5f);
+}
+
+static void update_offset(stabilize_t * p_stab, float shift_x, float shift_y)
+{
+    /* Max offset of crop, so that it stays inside the camera frame */
+    float margin_x = p_stab->cam_width * (1.0f - (1.0f / STABILIZE_ZOOM)) /
+                     2.0f;
+    float margin_y = p_stab->cam_height * (1.0f - (1.0f / STABILIZE_ZOOM)) /
+                     2.0f;
+
+    /* Follow the content, but only by the high-frequency part of its
+     * trajectory (shake). Slow motion (such as panning) is kept */
+    p_stab->path_x += shift_x;
+    p_stab->path_y += shift_y;
+
+    p_stab->smooth_x += STABILIZE_SMOOTHING *
+                        (p_stab->path_x - p_stab->smooth_x);
+    p_stab->smooth_y += STABILIZE_SMOOTHING *
+                        (p_stab->path_y - p_stab->smooth_y);
+
+    p_stab->offset_x = glm_clamp(p_stab->path_x - p_stab->smooth_x,
+                                 -margin_x, margin_x);
+    p_stab->offset_y = glm_clamp(p_stab->path_y - p_stab->smooth_y,
+                                 -margin_y, margin_y);
+
+    /* If the margin is exceeded, the smoothed position catches up, so the
+     * crop does not stick to the edge */
+    p_stab->smooth_x = p_stab->path_x - p_stab->offset_x;
+    p_stab->smooth_y = p_stab->path_y - p_stab->offset_y;
+}
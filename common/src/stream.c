@@ -0,0 +1,167 @@
+/* Copyright (c) 2023 Renesas Electronics Corp.
+ * SPDX-License-Identifier: MIT-0 */
+
+/*******************************************************************************
+ * FILENAME: stream.c
+ *
+ * DESCRIPTION:
+ *   Streaming vertex buffer function definition.
+ * 
+ * NOTE:
+ *   For function usage, please refer to 'stream.h'.
+ * 
+ * AUTHOR: RVC       START DATE: 15/03/2023
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "stream.h"
+#include "util.h"
+
+/******************************************************************************
+ *                              MACRO VARIABLES                               *
+ ******************************************************************************/
+
+/* Timeout (in nanoseconds) of each wait for fence */
+#define STREAM_WAIT_TIMEOUT_NS 1000000
+
+/******************************************************************************
+ *                        STATIC FUNCTION DECLARATION                         *
+ ******************************************************************************/
+
+/* Fence the current region and move to the next one */
+static void next_region(stream_t * p_stream);
+
+/******************************************************************************
+ *                            FUNCTION DEFINITION                             *
+ ******************************************************************************/
+
+stream_t * stream_create(uint32_t size)
+{
+    stream_t * p_stream = NULL;
+
+    /* Check parameter */
+    assert(size >= (STREAM_REGION_COUNT * STREAM_ALIGNMENT));
+
+    p_stream = (stream_t *)calloc(1, sizeof(stream_t));
+    if (p_stream == NULL)
+    {
+        printf("Error: Failed to allocate stream\n");
+        return NULL;
+    }
+
+    /* Regions start at multiples of 'STREAM_ALIGNMENT' */
+    p_stream->region_size = (size / STREAM_REGION_COUNT) &
+                            ~(STREAM_ALIGNMENT - 1);
+
+    /* Allocate storage of buffer once */
+    glGenBuffers(1, &(p_stream->vbo));
+    glBindBuffer(GL_ARRAY_BUFFER, p_stream->vbo);
+    glBufferData(GL_ARRAY_BUFFER,
+                 p_stream->region_size * STREAM_REGION_COUNT,
+                 NULL, GL_STREAM_DRAW);
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    return p_stream;
+}
+
+void stream_delete(stream_t * p_stream)
+{
+    uint32_t index = 0;
+
+    if (p_stream == NULL)
+    {
+        return;
+    }
+
+    for (index = 0; index < STREAM_REGION_COUNT; index++)
+    {
+        if (p_stream->fences[index] != NULL)
+        {
+            glDeleteSync(p_stream->fences[index]);
+        }
+    }
+
+    glDeleteBuffers(1, &(p_stream->vbo));
+    free(p_stream);
+}
+
+int32_t stream_upload(stream_t * p_stream, const void * p_data, uint32_t size)
+{
+    uint32_t offset = 0;
+    void * p_dst = NULL;
+
+    /* Check parameters */
+    assert((p_stream != NULL) && (p_data != NULL) && (size > 0));
+
+    if (size > p_stream->region_size)
+    {
+        printf("Error: %d bytes do not fit in stream\n", size);
+        return -1;
+    }
+
+    if ((p_stream->offset + size) > p_stream->region_size)
+    {
+        next_region(p_stream);
+    }
+
+    offset = (p_stream->region * p_stream->region_size) + p_stream->offset;
+
+    /* The range is not used by any draw call in flight (see 'next_region').
+     * So, it's mapped without synchronization */
+    glBindBuffer(GL_ARRAY_BUFFER, p_stream->vbo);
+
+    p_dst = glMapBufferRange(GL_ARRAY_BUFFER, offset, size,
+                             GL_MAP_WRITE_BIT |
+                             GL_MAP_INVALIDATE_RANGE_BIT |
+                             GL_MAP_UNSYNCHRONIZED_BIT);
+    if (p_dst == NULL)
+    {
+        printf("Error: Failed to map stream\n");
+        return -1;
+    }
+
+    memcpy(p_dst, p_data, size);
+    glUnmapBuffer(GL_ARRAY_BUFFER);
+
+    p_stream->offset += ROUND_UP(size, STREAM_ALIGNMENT);
+
+    return offset;
+}
+
+/******************************************************************************
+ *                         STATIC FUNCTION DEFINITION                         *
+ ******************************************************************************/
+
+static void next_region(stream_t * p_stream)
+{
+    GLsync fence = NULL;
+
+    /* All draw calls which read the current region have been issued */
+    p_stream->fences[p_stream->region] =
+        glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    p_stream->region = (p_stream->region + 1) % STREAM_REGION_COUNT;
+    p_stream->offset = 0;
+
+    /* The next region was fenced 'STREAM_REGION_COUNT - 1' regions ago.
+     * So, the GPU has normally finished with it and this does not block */
+    fence = p_stream->fences[p_stream->region];
+
+    if (fence != NULL)
+    {
+        while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT,
+                                STREAM_WAIT_TIMEOUT_NS) == GL_TIMEOUT_EXPIRED)
+        {
+            /* Wait until the GPU catches up */
+        }
+
+        glDeleteSync(fence);
+        p_stream->fences[p_stream->region] = NULL;
+    }
+}
@@ -0,0 +1,358 @@
+/* Copyright (c) 2023 Renesas Electronics Corp.
+ * SPDX-License-Identifier: MIT-0 */
+
+/*******************************************************************************
+ * FILENAME: timestamp.c
+ *
+ * DESCRIPTION:
+ *   Timestamp burn-in function definition.
+ *
+ * NOTE:
+ *   For function usage, please refer to 'timestamp.h'.
+ *
+ * AUTHOR: RVC       START DATE: 15/03/2023
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include <time.h>
+
+#include "timestamp.h"
+
+/******************************************************************************
+ *                              MACRO VARIABLES                               *
+ ******************************************************************************/
+
+/* Text which fixes the layout (digits are replaced every frame) */
+#define TIMESTAMP_TEMPLATE "0000-00-00 00:00:00.000 #00000000"
+
+/* Length of date and time (without milliseconds) */
+#define TIMESTAMP_DATE_LEN 19
+
+/******************************************************************************
+ *                        STATIC FUNCTION DECLARATION                         *
+ ******************************************************************************/
+
+/* Get vertices of character 'c' at slot 'slot' of 'p_stamp'.
+ * Digits are centered in their slot, so they look monospaced */
+static void layout_slot(const timestamp_t * p_stamp,
+                        const ttf_sdf_font_t * p_font,
+                        uint32_t slot, char c, float verts[6][4]);
+
+/* Return the advance (in pixels) of the widest digit */
+static float get_digit_advance(const ttf_sdf_font_t * p_font, float scale);
+
+/* Lay out slots 'first' to 'last' (inclusive) of 'p_stamp' */
+static void layout_slots(timestamp_t * p_stamp, const ttf_sdf_font_t * p_font,
+                         uint32_t first, uint32_t last);
+
+/******************************************************************************
+ *                            FUNCTION DEFINITION                             *
+ ******************************************************************************/
+
+timestamp_t timestamp_create(float x, float y, float size, gl_res_t res)
+{
+    timestamp_t stamp = { 0 };
+    ttf_sdf_font_t * p_font = res.p_sdf_font;
+    glyph_t * p_glyph = NULL;
+
+    /* Ratio between text on screen and glyphs of the font */
+    float scale = 0.0f;
+    float digit_advance = 0.0f;
+
+    /* Vertices of a character and the area which all of them cover */
+    float verts[6][4];
+
+    float left   = x;
+    float right  = x;
+    float bottom = y;
+    float top    = y;
+
+    uint32_t slot = 0;
+    uint32_t vert = 0;
+    char c = '0';
+    bool b_digit = false;
+
+    /* Check parameters */
+    assert((p_font != NULL) && (size > 0.0f));
+    assert(strlen(TIMESTAMP_TEMPLATE) == TIMESTAMP_LEN);
+
+    scale = size / p_font->size;
+    digit_advance = get_digit_advance(p_font, scale);
+
+    strcpy(stamp.text, TIMESTAMP_TEMPLATE);
+
+    stamp.y    = y;
+    stamp.size = size;
+
+    /* Lay out slots once. Other characters keep their own advance */
+    for (slot = 0; slot < TIMESTAMP_LEN; slot++)
+    {
+        stamp.slot_x[slot] = x;
+
+        p_glyph = p_font->pp_glyphs[(unsigned char)stamp.text[slot]];
+
+        if (isdigit((unsigned char)stamp.text[slot]))
+        {
+            x += digit_advance;
+        }
+        else if (p_glyph != NULL)
+        {
+            x += p_glyph->advance * scale;
+        }
+    }
+
+    /* Get the area which any digit (or the fixed character) of each slot
+     * covers, so that callers can redraw it */
+    for (slot = 0; slot < TIMESTAMP_LEN; slot++)
+    {
+        b_digit = isdigit((unsigned char)stamp.text[slot]);
+
+        for (c = b_digit ? '0' : stamp.text[slot];
+             c <= (b_digit ? '9' : stamp.text[slot]); c++)
+        {
+            layout_slot(&stamp, p_font, slot, c, verts);
+
+            for (vert = 0; vert < 6; vert++)
+            {
+                left   = glm_min(left,   verts[vert][0]);
+                right  = glm_max(right,  verts[vert][0]);
+                bottom = glm_min(bottom, verts[vert][1]);
+                top    = glm_max(top,    verts[vert][1]);
+            }
+        }
+    }
+
+    stamp.bounds.x      = (int32_t)floorf(left);
+    stamp.bounds.y      = (int32_t)floorf(bottom);
+    stamp.bounds.width  = (int32_t)ceilf(right) - stamp.bounds.x;
+    stamp.bounds.height = (int32_t)ceilf(top) - stamp.bounds.y;
+
+    layout_slots(&stamp, p_font, 0, TIMESTAMP_LEN - 1);
+
+    return stamp;
+}
+
+bool timestamp_update(timestamp_t * p_stamp, const struct v4l2_buffer * p_buf,
+                      gl_res_t res)
+{
+    char text[TIMESTAMP_LEN + 1];
+
+    struct timespec real_now;
+    struct timespec mono_now;
+    struct tm local;
+
+    /* Capture time (in microseconds since the epoch) */
+    int64_t time_us = 0;
+    time_t secs = 0;
+
+    size_t len = 0;
+
+    int32_t first = -1;
+    int32_t last  = -1;
+    uint32_t slot = 0;
+
+    /* Check parameters */
+    assert((p_stamp != NULL) && (p_buf != NULL));
+    assert(res.p_sdf_font != NULL);
+
+    time_us = ((int64_t)p_buf->timestamp.tv_sec * 1000000) +
+              p_buf->timestamp.tv_usec;
+
+    /* Monotonic clock does not count from the epoch. Its offset is read
+     * every frame, so the text follows changes of system time */
+    if ((p_buf->flags & V4L2_BUF_FLAG_TIMESTAMP_MASK) ==
+        V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC)
+    {
+        clock_gettime(CLOCK_REALTIME, &real_now);
+        clock_gettime(CLOCK_MONOTONIC, &mono_now);
+
+        time_us += (((int64_t)real_now.tv_sec - mono_now.tv_sec) * 1000000) +
+                   ((real_now.tv_nsec - mono_now.tv_nsec) / 1000);
+    }
+
+    secs = (time_t)(time_us / 1000000);
+    localtime_r(&secs, &local);
+
+    len = strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", &local);
+
+    if (len == TIMESTAMP_DATE_LEN)
+    {
+        len += snprintf(text + len, sizeof(text) - len, ".%03u #%08u",
+                        (uint32_t)((time_us % 1000000) / 1000),
+                        p_buf->sequence % TIMESTAMP_COUNTER_MOD);
+    }
+
+    /* The layout only fits 4-digit years */
+    if (len != TIMESTAMP_LEN)
+    {
+        return false;
+    }
+
+    /* Find changed slots */
+    for (slot = 0; slot < TIMESTAMP_LEN; slot++)
+    {
+        if (text[slot] != p_stamp->text[slot])
+        {
+            first = (first == -1) ? (int32_t)slot : first;
+            last  = slot;
+        }
+    }
+
+    if (first == -1)
+    {
+        return false;
+    }
+
+    memcpy(p_stamp->text, text, sizeof(text));
+
+    /* Normally only the last digits of milliseconds and the counter change */
+    layout_slots(p_stamp, res.p_sdf_font, first, last);
+
+    return true;
+}
+
+void timestamp_draw(const timestamp_t * p_stamp, GLuint prog,
+                    const text_style_t * p_style, gl_res_t res)
+{
+    int32_t offset = 0;
+
+    /* Check parameters */
+    assert((p_stamp != NULL) && (prog != 0) && (p_style != NULL));
+    assert((res.p_sdf_font != NULL) && (res.p_stream != NULL));
+
+    /* Upload vertices of all slots (about 3 kilobytes). The stream never
+     * overwrites vertices which earlier draw calls may still read */
+    offset = stream_upload(res.p_stream, p_stamp->verts,
+                           sizeof(p_stamp->verts));
+    if (offset < 0)
+    {
+        return;
+    }
+
+    /* Enable blending (see 'gl_draw_text') */
+    glEnable(GL_BLEND);
+    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA,
+                        GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+    /* Use program object for drawing text and set its uniforms */
+    gl_use_sdf_text_prog(prog, p_stamp->size, p_style, res);
+
+    /* Enable attribute 0 since it's disabled by default */
+    glEnableVertexAttribArray(0);
+
+    /* Show OpenGL ES how the vertex array should be interpreted.
+     * Note: The stream's buffer is bound by 'stream_upload' */
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE,
+                          4 * sizeof(GLfloat), (void *)(intptr_t)offset);
+
+    /* Bind atlas and draw all slots */
+    glBindTexture(GL_TEXTURE_2D, res.p_sdf_font->tex_id);
+
+    glDrawArrays(GL_TRIANGLES, 0, TIMESTAMP_LEN * 6);
+
+    /* Unbind texture */
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    /* Unbind VBO buffer */
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    /* Disable attribute */
+    glDisableVertexAttribArray(0);
+
+    /* Disable blending */
+    glDisable(GL_BLEND);
+}
+
+/******************************************************************************
+ *                         STATIC FUNCTION DEFINITION                         *
+ ******************************************************************************/
+
+static void layout_slot(const timestamp_t * p_stamp,
+                        const ttf_sdf_font_t * p_font,
+                        uint32_t slot, char c, float verts[6][4])
+{
+    glyph_t * p_glyph = p_font->pp_glyphs[(unsigned char)c];
+    float scale = p_stamp->size / p_font->size;
+
+    float x = p_stamp->slot_x[slot];
+
+    float left   = 0.0f;
+    float top    = 0.0f;
+    float right  = 0.0f;
+    float bottom = 0.0f;
+
+    uint32_t vert = 0;
+
+    /* Characters without glyph are degenerate triangles (nothing drawn) */
+    if (p_glyph == NULL)
+    {
+        for (vert = 0; vert < 6; vert++)
+        {
+            verts[vert][0] = x;
+            verts[vert][1] = p_stamp->y;
+            verts[vert][2] = 0.0f;
+            verts[vert][3] = 0.0f;
+        }
+
+        return;
+    }
+
+    if (isdigit((unsigned char)c))
+    {
+        x += (get_digit_advance(p_font, scale) -
+              (p_glyph->advance * scale)) / 2.0f;
+    }
+
+    /* The same quad as 'gl_draw_sdf_text' */
+    left   = x + (p_glyph->offset_x * scale);
+    top    = p_stamp->y + (p_glyph->offset_y * scale);
+    right  = left + (p_glyph->width  * scale);
+    bottom = top  - (p_glyph->height * scale);
+
+    float glyph_verts[6][4] =
+    {
+        { left,  top,    p_glyph->tex_left,  p_glyph->tex_top    },
+        { right, top,    p_glyph->tex_right, p_glyph->tex_top    },
+        { right, bottom, p_glyph->tex_right, p_glyph->tex_bottom },
+        { right, bottom, p_glyph->tex_right, p_glyph->tex_bottom },
+        { left,  bottom, p_glyph->tex_left,  p_glyph->tex_bottom },
+        { left,  top,    p_glyph->tex_left,  p_glyph->tex_top    },
+    };
+
+    memcpy(verts, glyph_verts, sizeof(glyph_verts));
+}
+
+static float get_digit_advance(const ttf_sdf_font_t * p_font, float scale)
+{
+    float advance = 0.0f;
+    char c = '0';
+
+    for (c = '0'; c <= '9'; c++)
+    {
+        if (p_font->pp_glyphs[(unsigned char)c] != NULL)
+        {
+            advance = glm_max(advance,
+                              p_font->pp_glyphs[(unsigned char)c]->advance *
+                              scale);
+        }
+    }
+
+    return advance;
+}
+
+static void layout_slots(timestamp_t * p_stamp, const ttf_sdf_font_t * p_font,
+                         uint32_t first, uint32_t last)
+{
+    uint32_t slot = 0;
+
+    for (slot = first; slot <= last; slot++)
+    {
+        layout_slot(p_stamp, p_font, slot, p_stamp->text[slot],
+                    p_stamp->verts[slot]);
+    }
+}
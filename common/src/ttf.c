@@ -14,6 +14,7 @@
  *
  ******************************************************************************/
 
+#include <math.h>
 #include <stdio.h>
 #include <assert.h>
 #include <stdlib.h>
@@ -27,6 +28,45 @@
 
 #include "ttf.h"
 
+/******************************************************************************
+ *                              MACRO VARIABLES                               *
+ ******************************************************************************/
+
+/* Offset which is far enough to be replaced by any real offset */
+#define SDF_FAR_OFFSET 9999
+
+/* Space (in texels) between glyphs of the atlas, so that linear filtering
+ * does not read texels of a neighboring glyph */
+#define SDF_ATLAS_GAP 1
+
+/******************************************************************************
+ *                           STRUCTURE DEFINITIONS                            *
+ ******************************************************************************/
+
+/* Offset from a pixel to its closest seed pixel (used by 8SSEDT) */
+typedef struct
+{
+    int dx;
+    int dy;
+
+} sdf_offset_t;
+
+/******************************************************************************
+ *                        STATIC FUNCTION DECLARATION                         *
+ ******************************************************************************/
+
+static void sdf_compare(sdf_offset_t * p_grid, int width,
+                        int x, int y, int off_x, int off_y);
+
+static void sdf_propagate(sdf_offset_t * p_grid, int width, int height);
+
+static float * sdf_compute(const FT_Bitmap * p_bitmap, int pad,
+                           int * p_width, int * p_height);
+
+static unsigned char * sdf_generate_glyph(FT_GlyphSlot slot, glyph_t * p_glyph);
+
+static int floor_div(int val, int div);
+
 /******************************************************************************
  *                            FUNCTION DEFINITION                             *
  ******************************************************************************/
@@ -96,6 +136,12 @@ glyph_t ** ttf_generate(const char * p_file)
         pp_glyphs[c]->offset_y = face->glyph->bitmap_top;
         pp_glyphs[c]->advance  = face->glyph->advance.x >> 6;
 
+        /* Each glyph has its own texture */
+        pp_glyphs[c]->tex_left   = 0.0f;
+        pp_glyphs[c]->tex_top    = 0.0f;
+        pp_glyphs[c]->tex_right  = 1.0f;
+        pp_glyphs[c]->tex_bottom = 1.0f;
+
         glGenTextures(1, &(pp_glyphs[c]->tex_id));
         glBindTexture(GL_TEXTURE_2D, pp_glyphs[c]->tex_id);
 
@@ -143,3 +189,406 @@ void ttf_delete_glyphs(glyph_t ** pp_glyphs)
     /* Free entire array */
     free(pp_glyphs);
 }
+
+ttf_sdf_font_t * ttf_generate_sdf(const char * p_file)
+{
+    ttf_sdf_font_t * p_font = NULL;
+
+    FT_Library ft;
+    FT_Face face;
+
+    unsigned char c = 0;
+
+    /* Distance fields of glyphs before they are copied to the atlas */
+    unsigned char * p_fields[GLYPH_ARRAY_LEN] = { NULL };
+    unsigned char * p_atlas = NULL;
+
+    /* Position of the next glyph in the atlas */
+    int pos_x = SDF_ATLAS_GAP;
+    int pos_y = SDF_ATLAS_GAP;
+    int row_height = 0;
+
+    int row = 0;
+    int width  = 0;
+    int height = 0;
+
+    glyph_t * p_glyph = NULL;
+
+    /* Check parameter */
+    assert(p_file != NULL);
+
+    /* FreeType functions return a value other than 0 if an error occurred */
+    if (FT_Init_FreeType(&ft))
+    {
+        printf("Error: Failed to init FreeType library\n");
+        return NULL;
+    }
+
+    /* Open a TrueType font by its pathname */
+    if (FT_New_Face(ft, p_file, 0, &face))
+    {
+        /* Destroy FreeType library */
+        FT_Done_FreeType(ft);
+
+        printf("Error: Failed to load TrueType font '%s'\n", p_file);
+        return NULL;
+    }
+
+    /* Rasterize glyphs 'SDF_UPSCALE' times larger than the distance fields */
+    if (FT_Set_Pixel_Sizes(face, 0, SDF_CHAR_SIZE * SDF_UPSCALE))
+    {
+        /* Destroy FreeType library */
+        FT_Done_Face(face);
+        FT_Done_FreeType(ft);
+
+        printf("Error: Failed to set pixel size to '%d'\n",
+               SDF_CHAR_SIZE * SDF_UPSCALE);
+        return NULL;
+    }
+
+    /* Allocate font.
+     * Note: Glyph metrics are kept in pixels of the rasterized glyphs, so
+     * that advances do not lose precision when text is scaled up */
+    p_font = (ttf_sdf_font_t *)calloc(1, sizeof(ttf_sdf_font_t));
+
+    p_font->size      = SDF_CHAR_SIZE * SDF_UPSCALE;
+    p_font->spread    = SDF_SPREAD * SDF_UPSCALE;
+    p_font->width     = SDF_ATLAS_WIDTH;
+    p_font->pp_glyphs = calloc(GLYPH_ARRAY_LEN, sizeof(glyph_t *));
+
+    /* Generate distance fields of first 128 characters of ASCII set and
+     * place them in rows of the atlas */
+    for (c = 0; c < GLYPH_ARRAY_LEN; c++)
+    {
+        /* Skip characters without glyph (such as control characters), so
+         * that the atlas does not waste space on 'missing glyph' boxes */
+        if ((FT_Get_Char_Index(face, c) == 0) ||
+            FT_Load_Char(face, c, FT_LOAD_RENDER))
+        {
+            continue;
+        }
+
+        p_glyph = (glyph_t *)malloc(sizeof(glyph_t));
+
+        p_fields[c] = sdf_generate_glyph(face->glyph, p_glyph);
+        p_font->pp_glyphs[c] = p_glyph;
+
+        width  = p_glyph->width  / SDF_UPSCALE;
+        height = p_glyph->height / SDF_UPSCALE;
+
+        /* Move to the next row if the glyph does not fit in this one */
+        if ((pos_x + width + SDF_ATLAS_GAP) > SDF_ATLAS_WIDTH)
+        {
+            pos_x  = SDF_ATLAS_GAP;
+            pos_y += row_height + SDF_ATLAS_GAP;
+
+            row_height = 0;
+        }
+
+        /* Temporarily store position of the glyph (in texels) */
+        p_glyph->tex_left = pos_x;
+        p_glyph->tex_top  = pos_y;
+
+        pos_x += width + SDF_ATLAS_GAP;
+        row_height = (height > row_height) ? height : row_height;
+    }
+
+    /* Destroy FreeType library */
+    FT_Done_Face(face);
+    FT_Done_FreeType(ft);
+
+    /* Copy distance fields to the atlas */
+    p_font->height = pos_y + row_height + SDF_ATLAS_GAP;
+    p_atlas = (unsigned char *)calloc(p_font->width * p_font->height, 1);
+
+    for (c = 0; c < GLYPH_ARRAY_LEN; c++)
+    {
+        p_glyph = p_font->pp_glyphs[c];
+        if (p_glyph == NULL)
+        {
+            continue;
+        }
+
+        width  = p_glyph->width  / SDF_UPSCALE;
+        height = p_glyph->height / SDF_UPSCALE;
+
+        for (row = 0; row < height; row++)
+        {
+            memcpy(p_atlas + (((int)p_glyph->tex_top + row) * p_font->width) +
+                   (int)p_glyph->tex_left, p_fields[c] + (row * width), width);
+        }
+
+        free(p_fields[c]);
+
+        /* Convert position of the glyph to texture coordinates */
+        p_glyph->tex_right  = (p_glyph->tex_left + width)  / p_font->width;
+        p_glyph->tex_bottom = (p_glyph->tex_top  + height) / p_font->height;
+        p_glyph->tex_left   = p_glyph->tex_left / p_font->width;
+        p_glyph->tex_top    = p_glyph->tex_top  / p_font->height;
+    }
+
+    /* Disable byte-alignment restriction */
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    /* Generate the atlas.
+     * Note: Distance fields are meant to be filtered linearly */
+    glGenTextures(1, &(p_font->tex_id));
+    glBindTexture(GL_TEXTURE_2D, p_font->tex_id);
+
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, p_font->width, p_font->height, 0,
+                 GL_RED, GL_UNSIGNED_BYTE, p_atlas);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    /* Unbind currently bound texture */
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    /* Enable byte-alignment restriction */
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    free(p_atlas);
+
+    /* All glyphs share the atlas */
+    for (c = 0; c < GLYPH_ARRAY_LEN; c++)
+    {
+        if (p_font->pp_glyphs[c] != NULL)
+        {
+            p_font->pp_glyphs[c]->tex_id = p_font->tex_id;
+        }
+    }
+
+    return p_font;
+}
+
+void ttf_delete_sdf_font(ttf_sdf_font_t * p_font)
+{
+    unsigned char c = 0;
+
+    /* Check parameter */
+    assert(p_font != NULL);
+
+    /* The glyphs do not own the atlas. So, delete it only once */
+    glDeleteTextures(1, &(p_font->tex_id));
+
+    for (c = 0; c < GLYPH_ARRAY_LEN; c++)
+    {
+        free(p_font->pp_glyphs[c]);
+    }
+
+    free(p_font->pp_glyphs);
+    free(p_font);
+}
+
+/******************************************************************************
+ *                         STATIC FUNCTION DEFINITION                         *
+ ******************************************************************************/
+
+static void sdf_compare(sdf_offset_t * p_grid, int width,
+                        int x, int y, int off_x, int off_y)
+{
+    sdf_offset_t * p_cur = p_grid + (y * width) + x;
+    sdf_offset_t other   = p_grid[((y + off_y) * width) + x + off_x];
+
+    /* Offset from current pixel to the closest seed of its neighbor */
+    other.dx += off_x;
+    other.dy += off_y;
+
+    if (((other.dx * other.dx) + (other.dy * other.dy)) <
+        ((p_cur->dx * p_cur->dx) + (p_cur->dy * p_cur->dy)))
+    {
+        *p_cur = other;
+    }
+}
+
+static void sdf_propagate(sdf_offset_t * p_grid, int width, int height)
+{
+    int x = 0;
+    int y = 0;
+
+    /* 8-points signed sequential Euclidean distance transform (8SSEDT).
+     * Offsets to the closest seeds are propagated in 2 passes over the grid.
+     *
+     * Note: Pixels on the border of the grid are never updated, so that
+     *       neighbors can be read without bound checks */
+    for (y = 1; y < (height - 1); y++)
+    {
+        for (x = 1; x < (width - 1); x++)
+        {
+            sdf_compare(p_grid, width, x, y, -1,  0);
+            sdf_compare(p_grid, width, x, y,  0, -1);
+            sdf_compare(p_grid, width, x, y, -1, -1);
+            sdf_compare(p_grid, width, x, y,  1, -1);
+        }
+
+        for (x = width - 2; x > 0; x--)
+        {
+            sdf_compare(p_grid, width, x, y, 1, 0);
+        }
+    }
+
+    for (y = height - 2; y > 0; y--)
+    {
+        for (x = width - 2; x > 0; x--)
+        {
+            sdf_compare(p_grid, width, x, y,  1, 0);
+            sdf_compare(p_grid, width, x, y,  0, 1);
+            sdf_compare(p_grid, width, x, y, -1, 1);
+            sdf_compare(p_grid, width, x, y,  1, 1);
+        }
+
+        for (x = 1; x < (width - 1); x++)
+        {
+            sdf_compare(p_grid, width, x, y, -1, 0);
+        }
+    }
+}
+
+static float * sdf_compute(const FT_Bitmap * p_bitmap, int pad,
+                           int * p_width, int * p_height)
+{
+    sdf_offset_t * p_inner = NULL; /* Offsets to the closest inner pixel */
+    sdf_offset_t * p_outer = NULL; /* Offsets to the closest outer pixel */
+
+    float * p_field = NULL;
+
+    int x = 0;
+    int y = 0;
+    int index = 0;
+
+    int width  = p_bitmap->width + (2 * pad);
+    int height = p_bitmap->rows  + (2 * pad);
+
+    bool b_inside = false;
+
+    const sdf_offset_t seed = { 0, 0 };
+    const sdf_offset_t far  = { SDF_FAR_OFFSET, SDF_FAR_OFFSET };
+
+    p_inner = (sdf_offset_t *)malloc(width * height * sizeof(sdf_offset_t));
+    p_outer = (sdf_offset_t *)malloc(width * height * sizeof(sdf_offset_t));
+    p_field = (float *)malloc(width * height * sizeof(float));
+
+    /* A pixel is inside the glyph if it is covered by at least 50% */
+    for (y = 0; y < height; y++)
+    {
+        for (x = 0; x < width; x++)
+        {
+            index = (y * width) + x;
+
+            b_inside = (x >= pad) && (x < (width  - pad)) &&
+                       (y >= pad) && (y < (height - pad)) &&
+                       (p_bitmap->buffer[((y - pad) * p_bitmap->pitch) +
+                                         (x - pad)] >= 128);
+
+            p_inner[index] = b_inside ? seed : far;
+            p_outer[index] = b_inside ? far  : seed;
+        }
+    }
+
+    sdf_propagate(p_inner, width, height);
+    sdf_propagate(p_outer, width, height);
+
+    /* Signed distance (in pixels) is positive inside the glyph */
+    for (index = 0; index < (width * height); index++)
+    {
+        p_field[index] = sqrtf((p_outer[index].dx * p_outer[index].dx) +
+                               (p_outer[index].dy * p_outer[index].dy)) -
+                         sqrtf((p_inner[index].dx * p_inner[index].dx) +
+                               (p_inner[index].dy * p_inner[index].dy));
+    }
+
+    free(p_inner);
+    free(p_outer);
+
+    *p_width  = width;
+    *p_height = height;
+
+    return p_field;
+}
+
+static unsigned char * sdf_generate_glyph(FT_GlyphSlot slot, glyph_t * p_glyph)
+{
+    unsigned char * p_cell = NULL;
+    float * p_field = NULL;
+
+    /* Padding (in rasterized pixels) around the bitmap, so that the field
+     * covers the whole spread */
+    const int pad = (SDF_SPREAD + 1) * SDF_UPSCALE;
+
+    int field_w = 0;
+    int field_h = 0;
+
+    /* Cell of the glyph in the atlas (in texels, relative to the origin) */
+    int cell_left   = 0;
+    int cell_top    = 0;
+    int cell_right  = 0;
+    int cell_bottom = 0;
+
+    int col = 0;
+    int row = 0;
+
+    int field_x = 0;
+    int field_y = 0;
+
+    float dist = 0.0f;
+
+    p_field = sdf_compute(&(slot->bitmap), pad, &field_w, &field_h);
+
+    /* The cell covers the bitmap and the spread around it */
+    cell_left   = floor_div(slot->bitmap_left, SDF_UPSCALE) - SDF_SPREAD;
+    cell_right  = -floor_div(-(slot->bitmap_left + (int)slot->bitmap.width),
+                             SDF_UPSCALE) + SDF_SPREAD;
+    cell_top    = -floor_div(-slot->bitmap_top, SDF_UPSCALE) + SDF_SPREAD;
+    cell_bottom = floor_div(slot->bitmap_top - (int)slot->bitmap.rows,
+                            SDF_UPSCALE) - SDF_SPREAD;
+
+    p_cell = (unsigned char *)malloc((cell_right - cell_left) *
+                                     (cell_top - cell_bottom));
+
+    /* Sample the field at the center of each texel */
+    for (row = 0; row < (cell_top - cell_bottom); row++)
+    {
+        field_y = pad + (int)floorf(slot->bitmap_top -
+                                    ((cell_top - row - 0.5f) * SDF_UPSCALE));
+
+        for (col = 0; col < (cell_right - cell_left); col++)
+        {
+            field_x = pad + (int)floorf(((cell_left + col + 0.5f) *
+                                         SDF_UPSCALE) - slot->bitmap_left);
+
+            dist = -(float)pad;
+            if ((field_x >= 0) && (field_x < field_w) &&
+                (field_y >= 0) && (field_y < field_h))
+            {
+                dist = p_field[(field_y * field_w) + field_x];
+            }
+
+            /* Map [-spread, spread] to [0, 1] */
+            dist = 0.5f + (dist / (2.0f * SDF_SPREAD * SDF_UPSCALE));
+            dist = (dist < 0.0f) ? 0.0f : ((dist > 1.0f) ? 1.0f : dist);
+
+            p_cell[(row * (cell_right - cell_left)) + col] =
+                                                (unsigned char)(dist * 255.0f);
+        }
+    }
+
+    free(p_field);
+
+    /* Metrics are in rasterized pixels */
+    p_glyph->width    = (cell_right - cell_left) * SDF_UPSCALE;
+    p_glyph->height   = (cell_top - cell_bottom) * SDF_UPSCALE;
+    p_glyph->offset_x = cell_left * SDF_UPSCALE;
+    p_glyph->offset_y = cell_top  * SDF_UPSCALE;
+    p_glyph->advance  = slot->advance.x >> 6;
+
+    return p_cell;
+}
+
+static int floor_div(int val, int div)
+{
+    /* Unlike operator '/', round toward negative infinity */
+    return (val >= 0) ? (val / div) : -((-val + div - 1) / div);
+}
@@ -155,6 +155,46 @@ char * util_read_file(const char * p_name)
     return p_content;
 }
 
+char * util_read_bin_file(const char * p_name, size_t * p_size)
+{
+    long size = -1;
+    char * p_content = NULL;
+
+    /* Check parameters */
+    assert((p_name != NULL) && (p_size != NULL));
+
+    /* Open file */
+    FILE * p_fd = fopen(p_name, "rb");
+    if (p_fd != NULL)
+    {
+        /* Get file's size */
+        fseek(p_fd, 0, SEEK_END);
+        size = ftell(p_fd);
+        rewind(p_fd);
+
+        if (size > 0)
+        {
+            /* Read file's content and put it into buffer */
+            p_content = (char *)malloc(size);
+
+            if (fread(p_content, 1, size, p_fd) == (size_t)size)
+            {
+                *p_size = size;
+            }
+            else
+            {
+                free(p_content);
+                p_content = NULL;
+            }
+        }
+
+        /* Close file */
+        fclose(p_fd);
+    }
+
+    return p_content;
+}
+
 void util_write_file(const char * p_name, const char * p_buffer, size_t size)
 {
     /* Check parameters */
@@ -171,3 +211,23 @@ void util_write_file(const char * p_name, const char * p_buffer, size_t size)
         fclose(p_fd);
     }
 }
+
+/********************************** FOR HASH **********************************/
+
+uint64_t util_hash(uint64_t hash, const void * p_data, size_t size)
+{
+    size_t index = 0;
+    const uint8_t * p_bytes = (const uint8_t *)p_data;
+
+    /* Check parameter */
+    assert(p_data != NULL);
+
+    /* FNV-1a: http://www.isthe.com/chongo/tech/comp/fnv/index.html */
+    for (index = 0; index < size; index++)
+    {
+        hash ^= p_bytes[index];
+        hash *= 0x100000001b3ULL;
+    }
+
+    return hash;
+}
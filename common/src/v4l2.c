@@ -20,6 +20,7 @@
 #include <string.h>
 #include <unistd.h>
 
+#include <poll.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/ioctl.h>
@@ -571,6 +572,29 @@ bool v4l2_dequeue_buf(int dev_fd, struct v4l2_buffer * p_buf)
     return true;
 }
 
+bool v4l2_is_buf_ready(int dev_fd)
+{
+    struct pollfd poll_fd;
+
+    /* Check parameter */
+    assert(dev_fd > 0);
+
+    /* The device is readable when the outgoing queue has a filled buffer.
+     * With timeout 0, 'poll' returns immediately:
+     * https://www.kernel.org/doc/html/v4.9/media/uapi/v4l/func-poll.html */
+    poll_fd.fd      = dev_fd;
+    poll_fd.events  = POLLIN;
+    poll_fd.revents = 0;
+
+    if (poll(&poll_fd, 1, 0) == -1)
+    {
+        util_print_errno();
+        return false;
+    }
+
+    return (poll_fd.revents & POLLIN) != 0;
+}
+
 bool v4l2_enable_capturing(int dev_fd)
 {
     enum v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
@@ -10,6 +10,20 @@
 #include <pthread.h>
 
 #include "gl.h"
+#include "overlay.h"
+#include "batch.h"
+#include "image.h"
+#include "shader.h"
+#include "perf.h"
+#include "lens.h"
+#include "denoise.h"
+#include "mask.h"
+#include "motion.h"
+#include "snapshot.h"
+#include "pip.h"
+#include "stabilize.h"
+#include "timestamp.h"
+#include "ipc.h"
 #include "egl.h"
 #include "omx.h"
 #include "util.h"
@@ -24,6 +38,29 @@
 
 #define FONT_FILE "LiberationSans-Regular.ttf"
 
+/* Color standard and range of camera, used to select shader variants.
+ * For example, '(SHADER_BT709 | SHADER_LIMITED_RANGE)' */
+#define CAM_COLOR_FLAGS 0
+
+/* Sprite sheet of 4 frames (in 1 row) and the size of image atlas */
+#define SPINNER_FILE "spinner.png"
+#define SPINNER_COLS 4
+
+#define IMAGE_ATLAS_SIZE 512
+
+/* The sprite shows its next frame after this number of video frames */
+#define SPINNER_FRAME_INTERVAL 8
+
+/* Internal format of overlay layer. 'GL_RGBA4' or 'GL_RGB5_A1' halve its
+ * memory and the bandwidth of redrawing and blending it (see option '-p') */
+#define OVERLAY_FORMAT GL_RGBA8
+
+/* The maximum number of shapes drawn with a single draw call */
+#define MAX_SHAPE_COUNT 256
+
+/* The maximum number of vertices of polygons drawn with a single draw call */
+#define MAX_POLYGON_VERT_COUNT 1024
+
 /********************************** FOR V4L2 **********************************/
 
 /* The sample app is tested OK with:
@@ -60,6 +97,20 @@
 
 #define H264_FILE_NAME "output.264"
 
+/******************************** FOR STREAMS *********************************/
+
+/* The main stream has the output size (option '-o'). The optional sub-stream
+ * (option '-s') is a downscaled copy of the main stream, for remote preview
+ * or analytics. Each stream has its own encoder and file */
+#define MAIN_STREAM 0
+#define SUB_STREAM  1
+
+#define MAX_STREAM_COUNT 2
+
+#define H264_SUB_BITRATE 1000000 /* 1 Mbit/s */
+
+#define H264_SUB_FILE_NAME "output-sub.264"
+
 /******************************************************************************
  *                              GLOBAL VARIABLES                              *
  ******************************************************************************/
@@ -67,6 +118,9 @@
 /* 1: Interrupt signal */
 volatile sig_atomic_t g_int_signal = 0;
 
+/* 1: Snapshot is requested ('SIGUSR1') */
+volatile sig_atomic_t g_snapshot_signal = 0;
+
 /******************************************************************************
  *                           STRUCTURE DEFINITIONS                            *
  ******************************************************************************/
@@ -87,6 +141,40 @@ typedef struct
 
 } omx_data_t;
 
+/* This structure contains the encoder of a stream and its buffers */
+typedef struct
+{
+    /* Size of NV12 frames */
+    size_t width;
+    size_t height;
+
+    /* NV12 buffers */
+    mmngr_buf_t * p_nv12_bufs;
+
+    /* Handle of media component */
+    OMX_HANDLETYPE handle;
+
+    /* Buffers for input and output ports */
+    OMX_BUFFERHEADERTYPE ** pp_in_bufs;
+    OMX_BUFFERHEADERTYPE ** pp_out_bufs;
+
+    /* Queues for buffers of input and output ports */
+    queue_t in_queue;
+    queue_t out_queue;
+
+    /* Mutexes for condition variables */
+    pthread_mutex_t mut_in;
+    pthread_mutex_t mut_out;
+
+    /* Condition variables */
+    pthread_cond_t cond_in_available;
+    pthread_cond_t cond_out_available;
+
+    /* Shared data between OMX's callbacks */
+    omx_data_t omx_data;
+
+} encoder_t;
+
 /******************************** FOR THREADS *********************************/
 
 /* This structure is for input thread */
@@ -101,29 +189,57 @@ typedef struct
     /* Frame height of camera */
     size_t cam_height;
 
-    /* YUYV buffers */
-    v4l2_dmabuf_exp_t * p_yuyv_bufs;
+    /* Digital zoom into the center of camera frame */
+    float zoom;
 
-    /* NV12 buffers */
-    mmngr_buf_t * p_nv12_bufs;
+    /* Rotation and mirroring of camera frame */
+    uint32_t rotation;
+    bool b_mirror_x;
+    bool b_mirror_y;
 
-    /* Handle of media component */
-    OMX_HANDLETYPE handle;
+    /* Radial distortion coefficients of lens */
+    float lens_k1;
+    float lens_k2;
 
-    /* Buffers for input port */
-    OMX_BUFFERHEADERTYPE ** pp_bufs;
+    /* Max weight of previous frame in temporal denoise (0: no denoise) */
+    float denoise;
 
-    /* The queue contains some buffers in 'pp_bufs' ready to be overlaid and
-     * sent to input port */
-    queue_t * p_queue;
+    /* File of privacy masks (NULL if there are no masks) */
+    const char * p_mask_file;
 
-    /* The mutex structure is used to synchronize 'wait' and 'signal' events
-     * of 'p_cond_available' */
-    pthread_mutex_t * p_mutex;
+    /* File which results of motion detection are written to (NULL if motion
+     * is not detected) */
+    const char * p_motion_file;
 
-    /* When signaled, the condition variable confirms there is a possible
-     * buffer in 'p_queue' */
-    pthread_cond_t * p_cond_available;
+    /* Prefix of snapshot files (NULL if snapshots are disabled) */
+    const char * p_snapshot_prefix;
+
+    /* Device file of the second camera (NULL if there is none) and area of
+     * its inset (size is 0 for the default area) */
+    const char * p_pip_dev;
+    rect_t pip_area;
+
+    /* Stabilize camera frames */
+    bool b_stabilize;
+
+    /* Burn capture time and frame counter into frames */
+    bool b_timestamp;
+
+    /* Name of shared memory for overlay commands of external processes
+     * (NULL if it's not created) */
+    const char * p_ipc_name;
+
+    /* YUYV buffers */
+    v4l2_dmabuf_exp_t * p_yuyv_bufs;
+
+    /* Encoders of streams ('MAIN_STREAM' first).
+     * Their input queues contain buffers ready to be overlaid and sent to
+     * input ports */
+    encoder_t * p_encs;
+    uint32_t enc_count;
+
+    /* Profile render passes on the GPU */
+    bool b_perf;
 
 } in_data_t;
 
@@ -133,6 +249,9 @@ typedef struct
     /* Handle of media component */
     OMX_HANDLETYPE handle;
 
+    /* File for writing H.264 data */
+    const char * p_file;
+
     /* This queue contains some buffers received from output port and ready
      * to be written to output file */
     queue_t * p_queue;
@@ -155,6 +274,8 @@ typedef struct
 
 void sigint_handler(int signum, siginfo_t * p_info, void * p_ptr);
 
+void sigusr1_handler(int signum, siginfo_t * p_info, void * p_ptr);
+
 /********************************** FOR OMX ***********************************/
 
 /* The method is used to notify the application when an event of interest
@@ -198,6 +319,18 @@ OMX_ERRORTYPE omx_fill_buffer_done(OMX_HANDLETYPE hComponent,
                                    OMX_PTR pAppData,
                                    OMX_BUFFERHEADERTYPE * pBuffer);
 
+/******************************** FOR STREAMS *********************************/
+
+/* Allocate NV12 buffers of 'width' x 'height' frames and set up encoder for
+ * them. Then, make the encoder ready to send/receive buffers.
+ *
+ * Note: Call 'OMX_Init' first */
+void encoder_create(encoder_t * p_enc, size_t width, size_t height,
+                    OMX_U32 bitrate, framerate_t framerate);
+
+/* Stop encoder, then free its buffers and NV12 buffers */
+void encoder_delete(encoder_t * p_enc);
+
 /******************************** FOR THREADS *********************************/
 
 /* Try to call 'OMX_EmptyThisBuffer' whenerver there is an available
@@ -228,6 +361,30 @@ int main(int argc, char * p_argv[])
     opt.height        = DEFAULT_FRAME_HEIGHT;
     opt.framerate.num = DEFAULT_FRAME_RATE;
     opt.framerate.den = 1;
+    opt.out_width     = 0;
+    opt.out_height    = 0;
+    opt.sub_width     = 0;
+    opt.sub_height    = 0;
+    opt.zoom          = 1.0f;
+    opt.rotation      = 0;
+    opt.b_mirror_x    = false;
+    opt.b_mirror_y    = false;
+    opt.nv12_writer   = NV12_WRITER_AUTO;
+    opt.lens_k1       = 0.0f;
+    opt.lens_k2       = 0.0f;
+    opt.denoise       = 0.0f;
+    opt.mask_file[0]  = '\0';
+    opt.motion_file[0] = '\0';
+    opt.snapshot_prefix[0] = '\0';
+    opt.pip_dev[0]    = '\0';
+    opt.pip_x         = 0;
+    opt.pip_y         = 0;
+    opt.pip_width     = 0;
+    opt.pip_height    = 0;
+    opt.b_stabilize   = false;
+    opt.b_timestamp   = false;
+    opt.ipc_name[0]   = '\0';
+    opt.b_perf        = false;
 
     /* Interrupt signal */
     struct sigaction sig_act;
@@ -244,46 +401,17 @@ int main(int argc, char * p_argv[])
 
     v4l2_dmabuf_exp_t * p_yuyv_bufs = NULL;
 
-    /* NV12 buffers */
-    mmngr_buf_t * p_nv12_bufs = NULL;
-
-    /* Handle of media component */
-    OMX_HANDLETYPE handle;
-
-    /* Callbacks used by media component */
-    OMX_CALLBACKTYPE callbacks =
-    {
-        .EventHandler    = omx_event_handler,
-        .EmptyBufferDone = omx_empty_buffer_done,
-        .FillBufferDone  = omx_fill_buffer_done
-    };
-
-    /* Buffers for input and output ports */
-    OMX_BUFFERHEADERTYPE ** pp_in_bufs  = NULL;
-    OMX_BUFFERHEADERTYPE ** pp_out_bufs = NULL;
-
-    /* Queues for buffers of input and output ports */
-    queue_t in_queue;
-    queue_t out_queue;
-
-    /* Shared data between OMX's callbacks */
-    omx_data_t omx_data;
+    /* Encoders of main stream and sub-stream */
+    encoder_t encs[MAX_STREAM_COUNT];
+    uint32_t enc_count = 1;
 
     /* Data for threads */
     in_data_t  in_data;
-    out_data_t out_data;
+    out_data_t out_data[MAX_STREAM_COUNT];
 
     /* Threads */
     pthread_t thread_in;
-    pthread_t thread_out;
-
-    /* Mutexes for condition variables */
-    pthread_mutex_t mut_in;
-    pthread_mutex_t mut_out;
-
-    /* Condition variables */
-    pthread_cond_t cond_in_available;
-    pthread_cond_t cond_out_available;
+    pthread_t thread_out[MAX_STREAM_COUNT];
 
     /**************************************************************************
      *                STEP 1: SET UP INTERRUPT SIGNAL HANDLER                 *
@@ -307,6 +435,15 @@ int main(int argc, char * p_argv[])
     assert((opt.width > 0) && (opt.height > 0));
     assert(IS_FRAMERATE_VALID(opt.framerate));
 
+    /* Take a snapshot on 'SIGUSR1' only if option '-j' is given. Otherwise,
+     * the signal keeps its default action */
+    if (opt.snapshot_prefix[0] != '\0')
+    {
+        sig_act.sa_sigaction = sigusr1_handler;
+
+        sigaction(SIGUSR1, &sig_act, NULL);
+    }
+
     /* Open camera */
     cam_fd = v4l2_open_dev(opt.cam_dev);
     assert(cam_fd != -1);
@@ -358,108 +495,27 @@ int main(int argc, char * p_argv[])
     }
 
     /**************************************************************************
-     *               STEP 4: USE MMNGR TO ALLOCATE NV12 BUFFERS               *
-     **************************************************************************/
-
-    p_nv12_bufs = mmngr_alloc_nv12_dmabufs(NV12_BUFFER_COUNT,
-                                           NV12_FRAME_SZ(opt.width,
-                                                         opt.height));
-    assert(p_nv12_bufs != NULL);
-
-    /**************************************************************************
-     *                         STEP 5: SET UP OMX IL                          *
+     *                        STEP 4: SET UP ENCODERS                         *
      **************************************************************************/
 
     /* Initialize OMX IL core */
     assert(OMX_Init() == OMX_ErrorNone);
 
-    /* Locate Renesas's H.264 encoder.
-     * If successful, the component will be in state LOADED */
-    assert(OMX_ErrorNone == OMX_GetHandle(&handle,
-                                          RENESAS_VIDEO_ENCODER_NAME,
-                                          (OMX_PTR)&omx_data, &callbacks));
-
-    /* Print role of the component to console */
-    omx_print_mc_role(handle);
-
-    /* Configure input port */
-    assert(omx_set_in_port_fmt(handle, opt.width, opt.height,
-                               OMX_COLOR_FormatYUV420SemiPlanar));
-
-    assert(omx_set_port_buf_cnt(handle, 0, NV12_BUFFER_COUNT));
-
-    /* Configure output port */
-    assert(omx_set_out_port_fmt(handle, H264_BITRATE,
-                                OMX_VIDEO_CodingAVC, opt.framerate));
-
-    assert(omx_set_port_buf_cnt(handle, 1, H264_BUFFER_COUNT));
-
-    /* Transition into state IDLE */
-    assert(OMX_ErrorNone == OMX_SendCommand(handle,
-                                            OMX_CommandStateSet,
-                                            OMX_StateIdle, NULL));
-
-    /**************************************************************************
-     *                STEP 6: ALLOCATE BUFFERS FOR INPUT PORT                 *
-     **************************************************************************/
-
-    pp_in_bufs = omx_use_buffers(handle, 0, p_nv12_bufs, NV12_BUFFER_COUNT);
-    assert(pp_in_bufs != NULL);
-
-    /* Create queue from these buffers */
-    in_queue = queue_create_full(pp_in_bufs, NV12_BUFFER_COUNT,
-                                 sizeof(OMX_BUFFERHEADERTYPE *));
-
-    /**************************************************************************
-     *                STEP 7: ALLOCATE BUFFERS FOR OUTPUT PORT                *
-     **************************************************************************/
-
-    pp_out_bufs = omx_alloc_buffers(handle, 1);
-    assert(pp_out_bufs != NULL);
-
-    /* Create empty queue whose size is equal to 'pp_out_bufs' */
-    out_queue = queue_create_empty(H264_BUFFER_COUNT,
-                                   sizeof(OMX_BUFFERHEADERTYPE *));
-
-    /* Wait until the component is in state IDLE */
-    omx_wait_state(handle, OMX_StateIdle);
-
-    /**************************************************************************
-     *             STEP 8: CREATE MUTEXES AND CONDITION VARIABLES             *
-     **************************************************************************/
-
-    pthread_mutex_init(&mut_in, NULL);
-    pthread_mutex_init(&mut_out, NULL);
-
-    pthread_cond_init(&cond_in_available, NULL);
-    pthread_cond_init(&cond_out_available, NULL);
-
-    /**************************************************************************
-     *          STEP 9: PREPARE SHARED DATA BETWEEN OMX'S CALLBACKS           *
-     **************************************************************************/
-
-    omx_data.p_in_queue           = &in_queue;
-    omx_data.p_out_queue          = &out_queue;
-    omx_data.p_mut_in             = &mut_in;
-    omx_data.p_mut_out            = &mut_out;
-    omx_data.p_cond_in_available  = &cond_in_available;
-    omx_data.p_cond_out_available = &cond_out_available;
-
-    /**************************************************************************
-     *            STEP 10: MAKE OMX READY TO SEND/RECEIVE BUFFERS             *
-     **************************************************************************/
+    /* Set up encoder of main stream */
+    encoder_create(&encs[MAIN_STREAM], opt.out_width, opt.out_height,
+                   H264_BITRATE, opt.framerate);
 
-    /* Transition into state EXECUTING */
-    assert(OMX_ErrorNone == OMX_SendCommand(handle,
-                                            OMX_CommandStateSet,
-                                            OMX_StateExecuting, NULL));
-    omx_wait_state(handle, OMX_StateExecuting);
+    /* Set up encoder of sub-stream if it's requested */
+    if ((opt.sub_width > 0) && (opt.sub_height > 0))
+    {
+        encoder_create(&encs[SUB_STREAM], opt.sub_width, opt.sub_height,
+                       H264_SUB_BITRATE, opt.framerate);
 
-    /* Send buffers in 'pp_out_bufs' to output port */
-    assert(omx_fill_buffers(handle, pp_out_bufs, H264_BUFFER_COUNT));
+        enc_count++;
+    }
 
     /**************************************************************************
-     *                    STEP 11: PREPARE CAPTURING DATA                     *
+     *                     STEP 5: PREPARE CAPTURING DATA                     *
      **************************************************************************/
 
     /* For capturing applications, it is customary to first enqueue all
@@ -472,94 +528,96 @@ int main(int argc, char * p_argv[])
     assert(v4l2_enable_capturing(cam_fd));
 
     /**************************************************************************
-     *                 STEP 12: PREPARE DATA FOR INPUT THREAD                 *
+     *                 STEP 6: PREPARE DATA FOR INPUT THREAD                  *
      **************************************************************************/
 
-    in_data.cam_fd           = cam_fd;
-    in_data.cam_width        = opt.width;
-    in_data.cam_height       = opt.height;
-    in_data.p_yuyv_bufs      = p_yuyv_bufs;
-    in_data.p_nv12_bufs      = p_nv12_bufs;
-    in_data.handle           = handle;
-    in_data.pp_bufs          = pp_in_bufs;
-    in_data.p_queue          = &in_queue;
-    in_data.p_mutex          = &mut_in;
-    in_data.p_cond_available = &cond_in_available;
+    in_data.cam_fd      = cam_fd;
+    in_data.cam_width   = opt.width;
+    in_data.cam_height  = opt.height;
+    in_data.zoom        = opt.zoom;
+    in_data.rotation    = opt.rotation;
+    in_data.b_mirror_x  = opt.b_mirror_x;
+    in_data.b_mirror_y  = opt.b_mirror_y;
+    in_data.lens_k1     = opt.lens_k1;
+    in_data.lens_k2     = opt.lens_k2;
+    in_data.denoise     = opt.denoise;
+    in_data.p_mask_file = (opt.mask_file[0] != '\0') ? opt.mask_file : NULL;
+
+    in_data.p_motion_file = (opt.motion_file[0] != '\0') ? opt.motion_file :
+                                                           NULL;
+
+    in_data.p_snapshot_prefix = (opt.snapshot_prefix[0] != '\0') ?
+                                opt.snapshot_prefix : NULL;
+
+    in_data.p_pip_dev       = (opt.pip_dev[0] != '\0') ? opt.pip_dev : NULL;
+    in_data.pip_area.x      = opt.pip_x;
+    in_data.pip_area.y      = opt.pip_y;
+    in_data.pip_area.width  = opt.pip_width;
+    in_data.pip_area.height = opt.pip_height;
+
+    in_data.b_stabilize = opt.b_stabilize;
+    in_data.b_timestamp = opt.b_timestamp;
+    in_data.p_ipc_name  = (opt.ipc_name[0] != '\0') ? opt.ipc_name : NULL;
+
+    in_data.p_yuyv_bufs = p_yuyv_bufs;
+    in_data.p_encs      = encs;
+    in_data.enc_count   = enc_count;
+    in_data.b_perf      = opt.b_perf;
 
     /**************************************************************************
-     *                STEP 13: PREPARE DATA FOR OUTPUT THREAD                 *
+     *                STEP 7: PREPARE DATA FOR OUTPUT THREADS                 *
      **************************************************************************/
 
-    out_data.handle           = handle;
-    out_data.p_queue          = &out_queue;
-    out_data.p_mutex          = &mut_out;
-    out_data.p_cond_available = &cond_out_available;
+    for (index = 0; index < enc_count; index++)
+    {
+        out_data[index].handle           = encs[index].handle;
+        out_data[index].p_file           = (index == MAIN_STREAM) ?
+                                           H264_FILE_NAME : H264_SUB_FILE_NAME;
+        out_data[index].p_queue          = &encs[index].out_queue;
+        out_data[index].p_mutex          = &encs[index].mut_out;
+        out_data[index].p_cond_available = &encs[index].cond_out_available;
+    }
 
     /**************************************************************************
-     *                          STEP 14: RUN THREADS                          *
+     *                          STEP 8: RUN THREADS                           *
      **************************************************************************/
 
     pthread_create(&thread_in, NULL, thread_input, &in_data);
-    pthread_create(&thread_out, NULL, thread_output, &out_data);
+
+    for (index = 0; index < enc_count; index++)
+    {
+        pthread_create(&thread_out[index], NULL,
+                       thread_output, &out_data[index]);
+    }
 
     /**************************************************************************
-     *                 STEP 15: WAIT UNTIL END-OF-STREAM EVENT                 *
+     *                 STEP 9: WAIT UNTIL END-OF-STREAM EVENT                 *
      **************************************************************************/
 
     pthread_join(thread_in, NULL);
-    pthread_join(thread_out, NULL);
+
+    for (index = 0; index < enc_count; index++)
+    {
+        pthread_join(thread_out[index], NULL);
+    }
 
     /* Stop capturing */
     assert(v4l2_disable_capturing(cam_fd));
 
     /**************************************************************************
-     *                          STEP 16: CLEAN UP OMX                         *
+     *                         STEP 10: CLEAN UP OMX                          *
      **************************************************************************/
 
-    pthread_mutex_destroy(&mut_in);
-    pthread_mutex_destroy(&mut_out);
-
-    pthread_cond_destroy(&cond_in_available);
-    pthread_cond_destroy(&cond_out_available);
-
-    /* Transition into state IDLE */
-    assert(OMX_ErrorNone == OMX_SendCommand(handle,
-                                            OMX_CommandStateSet,
-                                            OMX_StateIdle, NULL));
-    omx_wait_state(handle, OMX_StateIdle);
-
-    /* Transition into state LOADED */
-    assert(OMX_ErrorNone == OMX_SendCommand(handle,
-                                            OMX_CommandStateSet,
-                                            OMX_StateLoaded, NULL));
-
-    /* Release buffers and buffer headers from the component.
-     *
-     * The component shall free only the buffer headers if it allocated only
-     * the buffer headers ('OMX_UseBuffer').
-     *
-     * The component shall free both the buffers and the buffer headers if it
-     * allocated both the buffers and buffer headers ('OMX_AllocateBuffer') */
-    omx_dealloc_all_port_bufs(handle, 0, pp_in_bufs);
-    omx_dealloc_all_port_bufs(handle, 1, pp_out_bufs);
-
-    queue_delete(&in_queue);
-    queue_delete(&out_queue);
-
-    /* Wait until the component is in state LOADED */
-    omx_wait_state(handle, OMX_StateLoaded);
-
-    /* Free the component's handle */
-    assert(OMX_FreeHandle(handle) == OMX_ErrorNone);
+    for (index = 0; index < enc_count; index++)
+    {
+        encoder_delete(&encs[index]);
+    }
 
     /* Deinitialize OMX IL core */
     assert(OMX_Deinit() == OMX_ErrorNone);
 
-    /* Deallocate NV12 buffers */
-    mmngr_dealloc_nv12_dmabufs(p_nv12_bufs, NV12_BUFFER_COUNT);
-
     /**************************************************************************
-     *                     STEP 17: CLEAN UP V4L2 DEVICE                      *
+     *                     STEP 11: CLEAN UP V4L2 DEVICE                      *
      **************************************************************************/
 
     /* Clean up YUYV buffers */
@@ -587,6 +645,16 @@ void sigint_handler(int signum, siginfo_t * p_info, void * p_ptr)
     g_int_signal = 1;
 }
 
+void sigusr1_handler(int signum, siginfo_t * p_info, void * p_ptr)
+{
+    /* Mark parameters as unused */
+    UNUSED(p_ptr);
+    UNUSED(p_info);
+    UNUSED(signum);
+
+    g_snapshot_signal = 1;
+}
+
 /********************************** FOR OMX ***********************************/
 
 OMX_ERRORTYPE omx_event_handler(OMX_HANDLETYPE hComponent, OMX_PTR pAppData,
@@ -707,93 +775,603 @@ OMX_ERRORTYPE omx_fill_buffer_done(OMX_HANDLETYPE hComponent,
     return OMX_ErrorNone;
 }
 
-/******************************** FOR THREADS *********************************/
+/******************************** FOR STREAMS *********************************/
 
-void * thread_input(void * p_param)
+void encoder_create(encoder_t * p_enc, size_t width, size_t height,
+                    OMX_U32 bitrate, framerate_t framerate)
 {
-    in_data_t * p_data = (in_data_t *)p_param;
+    /* Callbacks used by media component.
+     * Note: It's static because the component may keep its address for the
+     *       rest of its life */
+    static OMX_CALLBACKTYPE callbacks =
+    {
+        .EventHandler    = omx_event_handler,
+        .EmptyBufferDone = omx_empty_buffer_done,
+        .FillBufferDone  = omx_fill_buffer_done
+    };
 
-    /* true:  The loop is running.
-     * false: The loop just stopped */
-    bool is_running = true;
+    /* Check parameters */
+    assert((p_enc != NULL) && (width > 0) && (height > 0));
 
-    /* V4L2 buffer */
-    struct v4l2_buffer cam_buf;
+    p_enc->width  = width;
+    p_enc->height = height;
 
-    /* Buffer of input port */
-    int index = -1;
-    OMX_BUFFERHEADERTYPE * p_buf = NULL;
+    /* Use MMNGR to allocate NV12 buffers */
+    p_enc->p_nv12_bufs = mmngr_alloc_nv12_dmabufs(NV12_BUFFER_COUNT,
+                                                  NV12_FRAME_SZ(width, height));
+    assert(p_enc->p_nv12_bufs != NULL);
 
-    /* EGL display, config, and context */
-    EGLDisplay display = EGL_NO_DISPLAY;
-    EGLContext context = EGL_NO_CONTEXT;
+    /* Locate Renesas's H.264 encoder.
+     * If successful, the component will be in state LOADED */
+    assert(OMX_ErrorNone == OMX_GetHandle(&(p_enc->handle),
+                                          RENESAS_VIDEO_ENCODER_NAME,
+                                          (OMX_PTR)&(p_enc->omx_data),
+                                          &callbacks));
 
-    EGLConfig config;
+    /* Print role of the component to console */
+    omx_print_mc_role(p_enc->handle);
 
-    /* OpenGL ES */
-    GLuint rec_prog = 0;
-    GLuint text_prog = 0;
-    GLuint yuyv_to_rgb_prog = 0;
-    GLuint rgb_to_nv12_prog = 0;
+    /* Configure input port */
+    assert(omx_set_in_port_fmt(p_enc->handle, width, height,
+                               OMX_COLOR_FormatYUV420SemiPlanar));
 
-    gl_res_t gl_res;
+    assert(omx_set_port_buf_cnt(p_enc->handle, 0, NV12_BUFFER_COUNT));
 
-    /* YUYV images and textures */
-    EGLImageKHR * p_yuyv_imgs = NULL;
-    GLuint      * p_yuyv_texs = NULL;
+    /* Configure output port */
+    assert(omx_set_out_port_fmt(p_enc->handle, bitrate,
+                                OMX_VIDEO_CodingAVC, framerate));
 
-    /* RGB textures and framebuffers */
-    GLuint * p_rgb_texs = NULL;
-    GLuint * p_rgb_fbs  = NULL;
+    assert(omx_set_port_buf_cnt(p_enc->handle, 1, H264_BUFFER_COUNT));
 
-    /* NV12 images, textures, and framebuffers */
-    EGLImageKHR * p_nv12_imgs = NULL;
-    GLuint      * p_nv12_texs = NULL;
-    GLuint      * p_nv12_fbs  = NULL;
+    /* Transition into state IDLE */
+    assert(OMX_ErrorNone == OMX_SendCommand(p_enc->handle,
+                                            OMX_CommandStateSet,
+                                            OMX_StateIdle, NULL));
 
-    /* Check parameter */
-    assert(p_data != NULL);
+    /* Allocate buffers for input port and create queue from them */
+    p_enc->pp_in_bufs = omx_use_buffers(p_enc->handle, 0,
+                                        p_enc->p_nv12_bufs, NV12_BUFFER_COUNT);
+    assert(p_enc->pp_in_bufs != NULL);
 
-    /**************************************************************************
-     *                           STEP 1: SET UP EGL                           *
-     **************************************************************************/
+    p_enc->in_queue = queue_create_full(p_enc->pp_in_bufs, NV12_BUFFER_COUNT,
+                                        sizeof(OMX_BUFFERHEADERTYPE *));
 
-    /* Connect to EGL display */
-    display = egl_connect_display(EGL_DEFAULT_DISPLAY, &config);
-    assert(display != EGL_NO_DISPLAY);
+    /* Allocate buffers for output port.
+     * Create empty queue whose size is equal to 'pp_out_bufs' */
+    p_enc->pp_out_bufs = omx_alloc_buffers(p_enc->handle, 1);
+    assert(p_enc->pp_out_bufs != NULL);
 
-    /* Create and bind EGL context */
-    context = egl_create_context(display, config, EGL_NO_SURFACE);
-    assert(context != EGL_NO_CONTEXT);
+    p_enc->out_queue = queue_create_empty(H264_BUFFER_COUNT,
+                                          sizeof(OMX_BUFFERHEADERTYPE *));
 
-    /* Initialize EGL extension functions */
-    assert(egl_init_ext_funcs(display));
+    /* Wait until the component is in state IDLE */
+    omx_wait_state(p_enc->handle, OMX_StateIdle);
 
-    /**************************************************************************
-     *                        STEP 2: SET UP OPENGL ES                        *
-     **************************************************************************/
+    /* Create mutexes and condition variables */
+    pthread_mutex_init(&(p_enc->mut_in), NULL);
+    pthread_mutex_init(&(p_enc->mut_out), NULL);
 
-    /* Create program object for drawing rectangle */
-    rec_prog = gl_create_prog_from_src("rectangle.vs.glsl",
-                                       "rectangle.fs.glsl");
+    pthread_cond_init(&(p_enc->cond_in_available), NULL);
+    pthread_cond_init(&(p_enc->cond_out_available), NULL);
 
-    /* Create program object for drawing text */
-    text_prog = gl_create_prog_from_src("text.vs.glsl", "text.fs.glsl");
+    /* Prepare shared data between OMX's callbacks */
+    p_enc->omx_data.p_in_queue           = &(p_enc->in_queue);
+    p_enc->omx_data.p_out_queue          = &(p_enc->out_queue);
+    p_enc->omx_data.p_mut_in             = &(p_enc->mut_in);
+    p_enc->omx_data.p_mut_out            = &(p_enc->mut_out);
+    p_enc->omx_data.p_cond_in_available  = &(p_enc->cond_in_available);
+    p_enc->omx_data.p_cond_out_available = &(p_enc->cond_out_available);
 
-    /* Create program object for converting YUYV to RGB */
-    yuyv_to_rgb_prog = gl_create_prog_from_src("yuyv-to-rgb.vs.glsl",
-                                               "yuyv-to-rgb.fs.glsl");
+    /* Transition into state EXECUTING */
+    assert(OMX_ErrorNone == OMX_SendCommand(p_enc->handle,
+                                            OMX_CommandStateSet,
+                                            OMX_StateExecuting, NULL));
+    omx_wait_state(p_enc->handle, OMX_StateExecuting);
 
-    /* Create program object for converting RGB to NV12 */
-    rgb_to_nv12_prog = gl_create_prog_from_src("rgb-to-nv12.vs.glsl",
-                                               "rgb-to-nv12.fs.glsl");
+    /* Send buffers in 'pp_out_bufs' to output port */
+    assert(omx_fill_buffers(p_enc->handle, p_enc->pp_out_bufs,
+                            H264_BUFFER_COUNT));
+}
 
-    /* Create resources needed for rendering */
-    gl_res = gl_create_resources(p_data->cam_width,
-                                 p_data->cam_height, FONT_FILE);
+void encoder_delete(encoder_t * p_enc)
+{
+    /* Check parameter */
+    assert(p_enc != NULL);
 
-    /* Initialize OpenGL ES extension functions */
-    assert(gl_init_ext_funcs());
+    pthread_mutex_destroy(&(p_enc->mut_in));
+    pthread_mutex_destroy(&(p_enc->mut_out));
+
+    pthread_cond_destroy(&(p_enc->cond_in_available));
+    pthread_cond_destroy(&(p_enc->cond_out_available));
+
+    /* Transition into state IDLE */
+    assert(OMX_ErrorNone == OMX_SendCommand(p_enc->handle,
+                                            OMX_CommandStateSet,
+                                            OMX_StateIdle, NULL));
+    omx_wait_state(p_enc->handle, OMX_StateIdle);
+
+    /* Transition into state LOADED */
+    assert(OMX_ErrorNone == OMX_SendCommand(p_enc->handle,
+                                            OMX_CommandStateSet,
+                                            OMX_StateLoaded, NULL));
+
+    /* Release buffers and buffer headers from the component.
+     *
+     * The component shall free only the buffer headers if it allocated only
+     * the buffer headers ('OMX_UseBuffer').
+     *
+     * The component shall free both the buffers and the buffer headers if it
+     * allocated both the buffers and buffer headers ('OMX_AllocateBuffer') */
+    omx_dealloc_all_port_bufs(p_enc->handle, 0, p_enc->pp_in_bufs);
+    omx_dealloc_all_port_bufs(p_enc->handle, 1, p_enc->pp_out_bufs);
+
+    queue_delete(&(p_enc->in_queue));
+    queue_delete(&(p_enc->out_queue));
+
+    /* Wait until the component is in state LOADED */
+    omx_wait_state(p_enc->handle, OMX_StateLoaded);
+
+    /* Free the component's handle */
+    assert(OMX_FreeHandle(p_enc->handle) == OMX_ErrorNone);
+
+    /* Deallocate NV12 buffers */
+    mmngr_dealloc_nv12_dmabufs(p_enc->p_nv12_bufs, NV12_BUFFER_COUNT);
+}
+
+/******************************** FOR THREADS *********************************/
+
+void * thread_input(void * p_param)
+{
+    in_data_t * p_data = (in_data_t *)p_param;
+
+    /* true:  The loop is running.
+     * false: The loop just stopped */
+    bool is_running = true;
+
+    /* V4L2 buffer */
+    struct v4l2_buffer cam_buf;
+
+    /* Buffers of input ports (1 per stream) and their indexes */
+    int indexes[MAX_STREAM_COUNT];
+    OMX_BUFFERHEADERTYPE * p_bufs[MAX_STREAM_COUNT];
+
+    uint32_t stream = 0;
+
+    encoder_t * p_enc  = NULL;
+    encoder_t * p_main = NULL;
+
+    /* EGL display, config, and context */
+    EGLDisplay display = EGL_NO_DISPLAY;
+    EGLContext context = EGL_NO_CONTEXT;
+
+    EGLConfig config;
+
+    /* OpenGL ES */
+    GLuint rec_prog = 0;
+    GLuint text_prog = 0;
+    GLuint sdf_text_prog = 0;
+    GLuint batch_prog = 0;
+    GLuint yuyv_to_nv12_prog = 0;
+    GLuint scale_nv12_prog = 0;
+    GLuint pip_prog = 0;
+    GLuint denoise_prog = 0;
+    GLuint mask_src_prog = 0;
+    GLuint blur_prog = 0;
+    GLuint mask_prog = 0;
+    GLuint motion_prog = 0;
+    GLuint snapshot_prog = 0;
+    GLuint stab_luma_prog = 0;
+    GLuint stab_prog = 0;
+
+    gl_res_t gl_res;
+
+    /* Flags of the fused conversion pass */
+    uint32_t writer_flags = 0;
+
+    /* Crop and scaling of camera frame (to main stream) and of main stream
+     * (to sub-stream), and the resources for them.
+     * 'conv_res' and 'sub_res' are 'gl_res' with 'p_scaler' set */
+    scaler_t scaler;
+    scaler_t sub_scaler;
+
+    gl_res_t conv_res;
+    gl_res_t sub_res;
+
+    /* Resources of the fused conversion pass ('conv_res' unless the camera
+     * frame is denoised) */
+    gl_res_t write_res;
+
+    /* Lens correction mesh of the conversion pass (option '-l') */
+    mesh_t lens_mesh = { 0 };
+
+    /* Temporal denoise (option '-t'). Its output is written 1:1 to NV12
+     * frame of main stream */
+    denoise_t denoise = { 0 };
+
+    scaler_t write_scaler;
+
+    /* Privacy masks (option '-k') */
+    mask_t mask = { 0 };
+
+    /* Motion detection (option '-a'), the file which its results are
+     * written to, and moving cells which are drawn on overlay */
+    motion_t motion = { 0 };
+    FILE * p_motion_file = NULL;
+
+    uint16_t drawn_grid[MOTION_GRID_ROWS] = { 0 };
+    uint16_t changed_cells = 0;
+    uint32_t col = 0;
+    uint32_t row = 0;
+    rect_t cell;
+
+    /* JPEG snapshots of main stream (option '-j') */
+    snapshot_t * p_snapshot = NULL;
+
+    /* Picture-in-picture of the second camera (option '-i') */
+    pip_t pip = { 0 };
+
+    /* Digital image stabilization (option '-b') */
+    stabilize_t stab = { 0 };
+
+    /* Capture time and frame counter (option '-c') */
+    timestamp_t stamp = { 0 };
+
+    /* Overlay commands of external processes (option '-x') and the area
+     * of their previous list */
+    ipc_t * p_ipc = NULL;
+    rect_t ipc_bounds;
+
+    /* Batch of shapes (such as bounding boxes) */
+    batch_t batch;
+
+    /* Points of polyline and vertices of polygon (star) */
+    float line_points[] = { 40.0f, 200.0f, 90.0f, 260.0f,
+                            140.0f, 220.0f, 190.0f, 280.0f };
+
+    float star_verts[] = { 560.0f, 440.0f, 572.0f, 405.0f, 610.0f, 405.0f,
+                           580.0f, 383.0f, 591.0f, 347.0f, 560.0f, 369.0f,
+                           529.0f, 347.0f, 540.0f, 383.0f, 510.0f, 405.0f,
+                           548.0f, 405.0f };
+
+    /* Image atlas and animated sprite */
+    image_atlas_t atlas;
+
+    int spinner = -1;
+    uint32_t spinner_frame = 0;
+    uint32_t video_frames = 0;
+
+    /* Area of sprite (it's only redrawn when its frame changes) */
+    rect_t spinner_bounds = { 250, 150, 64, 64 };
+
+    /* Persistent overlay layer */
+    overlay_t overlay;
+
+    /* Profiler and its render passes */
+    perf_t * p_perf = NULL;
+
+    int denoise_pass = -1;
+    int conv_pass    = -1;
+    int overlay_pass = -1;
+    int sub_pass     = -1;
+    int mask_pass    = -1;
+    int motion_pass  = -1;
+    int snapshot_pass = -1;
+    int pip_pass     = -1;
+    int stab_pass    = -1;
+
+    /* Area of rectangle in the current and the last frame */
+    rect_t rec_bounds  = { 0 };
+    rect_t last_bounds = { 0 };
+
+    /* White text with black outline and half-transparent shadow */
+    text_style_t sdf_style =
+    {
+        .color           = { 1.0f, 1.0f, 1.0f },
+        .outline_color   = { 0.0f, 0.0f, 0.0f },
+        .outline_width   = 2.0f,
+        .shadow_color    = { 0.0f, 0.0f, 0.0f },
+        .shadow_opacity  = 0.5f,
+        .shadow_offset_x = 3.0f,
+        .shadow_offset_y = 3.0f,
+    };
+
+    /* YUYV images and textures */
+    EGLImageKHR * p_yuyv_imgs = NULL;
+    GLuint      * p_yuyv_texs = NULL;
+
+    /* Textures sampled by the fused conversion pass: camera frame, overlay,
+     * and privacy masks (low resolution frame and coverage) if any */
+    GLenum fused_targets[4] = { GL_TEXTURE_EXTERNAL_OES, GL_TEXTURE_2D,
+                                GL_TEXTURE_2D, GL_TEXTURE_2D };
+    GLuint fused_texs[4]    = { 0, 0, 0, 0 };
+    uint32_t fused_count    = 2;
+
+    /* NV12 images, textures, and framebuffers of each stream */
+    EGLImageKHR * p_nv12_imgs[MAX_STREAM_COUNT] = { NULL };
+    GLuint      * p_nv12_texs[MAX_STREAM_COUNT] = { NULL };
+    GLuint      * p_nv12_fbs[MAX_STREAM_COUNT]  = { NULL };
+
+    /* Check parameter */
+    assert(p_data != NULL);
+
+    p_main = &(p_data->p_encs[MAIN_STREAM]);
+
+    /**************************************************************************
+     *                           STEP 1: SET UP EGL                           *
+     **************************************************************************/
+
+    /* Connect to EGL display */
+    display = egl_connect_display(EGL_DEFAULT_DISPLAY, &config);
+    assert(display != EGL_NO_DISPLAY);
+
+    /* Create and bind EGL context */
+    context = egl_create_context(display, config, EGL_NO_SURFACE);
+    assert(context != EGL_NO_CONTEXT);
+
+    /* Initialize EGL extension functions */
+    assert(egl_init_ext_funcs(display));
+
+    /**************************************************************************
+     *                        STEP 2: SET UP OPENGL ES                        *
+     **************************************************************************/
+
+    writer_flags = SHADER_OVERLAY | CAM_COLOR_FLAGS |
+                   ((p_data->denoise > 0.0f) ? SHADER_RGBA_INPUT : 0) |
+                   ((p_data->p_mask_file != NULL) ? SHADER_MASK : 0);
+
+    /* Create program object for drawing rectangle */
+    rec_prog = shader_create_prog(SHADER_PROG_RECTANGLE, 0);
+
+    /* Create program object for drawing text */
+    text_prog = shader_create_prog(SHADER_PROG_TEXT, 0);
+
+    /* Create program object for drawing text from signed distance field */
+    sdf_text_prog = shader_create_prog(SHADER_PROG_SDF_TEXT, 0);
+
+    /* Create program object for drawing batches of shapes */
+    batch_prog = shader_create_prog(SHADER_PROG_BATCH, 0);
+
+    /* Create program object for converting YUYV to NV12 and blending
+     * overlay in a single pass */
+    yuyv_to_nv12_prog = shader_create_prog(SHADER_PROG_YUYV_TO_NV12,
+                                           writer_flags);
+
+    /* The fused pass samples YUYV texture from texture unit 0, overlay
+     * from texture unit 1, and privacy masks from texture units 2 and 3 */
+    glUseProgram(yuyv_to_nv12_prog);
+    glUniform1i(glGetUniformLocation(yuyv_to_nv12_prog, "yuyvTexture"), 0);
+    glUniform1i(glGetUniformLocation(yuyv_to_nv12_prog, "overlayTexture"), 1);
+    glUniform1i(glGetUniformLocation(yuyv_to_nv12_prog, "maskTexture"), 2);
+    glUniform1i(glGetUniformLocation(yuyv_to_nv12_prog, "coverTexture"), 3);
+
+    /* Create resources needed for rendering */
+    gl_res = gl_create_resources(p_main->width, p_main->height, FONT_FILE);
+
+    /* Scale camera frame to NV12 frame (keep its aspect ratio), zoom into
+     * its center, then rotate/mirror it. Overlay is drawn in the coordinates
+     * of main stream, so it is not affected by them */
+    scaler = gl_init_scaler(p_data->cam_width, p_data->cam_height,
+                            p_main->width, p_main->height, true);
+
+    gl_set_zoom(&scaler, p_data->zoom,
+                p_data->cam_width / 2.0f, p_data->cam_height / 2.0f);
+
+    gl_set_orientation(&scaler, p_data->rotation,
+                       p_data->b_mirror_x, p_data->b_mirror_y);
+
+    /* Camera frame is sampled as packed YUYV, so it's not interpolated */
+    scaler.filter = GL_NEAREST;
+
+    conv_res = gl_res;
+    conv_res.p_scaler = &scaler;
+
+    /* Correct lens distortion in the conversion pass with a mesh */
+    if ((p_data->lens_k1 != 0.0f) || (p_data->lens_k2 != 0.0f))
+    {
+        lens_mesh = lens_create_mesh(p_data->lens_k1, p_data->lens_k2,
+                                     &scaler, false);
+        assert(lens_mesh.vbo != 0);
+
+        conv_res.p_mesh = &lens_mesh;
+    }
+
+    write_res = conv_res;
+
+    /* Denoise camera frame (crop, scaling, and lens correction included)
+     * before it's written to NV12 frame. Overlay is blended by the fused
+     * pass, so it's never blended with the previous frame */
+    if (p_data->denoise > 0.0f)
+    {
+        denoise_prog = shader_create_prog(SHADER_PROG_DENOISE,
+                                          CAM_COLOR_FLAGS);
+
+        denoise = denoise_create(p_main->width, p_main->height,
+                                 p_data->denoise);
+        assert((denoise.texs[1] != 0) && (denoise.fbs[1] != 0));
+
+        write_scaler = gl_init_scaler(p_main->width, p_main->height,
+                                      p_main->width, p_main->height, false);
+
+        write_res = gl_res;
+        write_res.p_scaler = &write_scaler;
+
+        fused_targets[0] = GL_TEXTURE_2D;
+    }
+
+    /* Pixelate or blur privacy masks. Their content is rendered from the
+     * camera frame with the crop, scaling, and lens correction of the
+     * conversion pass. The fused pass replaces covered pixels of the camera
+     * frame with it before it blends overlay. So, masks stay under overlay
+     * and the cached overlay layer is never redrawn because of them */
+    if (p_data->p_mask_file != NULL)
+    {
+        mask_src_prog = shader_create_prog(SHADER_PROG_YUV_TO_RGB,
+                                           CAM_COLOR_FLAGS);
+
+        blur_prog = shader_create_prog(SHADER_PROG_BLUR, 0);
+        mask_prog = shader_create_prog(SHADER_PROG_MASK, 0);
+
+        mask = mask_create(p_main->width, p_main->height,
+                           p_data->p_mask_file);
+        assert((mask.vbo != 0) && (mask.fbs[1] != 0));
+
+        /* Regions never move, so their coverage is drawn once */
+        assert(mask_draw_coverage(&mask, mask_prog, gl_res));
+
+        fused_texs[2] = mask.texs[0];
+        fused_texs[3] = mask.cover_tex;
+        fused_count   = 4;
+    }
+
+    /* Detect motion in the main stream */
+    if (p_data->p_motion_file != NULL)
+    {
+        motion_prog = shader_create_prog(SHADER_PROG_MOTION, CAM_COLOR_FLAGS);
+
+        motion = motion_create();
+        assert((motion.fbs[1] != 0) && (motion.pbos[0] != 0));
+
+        p_motion_file = fopen(p_data->p_motion_file, "w");
+        if (p_motion_file == NULL)
+        {
+            printf("Error: Failed to open '%s'\n", p_data->p_motion_file);
+        }
+        assert(p_motion_file != NULL);
+    }
+
+    /* Take snapshots of main stream (with overlay) on 'SIGUSR1' */
+    if (p_data->p_snapshot_prefix != NULL)
+    {
+        snapshot_prog = shader_create_prog(SHADER_PROG_YUV_TO_RGB,
+                                           CAM_COLOR_FLAGS);
+
+        p_snapshot = snapshot_create(p_main->width, p_main->height,
+                                     p_data->p_snapshot_prefix);
+        assert(p_snapshot != NULL);
+    }
+
+    /* Stabilize camera frames by moving the crop of the conversion pass */
+    if (p_data->b_stabilize)
+    {
+        stab_luma_prog = shader_create_prog(SHADER_PROG_MOTION,
+                                            CAM_COLOR_FLAGS);
+
+        stab_prog = shader_create_prog(SHADER_PROG_STABILIZE, 0);
+
+        stab = stabilize_create(p_data->cam_width, p_data->cam_height);
+        assert(stab.cost_fb != 0);
+    }
+
+    /* Burn capture time into the top-left corner of main stream */
+    if (p_data->b_timestamp)
+    {
+        stamp = timestamp_create(TIMESTAMP_MARGIN,
+                                 p_main->height - TIMESTAMP_MARGIN -
+                                 TIMESTAMP_TEXT_SIZE,
+                                 TIMESTAMP_TEXT_SIZE, gl_res);
+    }
+
+    /* Let external processes (such as a detector) draw on overlay */
+    if (p_data->p_ipc_name != NULL)
+    {
+        p_ipc = ipc_create(p_data->p_ipc_name, p_main->width, p_main->height);
+        assert(p_ipc != NULL);
+    }
+
+    /* Sub-stream is the main stream (with overlay) scaled down. So, it
+     * shares the conversion and overlay of main stream */
+    sub_res = gl_res;
+
+    if (p_data->enc_count > SUB_STREAM)
+    {
+        p_enc = &(p_data->p_encs[SUB_STREAM]);
+
+        /* NV12 texture is sampled as YUV and written as is */
+        scale_nv12_prog = shader_create_prog(SHADER_PROG_YUYV_TO_NV12,
+                                             CAM_COLOR_FLAGS);
+
+        /* NV12 texels can be interpolated (see 'scaler_t') */
+        sub_scaler = gl_init_scaler(p_main->width, p_main->height,
+                                    p_enc->width, p_enc->height, true);
+
+        sub_res.p_scaler = &sub_scaler;
+    }
+
+    /* Initialize OpenGL ES extension functions */
+    assert(gl_init_ext_funcs());
+
+    /* NV12 buffers are written as YUV by the fused pass, so this demo has
+     * no plane writer (see 'video-to-lcd-and-file') */
+    assert(gl_is_ext_supported("GL_EXT_YUV_target"));
+
+    /* Draw the second camera as an inset on overlay. It's rendered in RGB,
+     * then converted to NV12 with the rest of overlay */
+    if (p_data->p_pip_dev != NULL)
+    {
+        pip_prog = shader_create_prog(SHADER_PROG_YUV_TO_RGB,
+                                      SHADER_FLIP_Y | CAM_COLOR_FLAGS);
+
+        pip = pip_create(display, p_data->p_pip_dev, p_data->pip_area,
+                         p_main->width, p_main->height);
+        assert(pip.p_texs != NULL);
+    }
+
+    /* Create batch of shapes */
+    batch = batch_create(MAX_SHAPE_COUNT, MAX_POLYGON_VERT_COUNT);
+    assert(batch.p_insts != NULL);
+
+    /* Create image atlas and load sprite sheet into it */
+    atlas = image_atlas_create(IMAGE_ATLAS_SIZE, IMAGE_ATLAS_SIZE);
+    assert(atlas.tex != 0);
+
+    spinner = image_atlas_add_png(&atlas, SPINNER_FILE, SPINNER_COLS, 1);
+    assert(spinner != -1);
+
+    /* Create overlay layer */
+    overlay = overlay_create(p_main->width, p_main->height, OVERLAY_FORMAT);
+    assert((overlay.tex != 0) && (overlay.fb != 0));
+
+    printf("Overlay: %ux%u, %zu KiB\n", overlay.width, overlay.height,
+           overlay.size / 1024);
+
+    /* Create profiler (it does nothing unless option '-p' is given) */
+    p_perf = perf_create(p_data->b_perf);
+    assert(p_perf != NULL);
+
+    if (p_data->b_stabilize)
+    {
+        stab_pass = perf_add_pass(p_perf, "stabilize");
+    }
+
+    if (p_data->p_mask_file != NULL)
+    {
+        mask_pass = perf_add_pass(p_perf, "masks");
+    }
+
+    if (p_data->p_motion_file != NULL)
+    {
+        motion_pass = perf_add_pass(p_perf, "motion");
+    }
+
+    if (p_data->p_pip_dev != NULL)
+    {
+        pip_pass = perf_add_pass(p_perf, "pip");
+    }
+
+    overlay_pass = perf_add_pass(p_perf, "overlay");
+
+    if (p_data->denoise > 0.0f)
+    {
+        denoise_pass = perf_add_pass(p_perf, "denoise");
+    }
+
+    conv_pass    = perf_add_pass(p_perf, "conversion");
+    sub_pass     = perf_add_pass(p_perf, "sub-stream");
+
+    if (p_data->p_snapshot_prefix != NULL)
+    {
+        snapshot_pass = perf_add_pass(p_perf, "snapshot");
+    }
 
     /**************************************************************************
      *               STEP 3: CREATE TEXTURES FROM YUYV BUFFERS                *
@@ -829,150 +1407,470 @@ void * thread_input(void * p_param)
     assert(p_yuyv_texs != NULL);
 
     /**************************************************************************
-     *          STEP 4: CREATE FRAMEBUFFERS FROM EMPTY RGB TEXTURES           *
-     **************************************************************************/
-
-    /* Create RGB textures */
-    p_rgb_texs = gl_create_rgb_textures(p_data->cam_width, p_data->cam_height,
-                                        NULL, YUYV_BUFFER_COUNT);
-    assert(p_rgb_texs != NULL);
-
-    /* Create framebuffers */
-    p_rgb_fbs = gl_create_framebuffers(GL_TEXTURE_2D,
-                                       p_rgb_texs, YUYV_BUFFER_COUNT);
-    assert(p_rgb_fbs != NULL);
-
-    /**************************************************************************
-     *               STEP 5: CREATE TEXTURES FROM NV12 BUFFERS                *
+     *               STEP 4: CREATE TEXTURES FROM NV12 BUFFERS                *
      **************************************************************************/
 
-    /* Create NV12 EGLImage objects */
-    p_nv12_imgs = egl_create_nv12_images(display,
-                                         p_data->cam_width,
-                                         p_data->cam_height,
-                                         p_data->p_nv12_bufs,
-                                         NV12_BUFFER_COUNT);
-    assert(p_nv12_imgs != NULL);
-
-    /* Create NV12 textures */
-    p_nv12_texs = gl_create_external_textures(p_nv12_imgs, NV12_BUFFER_COUNT);
-    assert(p_nv12_texs != NULL);
+    for (stream = 0; stream < p_data->enc_count; stream++)
+    {
+        p_enc = &(p_data->p_encs[stream]);
+
+        /* Create NV12 EGLImage objects */
+        p_nv12_imgs[stream] = egl_create_nv12_images(display,
+                                                     p_enc->width,
+                                                     p_enc->height,
+                                                     p_enc->p_nv12_bufs,
+                                                     NV12_BUFFER_COUNT);
+        assert(p_nv12_imgs[stream] != NULL);
+
+        /* Create NV12 textures */
+        p_nv12_texs[stream] = gl_create_external_textures(p_nv12_imgs[stream],
+                                                          NV12_BUFFER_COUNT);
+        assert(p_nv12_texs[stream] != NULL);
+    }
 
     /**************************************************************************
-     *             STEP 6: CREATE FRAMEBUFFERS FROM NV12 TEXTURES             *
+     *             STEP 5: CREATE FRAMEBUFFERS FROM NV12 TEXTURES             *
      **************************************************************************/
 
-    /* Create framebuffers */
-    p_nv12_fbs = gl_create_framebuffers(GL_TEXTURE_EXTERNAL_OES,
-                                        p_nv12_texs, NV12_BUFFER_COUNT);
-    assert(p_nv12_fbs != NULL);
+    for (stream = 0; stream < p_data->enc_count; stream++)
+    {
+        /* Create framebuffers */
+        p_nv12_fbs[stream] = gl_create_framebuffers(GL_TEXTURE_EXTERNAL_OES,
+                                                    p_nv12_texs[stream],
+                                                    NV12_BUFFER_COUNT);
+        assert(p_nv12_fbs[stream] != NULL);
+    }
 
     /**************************************************************************
-     *                       STEP 7: THREAD'S MAIN LOOP                       *
+     *                       STEP 6: THREAD'S MAIN LOOP                       *
      **************************************************************************/
 
     while (is_running)
     {
-        assert(pthread_mutex_lock(p_data->p_mutex) == 0);
-
-        while (queue_is_empty(p_data->p_queue))
+        /* Receive 1 buffer (of input port) from each encoder */
+        for (stream = 0; stream < p_data->enc_count; stream++)
         {
-            /* Thread will sleep until the queue is not empty */
-            assert(0 == pthread_cond_wait(p_data->p_cond_available,
-                                          p_data->p_mutex));
-        }
+            p_enc = &(p_data->p_encs[stream]);
 
-        /* At this point, the queue must have something in it */
-        assert(!queue_is_empty(p_data->p_queue));
+            assert(pthread_mutex_lock(&(p_enc->mut_in)) == 0);
 
-        /* Receive buffer (of input port) from the queue */
-        p_buf = *(OMX_BUFFERHEADERTYPE **)(queue_dequeue(p_data->p_queue));
-        assert(p_buf != NULL);
+            while (queue_is_empty(&(p_enc->in_queue)))
+            {
+                /* Thread will sleep until the queue is not empty */
+                assert(0 == pthread_cond_wait(&(p_enc->cond_in_available),
+                                              &(p_enc->mut_in)));
+            }
 
-        assert(pthread_mutex_unlock(p_data->p_mutex) == 0);
+            /* At this point, the queue must have something in it */
+            assert(!queue_is_empty(&(p_enc->in_queue)));
 
-        /* Get buffer's index */
-        index = omx_get_index(p_buf, p_data->pp_bufs, NV12_BUFFER_COUNT);
-        assert(index != -1);
+            /* Receive buffer (of input port) from the queue */
+            p_bufs[stream] = *(OMX_BUFFERHEADERTYPE **)
+                             (queue_dequeue(&(p_enc->in_queue)));
+            assert(p_bufs[stream] != NULL);
+
+            assert(pthread_mutex_unlock(&(p_enc->mut_in)) == 0);
+
+            /* Get buffer's index */
+            indexes[stream] = omx_get_index(p_bufs[stream], p_enc->pp_in_bufs,
+                                            NV12_BUFFER_COUNT);
+            assert(indexes[stream] != -1);
+        }
 
         /* Receive camera's buffer */
         assert(v4l2_dequeue_buf(p_data->cam_fd, &cam_buf));
 
-        /* Bind framebuffer.
+        /* Estimate shake of camera frame and move the crop against it.
+         * Subsequent passes with 'conv_res' use the new crop */
+        if (p_data->b_stabilize)
+        {
+            perf_begin(p_perf, stab_pass);
+
+            stabilize_update(&stab, stab_luma_prog, stab_prog,
+                             GL_TEXTURE_EXTERNAL_OES,
+                             p_yuyv_texs[cam_buf.index], gl_res);
+
+            stabilize_apply(&stab, &scaler, p_data->zoom,
+                            p_data->cam_width / 2.0f,
+                            p_data->cam_height / 2.0f);
+
+            perf_end(p_perf, stab_pass);
+        }
+
+        /* The rectangle moves every frame. So, both its old and new areas
+         * must be redrawn. Other content is static */
+        rec_bounds = gl_get_rectangle_bounds(p_main->width, p_main->height,
+                                             gl_res);
+
+        overlay_invalidate(&overlay, last_bounds);
+        overlay_invalidate(&overlay, rec_bounds);
+
+        last_bounds = rec_bounds;
+
+        /* Redraw sprite only when its frame changes */
+        if ((video_frames % SPINNER_FRAME_INTERVAL) == 0)
+        {
+            spinner_frame = video_frames / SPINNER_FRAME_INTERVAL;
+            overlay_invalidate(&overlay, spinner_bounds);
+        }
+
+        video_frames++;
+
+        /* Content of masks changes every frame. It's applied by the fused
+         * pass, so overlay is not affected */
+        if (p_data->p_mask_file != NULL)
+        {
+            perf_begin(p_perf, mask_pass);
+
+            mask_update(&mask, mask_src_prog, blur_prog,
+                        GL_TEXTURE_EXTERNAL_OES, p_yuyv_texs[cam_buf.index],
+                        conv_res);
+
+            perf_end(p_perf, mask_pass);
+        }
+
+        /* Detect motion. Results arrive a frame or two later, so this never
+         * waits for the GPU. Only cells which start or stop moving are
+         * redrawn on overlay */
+        if (p_data->p_motion_file != NULL)
+        {
+            perf_begin(p_perf, motion_pass);
+
+            if (motion_update(&motion, motion_prog, GL_TEXTURE_EXTERNAL_OES,
+                              p_yuyv_texs[cam_buf.index], conv_res))
+            {
+                motion_write_result(&motion, p_motion_file);
+            }
+
+            perf_end(p_perf, motion_pass);
+
+            for (row = 0; row < MOTION_GRID_ROWS; row++)
+            {
+                changed_cells = drawn_grid[row] ^ motion.grid[row];
+
+                for (col = 0; col < MOTION_GRID_COLS; col++)
+                {
+                    if (((changed_cells >> col) & 1) == 0)
+                    {
+                        continue;
+                    }
+
+                    cell = motion_get_cell_rect(col, row, p_main->width,
+                                                p_main->height);
+
+                    overlay_invalidate(&overlay, cell);
+                }
+
+                drawn_grid[row] = motion.grid[row];
+            }
+        }
+
+        /* Take the latest frame of the second camera (it's never waited
+         * for). Its area of overlay is only redrawn when a frame arrives */
+        if (p_data->p_pip_dev != NULL)
+        {
+            perf_begin(p_perf, pip_pass);
+
+            if (pip_update(&pip))
+            {
+                overlay_invalidate(&overlay, pip.area);
+            }
+
+            perf_end(p_perf, pip_pass);
+        }
+
+        /* Capture time changes every frame. Only its area of overlay is
+         * redrawn */
+        if (p_data->b_timestamp &&
+            timestamp_update(&stamp, &cam_buf, gl_res))
+        {
+            overlay_invalidate(&overlay, stamp.bounds);
+        }
+
+        /* Take the list of external processes for this frame. It's copied
+         * from shared memory without any system call. Areas of both the
+         * previous and the new list are redrawn if it changes */
+        if (p_ipc != NULL)
+        {
+            ipc_bounds = ipc_get_bounds(p_ipc);
+
+            if (ipc_update(p_ipc,
+                           ((uint64_t)cam_buf.timestamp.tv_sec * 1000000) +
+                           cam_buf.timestamp.tv_usec, cam_buf.sequence))
+            {
+                overlay_invalidate(&overlay, ipc_bounds);
+                overlay_invalidate(&overlay, ipc_get_bounds(p_ipc));
+            }
+        }
+
+        /* Redraw dirty areas of overlay */
+        perf_begin(p_perf, overlay_pass);
+
+        if (overlay_begin(&overlay))
+        {
+            /* Draw the second camera under shapes and text */
+            if (p_data->p_pip_dev != NULL)
+            {
+                pip_draw(&pip, pip_prog, gl_res);
+            }
+
+            /* Draw rectangle */
+            gl_draw_rectangle(rec_prog, gl_res);
+
+            /* Draw bounding boxes and other shapes with a single draw call */
+            batch_add_rect(&batch, 400.0f, 250.0f, 160.0f, 120.0f,
+                           0.0f, GREEN, 1.0f, 3.0f);
+
+            batch_add_rect(&batch, 440.0f, 80.0f, 100.0f, 100.0f,
+                           15.0f, BLUE, 0.5f, 0.0f);
+
+            batch_add_rounded_rect(&batch, 40.0f, 320.0f, 140.0f, 60.0f,
+                                   0.0f, 15.0f, WHITE, 1.0f, 2.0f);
+
+            batch_add_circle(&batch, 330.0f, 400.0f, 30.0f, RED, 1.0f, 4.0f);
+
+            batch_add_polyline(&batch, line_points, 4, 3.0f, WHITE, 1.0f);
+
+            batch_add_polygon(&batch, star_verts, 10, GREEN, 1.0f, 0.0f);
+
+            batch_add_image(&batch, &atlas, spinner, spinner_frame,
+                            250.0f, 150.0f, 64.0f, 64.0f, 0.0f, 1.0f);
+
+            /* Outline moving cells (of the latest result) */
+            for (row = 0; row < MOTION_GRID_ROWS; row++)
+            {
+                for (col = 0; col < MOTION_GRID_COLS; col++)
+                {
+                    if (!motion_is_cell_moving(&motion, col, row))
+                    {
+                        continue;
+                    }
+
+                    cell = motion_get_cell_rect(col, row, p_main->width,
+                                                p_main->height);
+
+                    /* Inset by 1 pixel, so antialiased edges stay inside */
+                    batch_add_rect(&batch, cell.x + 1, cell.y + 1,
+                                   cell.width - 2, cell.height - 2,
+                                   0.0f, RED, 1.0f, 2.0f);
+                }
+            }
+
+            /* Add boxes and masks of external processes */
+            if (p_ipc != NULL)
+            {
+                ipc_add_shapes(p_ipc, &batch);
+            }
+
+            batch_flush(batch_prog, &batch, gl_res);
+
+            /* Draw text */
+            gl_draw_text(text_prog, "This is a text",
+                         25.0f, 25.0f, BLACK, gl_res);
+
+            /* Draw outlined text with shadow */
+            gl_draw_sdf_text(sdf_text_prog, "This is an SDF text",
+                             25.0f, 70.0f, 40.0f, &sdf_style, gl_res);
+
+            /* Draw labels of external processes */
+            if (p_ipc != NULL)
+            {
+                ipc_draw_labels(p_ipc, sdf_text_prog, &sdf_style, gl_res);
+            }
+
+            /* Draw capture time of camera frame */
+            if (p_data->b_timestamp)
+            {
+                timestamp_draw(&stamp, sdf_text_prog, &sdf_style, gl_res);
+            }
+
+            overlay_end(&overlay);
+        }
+
+        perf_end(p_perf, overlay_pass);
+
+        /* Convert YUYV texture to NV12 texture of main stream and blend
+         * overlay onto it. No intermediate RGB texture is needed, unless
+         * the camera frame is denoised (it's blended with the previous one
+         * first) */
+        fused_texs[0] = p_yuyv_texs[cam_buf.index];
+        fused_texs[1] = overlay.tex;
+
+        if (p_data->denoise > 0.0f)
+        {
+            perf_begin(p_perf, denoise_pass);
+
+            fused_texs[0] = denoise_apply(&denoise, denoise_prog,
+                                          GL_TEXTURE_EXTERNAL_OES,
+                                          p_yuyv_texs[cam_buf.index],
+                                          conv_res);
+
+            perf_end(p_perf, denoise_pass);
+        }
+
+        /* Bind framebuffer of main stream.
          * All subsequent rendering operations will now render to
-         * RGB texture which is linked to the framebuffer (see above):
+         * NV12 texture which is linked to the framebuffer (see above):
          * https://learnopengl.com/Advanced-OpenGL/Framebuffers */
-        glBindFramebuffer(GL_FRAMEBUFFER, p_rgb_fbs[cam_buf.index]);
+        glBindFramebuffer(GL_FRAMEBUFFER,
+                          p_nv12_fbs[MAIN_STREAM][indexes[MAIN_STREAM]]);
 
-        /* Convert YUYV texture to RGB texture */
-        gl_render_texture(yuyv_to_rgb_prog, GL_TEXTURE_EXTERNAL_OES,
-                          p_yuyv_texs[cam_buf.index], gl_res);
+        perf_begin(p_perf, conv_pass);
 
-        /* Draw rectangle */
-        gl_draw_rectangle(rec_prog, gl_res);
+        gl_render_textures(yuyv_to_nv12_prog, fused_targets,
+                           fused_texs, fused_count, write_res);
 
-        /* Draw text */
-        gl_draw_text(text_prog, "This is a text", 25.0f, 25.0f, BLACK, gl_res);
+        perf_end(p_perf, conv_pass);
 
-        /* Bind framebuffer.
-         * All subsequent rendering operations will now render to
-         * NV12 texture which is linked to the framebuffer (see above) */
-        glBindFramebuffer(GL_FRAMEBUFFER, p_nv12_fbs[index]);
+        /* Scale main stream down to sub-stream. Both are NV12, so YUV
+         * values are just interpolated ('sub_scaler' keeps GL_LINEAR) */
+        if (p_data->enc_count > SUB_STREAM)
+        {
+            perf_begin(p_perf, sub_pass);
 
-        /* Convert RGB texture to NV12 texture */
-        gl_render_texture(rgb_to_nv12_prog, GL_TEXTURE_2D,
-                          p_rgb_texs[cam_buf.index], gl_res);
+            glBindFramebuffer(GL_FRAMEBUFFER,
+                              p_nv12_fbs[SUB_STREAM][indexes[SUB_STREAM]]);
 
-        /* Reuse camera's buffer */
-        assert(v4l2_enqueue_buf(p_data->cam_fd, cam_buf.index));
+            gl_render_texture(scale_nv12_prog, GL_TEXTURE_EXTERNAL_OES,
+                              p_nv12_texs[MAIN_STREAM][indexes[MAIN_STREAM]],
+                              sub_res);
+
+            perf_end(p_perf, sub_pass);
+        }
 
-        /* If 'p_buf' contains data, 'nFilledLen' must not be zero */
-        p_buf->nFilledLen = NV12_FRAME_SZ(p_data->cam_width,
-                                          p_data->cam_height);
+        /* Copy main stream to the CPU if a snapshot is requested. It's
+         * encoded by a background thread a frame or two later, so no frame
+         * is dropped. A request waits while the previous one is encoded */
+        if (p_snapshot != NULL)
+        {
+            perf_begin(p_perf, snapshot_pass);
 
-        /* Section 6.14.1 in document 'R01USxxxxEJxxxx_vecmn_v1.0.pdf' */
-        p_buf->nFlags = OMX_BUFFERFLAG_ENDOFFRAME;
+            if (g_snapshot_signal &&
+                snapshot_capture(p_snapshot, snapshot_prog,
+                                 GL_TEXTURE_EXTERNAL_OES,
+                                 p_nv12_texs[MAIN_STREAM][indexes[MAIN_STREAM]],
+                                 gl_res))
+            {
+                g_snapshot_signal = 0;
+            }
+
+            snapshot_update(p_snapshot);
+
+            perf_end(p_perf, snapshot_pass);
+        }
+
+        perf_end_frame(p_perf);
+
+        /* Reuse camera's buffer */
+        assert(v4l2_enqueue_buf(p_data->cam_fd, cam_buf.index));
 
         if (g_int_signal)
         {
-            p_buf->nFlags |= OMX_BUFFERFLAG_EOS;
-
             /* Exit loop */
             is_running = false;
         }
 
-        /* Send the buffer to the input port of the component */
-        assert(OMX_EmptyThisBuffer(p_data->handle, p_buf) == OMX_ErrorNone);
+        for (stream = 0; stream < p_data->enc_count; stream++)
+        {
+            p_enc = &(p_data->p_encs[stream]);
+
+            /* If the buffer contains data, 'nFilledLen' must not be zero */
+            p_bufs[stream]->nFilledLen = NV12_FRAME_SZ(p_enc->width,
+                                                       p_enc->height);
+
+            /* Section 6.14.1 in document 'R01USxxxxEJxxxx_vecmn_v1.0.pdf' */
+            p_bufs[stream]->nFlags = OMX_BUFFERFLAG_ENDOFFRAME;
+
+            if (!is_running)
+            {
+                p_bufs[stream]->nFlags |= OMX_BUFFERFLAG_EOS;
+            }
+
+            /* Send the buffer to the input port of the component */
+            assert(OMX_ErrorNone == OMX_EmptyThisBuffer(p_enc->handle,
+                                                        p_bufs[stream]));
+        }
     }
 
     /**************************************************************************
-     *                       STEP 8: CLEAN UP OPENGL ES                       *
+     *                       STEP 7: CLEAN UP OPENGL ES                       *
      **************************************************************************/
 
     /* Delete framebuffers and NV12 textures */
-    gl_delete_framebuffers(p_nv12_fbs, NV12_BUFFER_COUNT);
-
-    gl_delete_textures(p_nv12_texs, NV12_BUFFER_COUNT);
-    egl_delete_images(display, p_nv12_imgs, NV12_BUFFER_COUNT);
+    for (stream = 0; stream < p_data->enc_count; stream++)
+    {
+        gl_delete_framebuffers(p_nv12_fbs[stream], NV12_BUFFER_COUNT);
 
-    /* Delete framebuffers and RGB textyres */
-    gl_delete_framebuffers(p_rgb_fbs, YUYV_BUFFER_COUNT);
-    gl_delete_textures(p_rgb_texs, YUYV_BUFFER_COUNT);
+        gl_delete_textures(p_nv12_texs[stream], NV12_BUFFER_COUNT);
+        egl_delete_images(display, p_nv12_imgs[stream], NV12_BUFFER_COUNT);
+    }
 
     /* Delete YUYV textures */
     gl_delete_textures(p_yuyv_texs, YUYV_BUFFER_COUNT);
     egl_delete_images(display, p_yuyv_imgs, YUYV_BUFFER_COUNT);
 
+    /* Delete profiler */
+    perf_delete(p_perf);
+
+    /* Delete batch of shapes */
+    batch_delete(&batch);
+
+    /* Delete image atlas */
+    image_atlas_delete(&atlas);
+
+    /* Delete overlay layer */
+    overlay_delete(&overlay);
+
+    /* Delete lens correction mesh (nothing happens if it's not created) */
+    lens_delete_mesh(&lens_mesh);
+
+    /* Delete temporal denoise (nothing happens if it's not created) */
+    denoise_delete(&denoise);
+
+    /* Delete privacy masks (nothing happens if they're not created) */
+    mask_delete(&mask);
+
+    /* Delete motion detection and close its file */
+    motion_delete(&motion);
+
+    if (p_motion_file != NULL)
+    {
+        fclose(p_motion_file);
+    }
+
+    /* Delete snapshot (a snapshot being encoded is finished first) */
+    snapshot_delete(p_snapshot);
+
+    /* Stop the second camera (nothing happens if it's not opened) */
+    pip_delete(&pip);
+
+    /* Delete stabilization (nothing happens if it's not created) */
+    stabilize_delete(&stab);
+
+    /* Remove shared memory of overlay commands */
+    ipc_delete(p_ipc);
+
     /* Delete resources for OpenGL ES */
     gl_delete_resources(gl_res);
 
     glDeleteProgram(rec_prog);
     glDeleteProgram(text_prog);
-    glDeleteProgram(yuyv_to_rgb_prog);
-    glDeleteProgram(rgb_to_nv12_prog);
+    glDeleteProgram(sdf_text_prog);
+    glDeleteProgram(batch_prog);
+    glDeleteProgram(yuyv_to_nv12_prog);
+    glDeleteProgram(scale_nv12_prog);
+    glDeleteProgram(pip_prog);
+    glDeleteProgram(denoise_prog);
+    glDeleteProgram(mask_src_prog);
+    glDeleteProgram(blur_prog);
+    glDeleteProgram(mask_prog);
+    glDeleteProgram(motion_prog);
+    glDeleteProgram(snapshot_prog);
+    glDeleteProgram(stab_luma_prog);
+    glDeleteProgram(stab_prog);
 
     /**************************************************************************
-     *                          STEP 9: CLEAN UP EGL                          *
+     *                          STEP 8: CLEAN UP EGL                          *
      **************************************************************************/
 
     /* Delete EGL context */
@@ -1003,7 +1901,7 @@ void * thread_output(void * p_param)
     assert(p_data != NULL);
 
     /* Open file */
-    p_h264_fd = fopen(H264_FILE_NAME, "w");
+    p_h264_fd = fopen(p_data->p_file, "w");
     assert(p_h264_fd != NULL);
 
     while (is_running)
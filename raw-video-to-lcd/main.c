@@ -10,10 +10,16 @@
 #include <sys/time.h>
 
 #include "gl.h"
+#include "batch.h"
+#include "image.h"
+#include "shader.h"
 #include "wl.h"
 #include "egl.h"
 #include "util.h"
 #include "v4l2.h"
+#include "overlay.h"
+#include "perf.h"
+#include "lens.h"
 #include "prog.h"
 
 /******************************************************************************
@@ -24,6 +30,29 @@
 
 #define FONT_FILE "LiberationSans-Regular.ttf"
 
+/* Color standard and range of camera, used to select shader variants.
+ * For example, '(SHADER_BT709 | SHADER_LIMITED_RANGE)' */
+#define CAM_COLOR_FLAGS 0
+
+/* Sprite sheet of 4 frames (in 1 row) and the size of image atlas */
+#define SPINNER_FILE "spinner.png"
+#define SPINNER_COLS 4
+
+#define IMAGE_ATLAS_SIZE 512
+
+/* The sprite shows its next frame after this number of video frames */
+#define SPINNER_FRAME_INTERVAL 8
+
+/* Internal format of overlay layer. 'GL_RGBA4' or 'GL_RGB5_A1' halve its
+ * memory and the bandwidth of redrawing and blending it (see option '-p') */
+#define OVERLAY_FORMAT GL_RGBA8
+
+/* The maximum number of shapes drawn with a single draw call */
+#define MAX_SHAPE_COUNT 256
+
+/* The maximum number of vertices of polygons drawn with a single draw call */
+#define MAX_POLYGON_VERT_COUNT 1024
+
 /* The sample app is tested OK with:
  *   - Logitech C270 HD Webcam.
  *   - Logitech C920 HD Pro Webcam.
@@ -70,6 +99,30 @@ int main(int argc, char * p_argv[])
     opt.height        = DEFAULT_FRAME_HEIGHT;
     opt.framerate.den = DEFAULT_FRAME_RATE;
     opt.framerate.num = 1;
+    opt.out_width     = 0;
+    opt.out_height    = 0;
+    opt.sub_width     = 0;
+    opt.sub_height    = 0;
+    opt.zoom          = 1.0f;
+    opt.rotation      = 0;
+    opt.b_mirror_x    = false;
+    opt.b_mirror_y    = false;
+    opt.nv12_writer   = NV12_WRITER_AUTO;
+    opt.lens_k1       = 0.0f;
+    opt.lens_k2       = 0.0f;
+    opt.denoise       = 0.0f;
+    opt.mask_file[0]  = '\0';
+    opt.motion_file[0] = '\0';
+    opt.snapshot_prefix[0] = '\0';
+    opt.pip_dev[0]    = '\0';
+    opt.pip_x         = 0;
+    opt.pip_y         = 0;
+    opt.pip_width     = 0;
+    opt.pip_height    = 0;
+    opt.b_stabilize   = false;
+    opt.b_timestamp   = false;
+    opt.ipc_name[0]   = '\0';
+    opt.b_perf        = false;
 
     /* Interrupt signal */
     struct sigaction sig_act;
@@ -107,9 +160,71 @@ int main(int argc, char * p_argv[])
     GLuint rec_prog  = 0;
     GLuint conv_prog = 0;
     GLuint text_prog = 0;
+    GLuint sdf_text_prog = 0;
+    GLuint batch_prog = 0;
+    GLuint overlay_prog = 0;
 
     gl_res_t gl_res;
 
+    /* True if camera frame is sampled as YUV ('GL_EXT_YUV_target') */
+    bool b_yuv_target = false;
+
+    /* Crop and scaling of camera frame, and the resources for converting it.
+     * 'conv_res' is 'gl_res' with 'p_scaler' set */
+    scaler_t scaler;
+    gl_res_t conv_res;
+
+    /* Lens correction mesh of the conversion pass (option '-l') */
+    mesh_t lens_mesh = { 0 };
+
+    /* Batch of shapes (such as bounding boxes) */
+    batch_t batch;
+
+    /* Points of polyline and vertices of polygon (star) */
+    float line_points[] = { 40.0f, 200.0f, 90.0f, 260.0f,
+                            140.0f, 220.0f, 190.0f, 280.0f };
+
+    float star_verts[] = { 560.0f, 440.0f, 572.0f, 405.0f, 610.0f, 405.0f,
+                           580.0f, 383.0f, 591.0f, 347.0f, 560.0f, 369.0f,
+                           529.0f, 347.0f, 540.0f, 383.0f, 510.0f, 405.0f,
+                           548.0f, 405.0f };
+
+    /* Image atlas and animated sprite */
+    image_atlas_t atlas;
+
+    int spinner = -1;
+    uint32_t spinner_frame = 0;
+    uint32_t video_frames = 0;
+
+    /* Area of sprite (it's only redrawn when its frame changes) */
+    rect_t spinner_bounds = { 250, 150, 64, 64 };
+
+    /* Persistent overlay layer */
+    overlay_t overlay;
+
+    /* Profiler and its render passes */
+    perf_t * p_perf = NULL;
+
+    int overlay_pass   = -1;
+    int conv_pass      = -1;
+    int composite_pass = -1;
+
+    /* Area of rectangle in the current and the last frame */
+    rect_t rec_bounds  = { 0 };
+    rect_t last_bounds = { 0 };
+
+    /* White text with black outline and half-transparent shadow */
+    text_style_t sdf_style =
+    {
+        .color           = { 1.0f, 1.0f, 1.0f },
+        .outline_color   = { 0.0f, 0.0f, 0.0f },
+        .outline_width   = 2.0f,
+        .shadow_color    = { 0.0f, 0.0f, 0.0f },
+        .shadow_opacity  = 0.5f,
+        .shadow_offset_x = 3.0f,
+        .shadow_offset_y = 3.0f,
+    };
+
     /* For calculating FPS */
     struct timeval temp_tv;
 
@@ -138,6 +253,16 @@ int main(int argc, char * p_argv[])
     assert((opt.width > 0) && (opt.height > 0));
     assert(IS_FRAMERATE_VALID(opt.framerate));
 
+    /* Frames are denoised to cut bitrate of the encoder, which this demo
+     * does not have */
+    if (opt.denoise > 0.0f)
+    {
+        printf("Warning: Option -t is not supported by this demo. "
+               "It is ignored\n");
+
+        opt.denoise = 0.0f;
+    }
+
     /* Open camera */
     cam_fd = v4l2_open_dev(opt.cam_dev);
     assert(cam_fd != -1);
@@ -193,7 +318,7 @@ int main(int argc, char * p_argv[])
 
     /* Create Wayland window */
     p_wl_window = wl_create_window(p_wl_display, WINDOW_TITLE,
-                                   opt.width, opt.height);
+                                   opt.out_width, opt.out_height);
     assert(p_wl_window != NULL);
 
     /**************************************************************************
@@ -223,22 +348,86 @@ int main(int argc, char * p_argv[])
      **************************************************************************/
 
     /* Create program object for drawing rectangle */
-    rec_prog = gl_create_prog_from_src("rectangle.vs.glsl",
-                                       "rectangle.fs.glsl");
+    rec_prog = shader_create_prog(SHADER_PROG_RECTANGLE, 0);
+
+    /* Create program object for converting YUYV to RGB. Without
+     * 'GL_EXT_YUV_target', the driver converts it when sampling */
+    b_yuv_target = gl_is_ext_supported("GL_EXT_YUV_target");
 
-    /* Create program object for converting YUYV to RGB */
-    conv_prog = gl_create_prog_from_src("yuyv-to-rgb.vs.glsl",
-                                        "yuyv-to-rgb.fs.glsl");
+    conv_prog = shader_create_prog(SHADER_PROG_YUV_TO_RGB,
+                                   SHADER_FLIP_Y | CAM_COLOR_FLAGS |
+                                   (b_yuv_target ? 0 : SHADER_RGB_INPUT));
 
     /* Create program object for drawing text */
-    text_prog = gl_create_prog_from_src("text.vs.glsl", "text.fs.glsl");
+    text_prog = shader_create_prog(SHADER_PROG_TEXT, 0);
+
+    /* Create program object for drawing text from signed distance field */
+    sdf_text_prog = shader_create_prog(SHADER_PROG_SDF_TEXT, 0);
+
+    /* Create program object for drawing batches of shapes */
+    batch_prog = shader_create_prog(SHADER_PROG_BATCH, 0);
+
+    /* Create program object for blending overlay onto video frame */
+    overlay_prog = shader_create_prog(SHADER_PROG_OVERLAY, 0);
 
     /* Create resources needed for rendering */
-    gl_res = gl_create_resources(opt.width, opt.height, FONT_FILE);
+    gl_res = gl_create_resources(opt.out_width, opt.out_height, FONT_FILE);
+
+    /* Scale camera frame to window (keep its aspect ratio), zoom into its
+     * center, then rotate/mirror it */
+    scaler = gl_init_scaler(opt.width, opt.height,
+                            opt.out_width, opt.out_height, true);
+
+    gl_set_zoom(&scaler, opt.zoom, opt.width / 2.0f, opt.height / 2.0f);
+
+    gl_set_orientation(&scaler, opt.rotation,
+                       opt.b_mirror_x, opt.b_mirror_y);
+
+    /* Camera frame sampled as packed YUYV is not interpolated. Without
+     * 'GL_EXT_YUV_target', the driver converts it to RGB before filtering */
+    scaler.filter = b_yuv_target ? GL_NEAREST : GL_LINEAR;
+
+    conv_res = gl_res;
+    conv_res.p_scaler = &scaler;
+
+    /* Correct lens distortion in the conversion pass with a mesh */
+    if ((opt.lens_k1 != 0.0f) || (opt.lens_k2 != 0.0f))
+    {
+        lens_mesh = lens_create_mesh(opt.lens_k1, opt.lens_k2, &scaler, true);
+        assert(lens_mesh.vbo != 0);
+
+        conv_res.p_mesh = &lens_mesh;
+    }
 
     /* Initialize OpenGL ES extension functions */
     assert(gl_init_ext_funcs());
 
+    /* Create batch of shapes */
+    batch = batch_create(MAX_SHAPE_COUNT, MAX_POLYGON_VERT_COUNT);
+    assert(batch.p_insts != NULL);
+
+    /* Create image atlas and load sprite sheet into it */
+    atlas = image_atlas_create(IMAGE_ATLAS_SIZE, IMAGE_ATLAS_SIZE);
+    assert(atlas.tex != 0);
+
+    spinner = image_atlas_add_png(&atlas, SPINNER_FILE, SPINNER_COLS, 1);
+    assert(spinner != -1);
+
+    /* Create overlay layer */
+    overlay = overlay_create(opt.out_width, opt.out_height, OVERLAY_FORMAT);
+    assert((overlay.tex != 0) && (overlay.fb != 0));
+
+    printf("Overlay: %ux%u, %zu KiB\n", overlay.width, overlay.height,
+           overlay.size / 1024);
+
+    /* Create profiler (it does nothing unless option '-p' is given) */
+    p_perf = perf_create(opt.b_perf);
+    assert(p_perf != NULL);
+
+    overlay_pass   = perf_add_pass(p_perf, "overlay");
+    conv_pass      = perf_add_pass(p_perf, "conversion");
+    composite_pass = perf_add_pass(p_perf, "composite");
+
     /**************************************************************************
      *               STEP 7: CREATE TEXTURES FROM YUYV BUFFERS                *
      **************************************************************************/
@@ -310,19 +499,87 @@ int main(int argc, char * p_argv[])
             start_us = TIMEVAL_TO_USECS(temp_tv);
         }
 
-        /* Convert YUYV texture to RGB texture */
+        /* The rectangle moves every frame. So, both its old and new areas
+         * must be redrawn. Other content is static */
+        rec_bounds = gl_get_rectangle_bounds(opt.out_width,
+                                             opt.out_height, gl_res);
+
+        overlay_invalidate(&overlay, last_bounds);
+        overlay_invalidate(&overlay, rec_bounds);
+
+        last_bounds = rec_bounds;
+
+        /* Redraw sprite only when its frame changes */
+        if ((video_frames % SPINNER_FRAME_INTERVAL) == 0)
+        {
+            spinner_frame = video_frames / SPINNER_FRAME_INTERVAL;
+            overlay_invalidate(&overlay, spinner_bounds);
+        }
+
+        video_frames++;
+
+        /* Redraw dirty areas of overlay */
+        perf_begin(p_perf, overlay_pass);
+
+        if (overlay_begin(&overlay))
+        {
+            /* Draw rectangle */
+            gl_draw_rectangle(rec_prog, gl_res);
+
+            /* Draw bounding boxes and other shapes with a single draw call */
+            batch_add_rect(&batch, 400.0f, 250.0f, 160.0f, 120.0f,
+                           0.0f, GREEN, 1.0f, 3.0f);
+
+            batch_add_rect(&batch, 440.0f, 80.0f, 100.0f, 100.0f,
+                           15.0f, BLUE, 0.5f, 0.0f);
+
+            batch_add_rounded_rect(&batch, 40.0f, 320.0f, 140.0f, 60.0f,
+                                   0.0f, 15.0f, WHITE, 1.0f, 2.0f);
+
+            batch_add_circle(&batch, 330.0f, 400.0f, 30.0f, RED, 1.0f, 4.0f);
+
+            batch_add_polyline(&batch, line_points, 4, 3.0f, WHITE, 1.0f);
+
+            batch_add_polygon(&batch, star_verts, 10, GREEN, 1.0f, 0.0f);
+
+            batch_add_image(&batch, &atlas, spinner, spinner_frame,
+                            250.0f, 150.0f, 64.0f, 64.0f, 0.0f, 1.0f);
+
+            batch_flush(batch_prog, &batch, gl_res);
+
+            /* Draw text */
+            gl_draw_text(text_prog, "This is a text",
+                         25.0f, 25.0f, BLACK, gl_res);
+
+            /* Draw outlined text with shadow */
+            gl_draw_sdf_text(sdf_text_prog, "This is an SDF text",
+                             25.0f, 70.0f, 40.0f, &sdf_style, gl_res);
+
+            overlay_end(&overlay);
+        }
+
+        perf_end(p_perf, overlay_pass);
+
+        /* Convert YUYV texture to RGB texture, cropped and scaled to window */
+        perf_begin(p_perf, conv_pass);
+
         gl_render_texture(conv_prog, GL_TEXTURE_EXTERNAL_OES,
-                          p_yuyv_texs[cam_buf.index], gl_res);
+                          p_yuyv_texs[cam_buf.index], conv_res);
+
+        perf_end(p_perf, conv_pass);
+
+        /* Blend overlay onto video frame */
+        perf_begin(p_perf, composite_pass);
 
-        /* Draw rectangle */
-        gl_draw_rectangle(rec_prog, gl_res);
+        overlay_composite(overlay_prog, &overlay, gl_res);
 
-        /* Draw text */
-        gl_draw_text(text_prog, "This is a text", 25.0f, 25.0f, BLACK, gl_res);
+        perf_end(p_perf, composite_pass);
 
         /* Display to monitor */
         eglSwapBuffers(egl_display, egl_surface);
 
+        perf_end_frame(p_perf);
+
         /* Collect frame */
         frames++;
 
@@ -340,12 +597,30 @@ int main(int argc, char * p_argv[])
      *                      STEP 11: CLEAN UP OPENGL ES                       *
      **************************************************************************/
 
+    /* Delete profiler */
+    perf_delete(p_perf);
+
+    /* Delete overlay layer */
+    overlay_delete(&overlay);
+
+    /* Delete batch of shapes */
+    batch_delete(&batch);
+
+    /* Delete image atlas */
+    image_atlas_delete(&atlas);
+
+    /* Delete lens correction mesh (nothing happens if it's not created) */
+    lens_delete_mesh(&lens_mesh);
+
     /* Delete resources for OpenGL ES */
     gl_delete_resources(gl_res);
 
     glDeleteProgram(rec_prog);
     glDeleteProgram(conv_prog);
     glDeleteProgram(text_prog);
+    glDeleteProgram(sdf_text_prog);
+    glDeleteProgram(batch_prog);
+    glDeleteProgram(overlay_prog);
 
     /**************************************************************************
      *                         STEP 12: CLEAN UP EGL                          *
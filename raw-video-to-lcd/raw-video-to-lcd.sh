@@ -30,6 +30,28 @@ HEIGHT="$DEFAULT_HEIGHT"
 
 FRAMERATE="$DEFAULT_FRAMERATE"
 
+# Size of output (empty if it's the same as frame size of camera)
+OUTPUT=""
+
+# Digital zoom into the center of frame
+DEFAULT_ZOOM="1"
+
+ZOOM="$DEFAULT_ZOOM"
+
+# Clockwise rotation of frame (0, 90, 180, or 270 degrees)
+DEFAULT_ROTATE="0"
+
+ROTATE="$DEFAULT_ROTATE"
+
+# Option to mirror frame (empty if disabled)
+MIRROR=""
+
+# Option to correct lens distortion (empty if disabled)
+LENS=""
+
+# Option to profile render passes (empty if disabled)
+PERF=""
+
 # ---------- FUNC ----------
 
 # Check if a kernel module is loaded or not?
@@ -62,6 +84,12 @@ function usage
     printf "%b" "-w, --width\tSet the frame width (default: $DEFAULT_WIDTH).\n" 
     printf "%b" "-h, --height\tSet the frame height (default: $DEFAULT_HEIGHT).\n"
     printf "%b" "-f, --fps\tSet the frame rate (default: $DEFAULT_FRAMERATE).\n"
+    printf "%b" "-o, --output\tSet the output size, such as 1280x720 (default: frame size).\n"
+    printf "%b" "-z, --zoom\tZoom into the center of frame (default: $DEFAULT_ZOOM).\n"
+    printf "%b" "-r, --rotate\tRotate frame clockwise by 0, 90, 180, or 270 degrees (default: $DEFAULT_ROTATE).\n"
+    printf "%b" "-m, --mirror\tMirror frame horizontally (h), vertically (v), or both (hv).\n"
+    printf "%b" "-l, --lens\tCorrect radial lens distortion with coefficients K1,K2, such as -0.3,0.1.\n"
+    printf "%b" "-p, --perf\tPrint GPU time of each render pass periodically.\n"
     exit 1
 }
 
@@ -91,6 +119,35 @@ do
             FRAMERATE="$2"
             shift 2
             ;;
+        -o|--output)
+            [ $# -gt 1 ] || usage
+            OUTPUT="-o $2"
+            shift 2
+            ;;
+        -z|--zoom)
+            [ $# -gt 1 ] || usage
+            ZOOM="$2"
+            shift 2
+            ;;
+        -r|--rotate)
+            [ $# -gt 1 ] || usage
+            ROTATE="$2"
+            shift 2
+            ;;
+        -m|--mirror)
+            [ $# -gt 1 ] || usage
+            MIRROR="-m $2"
+            shift 2
+            ;;
+        -l|--lens)
+            [ $# -gt 1 ] || usage
+            LENS="-l $2"
+            shift 2
+            ;;
+        -p|--perf)
+            PERF="-p"
+            shift
+            ;;
         *)
             usage
             ;;
@@ -119,7 +176,7 @@ modprobe $UVC_DRIVER allocators=1
 if [ $? -eq 0 ]
 then
     echo "Running sample application"
-    ./main -d $CAM_DEVICE -w $WIDTH -h $HEIGHT -f $FRAMERATE
+    ./main -d $CAM_DEVICE -w $WIDTH -h $HEIGHT -f $FRAMERATE -z $ZOOM -r $ROTATE $MIRROR $LENS $OUTPUT $PERF
 fi
 
 # Restore current log level
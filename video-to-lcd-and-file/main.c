@@ -10,11 +10,25 @@
 #include <pthread.h>
 
 #include "gl.h"
+#include "batch.h"
+#include "image.h"
+#include "shader.h"
 #include "wl.h"
 #include "egl.h"
 #include "omx.h"
 #include "util.h"
 #include "v4l2.h"
+#include "overlay.h"
+#include "perf.h"
+#include "lens.h"
+#include "denoise.h"
+#include "mask.h"
+#include "motion.h"
+#include "snapshot.h"
+#include "pip.h"
+#include "stabilize.h"
+#include "timestamp.h"
+#include "ipc.h"
 #include "prog.h"
 #include "mmngr.h"
 #include "queue.h"
@@ -27,6 +41,29 @@
 
 #define FONT_FILE "LiberationSans-Regular.ttf"
 
+/* Color standard and range of camera, used to select shader variants.
+ * For example, '(SHADER_BT709 | SHADER_LIMITED_RANGE)' */
+#define CAM_COLOR_FLAGS 0
+
+/* Sprite sheet of 4 frames (in 1 row) and the size of image atlas */
+#define SPINNER_FILE "spinner.png"
+#define SPINNER_COLS 4
+
+#define IMAGE_ATLAS_SIZE 512
+
+/* The sprite shows its next frame after this number of video frames */
+#define SPINNER_FRAME_INTERVAL 8
+
+/* Internal format of overlay layer. 'GL_RGBA4' or 'GL_RGB5_A1' halve its
+ * memory and the bandwidth of redrawing and blending it (see option '-p') */
+#define OVERLAY_FORMAT GL_RGBA8
+
+/* The maximum number of shapes drawn with a single draw call */
+#define MAX_SHAPE_COUNT 256
+
+/* The maximum number of vertices of polygons drawn with a single draw call */
+#define MAX_POLYGON_VERT_COUNT 1024
+
 /********************************** FOR V4L2 **********************************/
 
 /* The sample app is tested OK with:
@@ -70,6 +107,9 @@
 /* 1: Interrupt signal */
 volatile sig_atomic_t g_int_signal = 0;
 
+/* 1: Snapshot is requested ('SIGUSR1') */
+volatile sig_atomic_t g_snapshot_signal = 0;
+
 /******************************************************************************
  *                           STRUCTURE DEFINITIONS                            *
  ******************************************************************************/
@@ -104,6 +144,53 @@ typedef struct
     /* Frame height of camera */
     size_t cam_height;
 
+    /* Size of NV12 frames (sent to the encoder and displayed) */
+    size_t out_width;
+    size_t out_height;
+
+    /* Digital zoom into the center of camera frame */
+    float zoom;
+
+    /* Rotation and mirroring of camera frame */
+    uint32_t rotation;
+    bool b_mirror_x;
+    bool b_mirror_y;
+
+    /* Way to write NV12 frames ('NV12_WRITER_AUTO'...) */
+    uint32_t nv12_writer;
+
+    /* Radial distortion coefficients of lens */
+    float lens_k1;
+    float lens_k2;
+
+    /* Max weight of previous frame in temporal denoise (0: no denoise) */
+    float denoise;
+
+    /* File of privacy masks (NULL if there are no masks) */
+    const char * p_mask_file;
+
+    /* File which results of motion detection are written to (NULL if motion
+     * is not detected) */
+    const char * p_motion_file;
+
+    /* Prefix of snapshot files (NULL if snapshots are disabled) */
+    const char * p_snapshot_prefix;
+
+    /* Device file of the second camera (NULL if there is none) and area of
+     * its inset (size is 0 for the default area) */
+    const char * p_pip_dev;
+    rect_t pip_area;
+
+    /* Stabilize camera frames */
+    bool b_stabilize;
+
+    /* Burn capture time and frame counter into frames */
+    bool b_timestamp;
+
+    /* Name of shared memory for overlay commands of external processes
+     * (NULL if it's not created) */
+    const char * p_ipc_name;
+
     /* YUYV buffers */
     v4l2_dmabuf_exp_t * p_yuyv_bufs;
 
@@ -128,6 +215,9 @@ typedef struct
      * buffer in 'p_queue' */
     pthread_cond_t * p_cond_available;
 
+    /* Profile render passes on the GPU */
+    bool b_perf;
+
 } in_data_t;
 
 /* This structure is for output thread */
@@ -158,6 +248,8 @@ typedef struct
 
 void sigint_handler(int signum, siginfo_t * p_info, void * p_ptr);
 
+void sigusr1_handler(int signum, siginfo_t * p_info, void * p_ptr);
+
 /********************************** FOR OMX ***********************************/
 
 /* The method is used to notify the application when an event of interest
@@ -231,6 +323,30 @@ int main(int argc, char * p_argv[])
     opt.height        = DEFAULT_FRAME_HEIGHT;
     opt.framerate.num = DEFAULT_FRAME_RATE;
     opt.framerate.den = 1;
+    opt.out_width     = 0;
+    opt.out_height    = 0;
+    opt.sub_width     = 0;
+    opt.sub_height    = 0;
+    opt.zoom          = 1.0f;
+    opt.rotation      = 0;
+    opt.b_mirror_x    = false;
+    opt.b_mirror_y    = false;
+    opt.nv12_writer   = NV12_WRITER_AUTO;
+    opt.lens_k1       = 0.0f;
+    opt.lens_k2       = 0.0f;
+    opt.denoise       = 0.0f;
+    opt.mask_file[0]  = '\0';
+    opt.motion_file[0] = '\0';
+    opt.snapshot_prefix[0] = '\0';
+    opt.pip_dev[0]    = '\0';
+    opt.pip_x         = 0;
+    opt.pip_y         = 0;
+    opt.pip_width     = 0;
+    opt.pip_height    = 0;
+    opt.b_stabilize   = false;
+    opt.b_timestamp   = false;
+    opt.ipc_name[0]   = '\0';
+    opt.b_perf        = false;
 
     /* Interrupt signal */
     struct sigaction sig_act;
@@ -310,6 +426,15 @@ int main(int argc, char * p_argv[])
     assert((opt.width > 0) && (opt.height > 0));
     assert(IS_FRAMERATE_VALID(opt.framerate));
 
+    /* Take a snapshot on 'SIGUSR1' only if option '-j' is given. Otherwise,
+     * the signal keeps its default action */
+    if (opt.snapshot_prefix[0] != '\0')
+    {
+        sig_act.sa_sigaction = sigusr1_handler;
+
+        sigaction(SIGUSR1, &sig_act, NULL);
+    }
+
     /* Open camera */
     cam_fd = v4l2_open_dev(opt.cam_dev);
     assert(cam_fd != -1);
@@ -365,8 +490,8 @@ int main(int argc, char * p_argv[])
      **************************************************************************/
 
     p_nv12_bufs = mmngr_alloc_nv12_dmabufs(NV12_BUFFER_COUNT,
-                                           NV12_FRAME_SZ(opt.width,
-                                                         opt.height));
+                                           NV12_FRAME_SZ(opt.out_width,
+                                                         opt.out_height));
     assert(p_nv12_bufs != NULL);
 
     /**************************************************************************
@@ -386,7 +511,7 @@ int main(int argc, char * p_argv[])
     omx_print_mc_role(handle);
 
     /* Configure input port */
-    assert(omx_set_in_port_fmt(handle, opt.width, opt.height,
+    assert(omx_set_in_port_fmt(handle, opt.out_width, opt.out_height,
                                OMX_COLOR_FormatYUV420SemiPlanar));
 
     assert(omx_set_port_buf_cnt(handle, 0, NV12_BUFFER_COUNT));
@@ -481,6 +606,33 @@ int main(int argc, char * p_argv[])
     in_data.cam_fd           = cam_fd;
     in_data.cam_width        = opt.width;
     in_data.cam_height       = opt.height;
+    in_data.out_width        = opt.out_width;
+    in_data.out_height       = opt.out_height;
+    in_data.zoom             = opt.zoom;
+    in_data.rotation         = opt.rotation;
+    in_data.b_mirror_x       = opt.b_mirror_x;
+    in_data.b_mirror_y       = opt.b_mirror_y;
+    in_data.nv12_writer      = opt.nv12_writer;
+    in_data.lens_k1          = opt.lens_k1;
+    in_data.lens_k2          = opt.lens_k2;
+    in_data.denoise          = opt.denoise;
+    in_data.p_mask_file      = (opt.mask_file[0] != '\0') ? opt.mask_file :
+                                                             NULL;
+    in_data.p_motion_file    = (opt.motion_file[0] != '\0') ?
+                               opt.motion_file : NULL;
+    in_data.p_snapshot_prefix = (opt.snapshot_prefix[0] != '\0') ?
+                                opt.snapshot_prefix : NULL;
+
+    in_data.p_pip_dev       = (opt.pip_dev[0] != '\0') ? opt.pip_dev : NULL;
+    in_data.pip_area.x      = opt.pip_x;
+    in_data.pip_area.y      = opt.pip_y;
+    in_data.pip_area.width  = opt.pip_width;
+    in_data.pip_area.height = opt.pip_height;
+
+    in_data.b_stabilize = opt.b_stabilize;
+    in_data.b_timestamp = opt.b_timestamp;
+    in_data.p_ipc_name  = (opt.ipc_name[0] != '\0') ? opt.ipc_name : NULL;
+
     in_data.p_yuyv_bufs      = p_yuyv_bufs;
     in_data.p_nv12_bufs      = p_nv12_bufs;
     in_data.handle           = handle;
@@ -488,6 +640,7 @@ int main(int argc, char * p_argv[])
     in_data.p_queue          = &in_queue;
     in_data.p_mutex          = &mut_in;
     in_data.p_cond_available = &cond_in_available;
+    in_data.b_perf           = opt.b_perf;
 
     /**************************************************************************
      *                STEP 13: PREPARE DATA FOR OUTPUT THREAD                 *
@@ -590,6 +743,16 @@ void sigint_handler(int signum, siginfo_t * p_info, void * p_ptr)
     g_int_signal = 1;
 }
 
+void sigusr1_handler(int signum, siginfo_t * p_info, void * p_ptr)
+{
+    /* Mark parameters as unused */
+    UNUSED(p_ptr);
+    UNUSED(p_info);
+    UNUSED(signum);
+
+    g_snapshot_signal = 1;
+}
+
 /********************************** FOR OMX ***********************************/
 
 OMX_ERRORTYPE omx_event_handler(OMX_HANDLETYPE hComponent, OMX_PTR pAppData,
@@ -743,25 +906,171 @@ void * thread_input(void * p_param)
     /* OpenGL ES */
     GLuint rec_prog = 0;
     GLuint text_prog = 0;
-    GLuint render_tex_prog = 0;
-    GLuint yuyv_to_rgb_prog = 0;
-    GLuint rgb_to_nv12_prog = 0;
+    GLuint sdf_text_prog = 0;
+    GLuint batch_prog = 0;
+    GLuint render_nv12_prog = 0;
+    GLuint yuyv_to_nv12_prog = 0;
+    GLuint yuyv_to_luma_prog = 0;
+    GLuint yuyv_to_chroma_prog = 0;
+    GLuint denoise_prog = 0;
+    GLuint mask_src_prog = 0;
+    GLuint blur_prog = 0;
+    GLuint mask_prog = 0;
+    GLuint motion_prog = 0;
+    GLuint snapshot_prog = 0;
+    GLuint stab_luma_prog = 0;
+    GLuint stab_prog = 0;
+
+    /* Programs of the fused conversion pass (any of them may be 0) */
+    GLuint fused_progs[3] = { 0, 0, 0 };
+    uint32_t prog_index = 0;
+
+    /* Base variant of programs which sample camera frames, and of programs
+     * which write NV12 frames (they sample denoised frames if option '-t'
+     * is given) */
+    uint32_t cam_flags = 0;
+    uint32_t writer_flags = 0;
+
+    /* NV12 frames are written in 1 pass with 'GL_EXT_YUV_target' (YUV
+     * writer), or in 2 passes to Y and UV planes (plane writer). Option '-n'
+     * can force the plane writer, or alternate both to compare them */
+    bool b_yuv_target   = false;
+    bool b_yuv_writer   = false;
+    bool b_plane_writer = false;
+    bool b_write_planes = false;
 
     gl_res_t gl_res;
 
+    /* Crop, scaling and orientation of camera frame (to NV12 frame), and
+     * the resources for converting it ('gl_res' with 'p_scaler' set) */
+    scaler_t conv_scaler;
+    gl_res_t conv_res;
+
+    /* The same for UV plane of NV12 frame (half the size) */
+    scaler_t chroma_scaler;
+    gl_res_t chroma_res;
+
+    /* Lens correction mesh of the conversion pass (option '-l') */
+    mesh_t lens_mesh = { 0 };
+
+    /* Temporal denoise (option '-t').
+     * When it's used, camera frame is converted by the denoise pass, and
+     * NV12 writers copy denoised frame 1:1 with 'write_res'. Otherwise,
+     * 'write_res' is 'conv_res' */
+    denoise_t denoise = { 0 };
+
+    scaler_t write_scaler;
+    gl_res_t write_res;
+
+    /* Privacy masks (option '-k') */
+    mask_t mask = { 0 };
+
+    /* Motion detection (option '-a'), the file which its results are
+     * written to, and moving cells which are drawn on overlay */
+    motion_t motion = { 0 };
+    FILE * p_motion_file = NULL;
+
+    uint16_t drawn_grid[MOTION_GRID_ROWS] = { 0 };
+    uint16_t changed_cells = 0;
+    uint32_t col = 0;
+    uint32_t row = 0;
+    rect_t cell;
+
+    /* JPEG snapshots of output (option '-j') */
+    snapshot_t * p_snapshot = NULL;
+
+    /* Picture-in-picture of the second camera (option '-i') */
+    pip_t pip = { 0 };
+
+    /* Digital image stabilization (option '-b') */
+    stabilize_t stab = { 0 };
+
+    /* Capture time and frame counter (option '-c') */
+    timestamp_t stamp = { 0 };
+
+    /* Overlay commands of external processes (option '-x') and the area
+     * of their previous list */
+    ipc_t * p_ipc = NULL;
+    rect_t ipc_bounds;
+
+    /* Batch of shapes (such as bounding boxes) */
+    batch_t batch;
+
+    /* Points of polyline and vertices of polygon (star) */
+    float line_points[] = { 40.0f, 200.0f, 90.0f, 260.0f,
+                            140.0f, 220.0f, 190.0f, 280.0f };
+
+    float star_verts[] = { 560.0f, 440.0f, 572.0f, 405.0f, 610.0f, 405.0f,
+                           580.0f, 383.0f, 591.0f, 347.0f, 560.0f, 369.0f,
+                           529.0f, 347.0f, 540.0f, 383.0f, 510.0f, 405.0f,
+                           548.0f, 405.0f };
+
+    /* Image atlas and animated sprite */
+    image_atlas_t atlas;
+
+    int spinner = -1;
+    uint32_t spinner_frame = 0;
+    uint32_t video_frames = 0;
+
+    /* Area of sprite (it's only redrawn when its frame changes) */
+    rect_t spinner_bounds = { 250, 150, 64, 64 };
+
+    /* Persistent overlay layer */
+    overlay_t overlay;
+
+    /* Profiler and its render passes */
+    perf_t * p_perf = NULL;
+
+    int overlay_pass = -1;
+    int denoise_pass = -1;
+    int mask_pass    = -1;
+    int motion_pass  = -1;
+    int nv12_pass    = -1;
+    int luma_pass    = -1;
+    int chroma_pass  = -1;
+    int display_pass = -1;
+    int snapshot_pass = -1;
+    int pip_pass     = -1;
+    int stab_pass    = -1;
+
+    /* Area of rectangle in the current and the last frame */
+    rect_t rec_bounds  = { 0 };
+    rect_t last_bounds = { 0 };
+
+    /* White text with black outline and half-transparent shadow */
+    text_style_t sdf_style =
+    {
+        .color           = { 1.0f, 1.0f, 1.0f },
+        .outline_color   = { 0.0f, 0.0f, 0.0f },
+        .outline_width   = 2.0f,
+        .shadow_color    = { 0.0f, 0.0f, 0.0f },
+        .shadow_opacity  = 0.5f,
+        .shadow_offset_x = 3.0f,
+        .shadow_offset_y = 3.0f,
+    };
+
     /* YUYV images and textures */
     EGLImageKHR * p_yuyv_imgs = NULL;
     GLuint      * p_yuyv_texs = NULL;
 
-    /* RGB textures and framebuffers */
-    GLuint * p_rgb_texs = NULL;
-    GLuint * p_rgb_fbs  = NULL;
+    /* Textures sampled by the fused conversion pass: camera frame, overlay,
+     * and privacy masks (low resolution frame and coverage) if any */
+    GLenum fused_targets[4] = { GL_TEXTURE_EXTERNAL_OES, GL_TEXTURE_2D,
+                                GL_TEXTURE_2D, GL_TEXTURE_2D };
+    GLuint fused_texs[4]    = { 0, 0, 0, 0 };
+    uint32_t fused_count    = 2;
 
     /* NV12 images, textures, and framebuffers */
     EGLImageKHR * p_nv12_imgs = NULL;
     GLuint      * p_nv12_texs = NULL;
     GLuint      * p_nv12_fbs  = NULL;
 
+    /* Images, textures, and framebuffers of Y and UV planes of NV12 buffers
+     * (2 per buffer, for the plane writer) */
+    EGLImageKHR * p_plane_imgs = NULL;
+    GLuint      * p_plane_texs = NULL;
+    GLuint      * p_plane_fbs  = NULL;
+
     /* Check parameter */
     assert(p_data != NULL);
 
@@ -775,7 +1084,7 @@ void * thread_input(void * p_param)
 
     /* Create Wayland window */
     p_wl_window = wl_create_window(p_wl_display, WINDOW_TITLE,
-                                   p_data->cam_width, p_data->cam_height);
+                                   p_data->out_width, p_data->out_height);
     assert(p_wl_window != NULL);
 
     /**************************************************************************
@@ -804,32 +1113,315 @@ void * thread_input(void * p_param)
      *                        STEP 3: SET UP OPENGL ES                        *
      **************************************************************************/
 
+    /* Choose NV12 writer. Without 'GL_EXT_YUV_target', YUV textures are
+     * also sampled in RGB */
+    b_yuv_target = gl_is_ext_supported("GL_EXT_YUV_target");
+
+    b_yuv_writer   = b_yuv_target &&
+                     (p_data->nv12_writer != NV12_WRITER_PLANES);
+    b_plane_writer = !b_yuv_writer ||
+                     (p_data->nv12_writer == NV12_WRITER_BENCH);
+
+    cam_flags = CAM_COLOR_FLAGS | (b_yuv_target ? 0 : SHADER_RGB_INPUT);
+
+    writer_flags = SHADER_OVERLAY | cam_flags |
+                   ((p_data->denoise > 0.0f) ? SHADER_RGBA_INPUT : 0) |
+                   ((p_data->p_mask_file != NULL) ? SHADER_MASK : 0);
+
+    printf("NV12 writer: %s\n", !b_plane_writer ? "1 pass (YUV target)" :
+                                !b_yuv_writer   ? "2 passes (Y and UV planes)" :
+                                                  "both (alternate frames)");
+
     /* Create program object for drawing rectangle */
-    rec_prog = gl_create_prog_from_src("rectangle.vs.glsl",
-                                       "rectangle.fs.glsl");
+    rec_prog = shader_create_prog(SHADER_PROG_RECTANGLE, 0);
 
     /* Create program object for drawing text */
-    text_prog = gl_create_prog_from_src("text.vs.glsl", "text.fs.glsl");
+    text_prog = shader_create_prog(SHADER_PROG_TEXT, 0);
+
+    /* Create program object for drawing text from signed distance field */
+    sdf_text_prog = shader_create_prog(SHADER_PROG_SDF_TEXT, 0);
+
+    /* Create program object for drawing batches of shapes */
+    batch_prog = shader_create_prog(SHADER_PROG_BATCH, 0);
 
-    /* Create program object for rendering RGB texture */
-    render_tex_prog = gl_create_prog_from_src("render-rgb.vs.glsl",
-                                              "render-rgb.fs.glsl");
+    /* Create program object for rendering NV12 texture to the window */
+    render_nv12_prog = shader_create_prog(SHADER_PROG_YUV_TO_RGB,
+                                          SHADER_FLIP_Y | cam_flags);
 
-    /* Create program object for converting YUYV to RGB */
-    yuyv_to_rgb_prog = gl_create_prog_from_src("yuyv-to-rgb.vs.glsl",
-                                               "yuyv-to-rgb.fs.glsl");
+    /* Create program object for converting YUYV to NV12 and blending
+     * overlay in a single pass */
+    if (b_yuv_writer)
+    {
+        yuyv_to_nv12_prog = shader_create_prog(SHADER_PROG_YUYV_TO_NV12,
+                                               writer_flags);
+    }
+
+    /* Create program objects for doing the same to Y plane and UV plane */
+    if (b_plane_writer)
+    {
+        yuyv_to_luma_prog = shader_create_prog(SHADER_PROG_YUYV_TO_NV12,
+                                               writer_flags |
+                                               SHADER_LUMA_OUTPUT);
+
+        yuyv_to_chroma_prog = shader_create_prog(SHADER_PROG_YUYV_TO_NV12,
+                                                 writer_flags |
+                                                 SHADER_CHROMA_OUTPUT);
+    }
+
+    /* The fused pass samples YUYV texture from texture unit 0, overlay
+     * from texture unit 1, and privacy masks from texture units 2 and 3 */
+    fused_progs[0] = yuyv_to_nv12_prog;
+    fused_progs[1] = yuyv_to_luma_prog;
+    fused_progs[2] = yuyv_to_chroma_prog;
+
+    for (prog_index = 0; prog_index < 3; prog_index++)
+    {
+        if (fused_progs[prog_index] == 0)
+        {
+            continue;
+        }
 
-    /* Create program object for converting RGB to NV12 */
-    rgb_to_nv12_prog = gl_create_prog_from_src("rgb-to-nv12.vs.glsl",
-                                               "rgb-to-nv12.fs.glsl");
+        glUseProgram(fused_progs[prog_index]);
+        glUniform1i(glGetUniformLocation(fused_progs[prog_index],
+                                         "yuyvTexture"), 0);
+        glUniform1i(glGetUniformLocation(fused_progs[prog_index],
+                                         "overlayTexture"), 1);
+        glUniform1i(glGetUniformLocation(fused_progs[prog_index],
+                                         "maskTexture"), 2);
+        glUniform1i(glGetUniformLocation(fused_progs[prog_index],
+                                         "coverTexture"), 3);
+    }
 
     /* Create resources needed for rendering */
-    gl_res = gl_create_resources(p_data->cam_width,
-                                 p_data->cam_height, FONT_FILE);
+    gl_res = gl_create_resources(p_data->out_width,
+                                 p_data->out_height, FONT_FILE);
+
+    /* Scale camera frame to NV12 frame (keep its aspect ratio), zoom into
+     * its center, then rotate/mirror it. Overlay is drawn in the coordinates
+     * of NV12 frame, so it is not affected by them */
+    conv_scaler = gl_init_scaler(p_data->cam_width, p_data->cam_height,
+                                 p_data->out_width, p_data->out_height, true);
+
+    gl_set_zoom(&conv_scaler, p_data->zoom,
+                p_data->cam_width / 2.0f, p_data->cam_height / 2.0f);
+
+    gl_set_orientation(&conv_scaler, p_data->rotation,
+                       p_data->b_mirror_x, p_data->b_mirror_y);
+
+    /* Camera frame sampled as packed YUYV is not interpolated. Without
+     * 'GL_EXT_YUV_target', the driver converts it to RGB before filtering */
+    conv_scaler.filter = b_yuv_target ? GL_NEAREST : GL_LINEAR;
+
+    conv_res = gl_res;
+    conv_res.p_scaler = &conv_scaler;
+
+    /* UV plane has the same crop and orientation, at half the size */
+    chroma_scaler = conv_scaler;
+    chroma_scaler.dst_width  = p_data->out_width / 2;
+    chroma_scaler.dst_height = p_data->out_height / 2;
+
+    chroma_res = gl_res;
+    chroma_res.p_scaler = &chroma_scaler;
+
+    /* Correct lens distortion in the conversion pass with a mesh. Texture
+     * coordinates are normalized, so UV plane uses the same mesh */
+    if ((p_data->lens_k1 != 0.0f) || (p_data->lens_k2 != 0.0f))
+    {
+        lens_mesh = lens_create_mesh(p_data->lens_k1, p_data->lens_k2,
+                                     &conv_scaler, false);
+        assert(lens_mesh.vbo != 0);
+
+        conv_res.p_mesh   = &lens_mesh;
+        chroma_res.p_mesh = &lens_mesh;
+    }
+
+    write_res = conv_res;
+
+    /* Denoise camera frame before it's written to NV12 frame. Overlay is
+     * blended by NV12 writers, so it's never blended with the previous
+     * frame. Crop, scaling, and lens correction are done by the denoise
+     * pass, so UV plane is just half the size of denoised frame */
+    if (p_data->denoise > 0.0f)
+    {
+        denoise_prog = shader_create_prog(SHADER_PROG_DENOISE, cam_flags);
+
+        denoise = denoise_create(p_data->out_width, p_data->out_height,
+                                 p_data->denoise);
+        assert((denoise.texs[1] != 0) && (denoise.fbs[1] != 0));
+
+        write_scaler = gl_init_scaler(p_data->out_width, p_data->out_height,
+                                      p_data->out_width, p_data->out_height,
+                                      false);
+
+        write_res = gl_res;
+        write_res.p_scaler = &write_scaler;
+
+        chroma_scaler = write_scaler;
+        chroma_scaler.dst_width  = p_data->out_width / 2;
+        chroma_scaler.dst_height = p_data->out_height / 2;
+
+        chroma_res = gl_res;
+        chroma_res.p_scaler = &chroma_scaler;
+
+        fused_targets[0] = GL_TEXTURE_2D;
+    }
+
+    /* Pixelate or blur privacy masks. Their content is rendered from the
+     * camera frame with the crop, scaling, and lens correction of the
+     * conversion pass. NV12 writers replace covered pixels of the camera
+     * frame with it before they blend overlay. So, masks stay under overlay
+     * and the cached overlay layer is never redrawn because of them */
+    if (p_data->p_mask_file != NULL)
+    {
+        mask_src_prog = shader_create_prog(SHADER_PROG_YUV_TO_RGB, cam_flags);
+        blur_prog     = shader_create_prog(SHADER_PROG_BLUR, 0);
+        mask_prog     = shader_create_prog(SHADER_PROG_MASK, 0);
+
+        mask = mask_create(p_data->out_width, p_data->out_height,
+                           p_data->p_mask_file);
+        assert((mask.vbo != 0) && (mask.fbs[1] != 0));
+
+        /* Regions never move, so their coverage is drawn once */
+        assert(mask_draw_coverage(&mask, mask_prog, gl_res));
+
+        fused_texs[2] = mask.texs[0];
+        fused_texs[3] = mask.cover_tex;
+        fused_count   = 4;
+    }
+
+    /* Detect motion in the output */
+    if (p_data->p_motion_file != NULL)
+    {
+        motion_prog = shader_create_prog(SHADER_PROG_MOTION, cam_flags);
+
+        motion = motion_create();
+        assert((motion.fbs[1] != 0) && (motion.pbos[0] != 0));
+
+        p_motion_file = fopen(p_data->p_motion_file, "w");
+        if (p_motion_file == NULL)
+        {
+            printf("Error: Failed to open '%s'\n", p_data->p_motion_file);
+        }
+        assert(p_motion_file != NULL);
+    }
+
+    /* Take snapshots of output (the frame sent to the encoder) on
+     * 'SIGUSR1' */
+    if (p_data->p_snapshot_prefix != NULL)
+    {
+        snapshot_prog = shader_create_prog(SHADER_PROG_YUV_TO_RGB, cam_flags);
+
+        p_snapshot = snapshot_create(p_data->out_width, p_data->out_height,
+                                     p_data->p_snapshot_prefix);
+        assert(p_snapshot != NULL);
+    }
+
+    /* Stabilize camera frames by moving the crop of the conversion pass */
+    if (p_data->b_stabilize)
+    {
+        stab_luma_prog = shader_create_prog(SHADER_PROG_MOTION, cam_flags);
+        stab_prog      = shader_create_prog(SHADER_PROG_STABILIZE, 0);
+
+        stab = stabilize_create(p_data->cam_width, p_data->cam_height);
+        assert(stab.cost_fb != 0);
+    }
+
+    /* Burn capture time into the top-left corner of output */
+    if (p_data->b_timestamp)
+    {
+        stamp = timestamp_create(TIMESTAMP_MARGIN,
+                                 p_data->out_height - TIMESTAMP_MARGIN -
+                                 TIMESTAMP_TEXT_SIZE,
+                                 TIMESTAMP_TEXT_SIZE, gl_res);
+    }
+
+    /* Let external processes (such as a detector) draw on overlay */
+    if (p_data->p_ipc_name != NULL)
+    {
+        p_ipc = ipc_create(p_data->p_ipc_name, p_data->out_width,
+                           p_data->out_height);
+        assert(p_ipc != NULL);
+    }
 
     /* Initialize OpenGL ES extension functions */
     assert(gl_init_ext_funcs());
 
+    /* Draw the second camera as an inset on overlay. It's rendered in RGB
+     * like NV12 frames to the window */
+    if (p_data->p_pip_dev != NULL)
+    {
+        pip = pip_create(display, p_data->p_pip_dev, p_data->pip_area,
+                         p_data->out_width, p_data->out_height);
+        assert(pip.p_texs != NULL);
+    }
+
+    /* Create batch of shapes */
+    batch = batch_create(MAX_SHAPE_COUNT, MAX_POLYGON_VERT_COUNT);
+    assert(batch.p_insts != NULL);
+
+    /* Create image atlas and load sprite sheet into it */
+    atlas = image_atlas_create(IMAGE_ATLAS_SIZE, IMAGE_ATLAS_SIZE);
+    assert(atlas.tex != 0);
+
+    spinner = image_atlas_add_png(&atlas, SPINNER_FILE, SPINNER_COLS, 1);
+    assert(spinner != -1);
+
+    /* Create overlay layer */
+    overlay = overlay_create(p_data->out_width, p_data->out_height,
+                             OVERLAY_FORMAT);
+    assert((overlay.tex != 0) && (overlay.fb != 0));
+
+    printf("Overlay: %ux%u, %zu KiB\n", overlay.width, overlay.height,
+           overlay.size / 1024);
+
+    /* Create profiler (it does nothing unless option '-p' is given) */
+    p_perf = perf_create(p_data->b_perf);
+    assert(p_perf != NULL);
+
+    if (p_data->b_stabilize)
+    {
+        stab_pass = perf_add_pass(p_perf, "stabilize");
+    }
+
+    if (p_data->p_mask_file != NULL)
+    {
+        mask_pass = perf_add_pass(p_perf, "masks");
+    }
+
+    if (p_data->p_motion_file != NULL)
+    {
+        motion_pass = perf_add_pass(p_perf, "motion");
+    }
+
+    if (p_data->p_pip_dev != NULL)
+    {
+        pip_pass = perf_add_pass(p_perf, "pip");
+    }
+
+    overlay_pass = perf_add_pass(p_perf, "overlay");
+    if (p_data->denoise > 0.0f)
+    {
+        denoise_pass = perf_add_pass(p_perf, "denoise");
+    }
+
+    if (b_yuv_writer)
+    {
+        nv12_pass = perf_add_pass(p_perf, "nv12 write");
+    }
+
+    if (b_plane_writer)
+    {
+        luma_pass   = perf_add_pass(p_perf, "nv12 luma");
+        chroma_pass = perf_add_pass(p_perf, "nv12 chroma");
+    }
+
+    display_pass = perf_add_pass(p_perf, "display");
+
+    if (p_data->p_snapshot_prefix != NULL)
+    {
+        snapshot_pass = perf_add_pass(p_perf, "snapshot");
+    }
+
     /**************************************************************************
      *               STEP 4: CREATE TEXTURES FROM YUYV BUFFERS                *
      **************************************************************************/
@@ -864,46 +1456,59 @@ void * thread_input(void * p_param)
     assert(p_yuyv_texs != NULL);
 
     /**************************************************************************
-     *          STEP 5: CREATE FRAMEBUFFERS FROM EMPTY RGB TEXTURES           *
-     **************************************************************************/
-
-    /* Create RGB textures */
-    p_rgb_texs = gl_create_rgb_textures(p_data->cam_width, p_data->cam_height,
-                                        NULL, YUYV_BUFFER_COUNT);
-    assert(p_rgb_texs != NULL);
-
-    /* Create framebuffers */
-    p_rgb_fbs = gl_create_framebuffers(GL_TEXTURE_2D,
-                                       p_rgb_texs, YUYV_BUFFER_COUNT);
-    assert(p_rgb_fbs != NULL);
-
-    /**************************************************************************
-     *               STEP 6: CREATE TEXTURES FROM NV12 BUFFERS                *
+     *               STEP 5: CREATE TEXTURES FROM NV12 BUFFERS                *
      **************************************************************************/
 
     /* Create NV12 EGLImage objects */
     p_nv12_imgs = egl_create_nv12_images(display,
-                                         p_data->cam_width,
-                                         p_data->cam_height,
+                                         p_data->out_width,
+                                         p_data->out_height,
                                          p_data->p_nv12_bufs,
                                          NV12_BUFFER_COUNT);
     assert(p_nv12_imgs != NULL);
 
-    /* Create NV12 textures */
+    /* Create NV12 textures (they are always sampled for display) */
     p_nv12_texs = gl_create_external_textures(p_nv12_imgs, NV12_BUFFER_COUNT);
     assert(p_nv12_texs != NULL);
 
+    /* Create EGLImage objects and textures of Y and UV planes. They share
+     * memory with NV12 images, so the encoder and display see the result */
+    if (b_plane_writer)
+    {
+        p_plane_imgs = egl_create_nv12_plane_images(display,
+                                                    p_data->out_width,
+                                                    p_data->out_height,
+                                                    p_data->p_nv12_bufs,
+                                                    NV12_BUFFER_COUNT);
+        assert(p_plane_imgs != NULL);
+
+        p_plane_texs = gl_create_plane_textures(p_plane_imgs,
+                                                2 * NV12_BUFFER_COUNT);
+        assert(p_plane_texs != NULL);
+    }
+
     /**************************************************************************
-     *             STEP 7: CREATE FRAMEBUFFERS FROM NV12 TEXTURES             *
+     *             STEP 6: CREATE FRAMEBUFFERS FROM NV12 TEXTURES             *
      **************************************************************************/
 
     /* Create framebuffers */
-    p_nv12_fbs = gl_create_framebuffers(GL_TEXTURE_EXTERNAL_OES,
-                                        p_nv12_texs, NV12_BUFFER_COUNT);
-    assert(p_nv12_fbs != NULL);
+    if (b_yuv_writer)
+    {
+        p_nv12_fbs = gl_create_framebuffers(GL_TEXTURE_EXTERNAL_OES,
+                                            p_nv12_texs, NV12_BUFFER_COUNT);
+        assert(p_nv12_fbs != NULL);
+    }
+
+    /* Create framebuffers of Y and UV planes */
+    if (b_plane_writer)
+    {
+        p_plane_fbs = gl_create_framebuffers(GL_TEXTURE_2D, p_plane_texs,
+                                             2 * NV12_BUFFER_COUNT);
+        assert(p_plane_fbs != NULL);
+    }
 
     /**************************************************************************
-     *                       STEP 8: THREAD'S MAIN LOOP                       *
+     *                       STEP 7: THREAD'S MAIN LOOP                       *
      **************************************************************************/
 
     while (is_running)
@@ -935,47 +1540,326 @@ void * thread_input(void * p_param)
         /* Receive camera's buffer */
         assert(v4l2_dequeue_buf(p_data->cam_fd, &cam_buf));
 
-        /* Bind framebuffer.
-         * All subsequent rendering operations will now render to
-         * RGB texture which is linked to the framebuffer (see above):
-         * https://learnopengl.com/Advanced-OpenGL/Framebuffers */
-        glBindFramebuffer(GL_FRAMEBUFFER, p_rgb_fbs[cam_buf.index]);
+        /* Estimate shake of camera frame and move the crop against it.
+         * Subsequent passes with 'conv_res' (and 'chroma_res' if it samples
+         * camera frame) use the new crop */
+        if (p_data->b_stabilize)
+        {
+            perf_begin(p_perf, stab_pass);
+
+            stabilize_update(&stab, stab_luma_prog, stab_prog,
+                             GL_TEXTURE_EXTERNAL_OES,
+                             p_yuyv_texs[cam_buf.index], gl_res);
+
+            stabilize_apply(&stab, &conv_scaler, p_data->zoom,
+                            p_data->cam_width / 2.0f,
+                            p_data->cam_height / 2.0f);
+
+            if (p_data->denoise <= 0.0f)
+            {
+                stabilize_apply(&stab, &chroma_scaler, p_data->zoom,
+                                p_data->cam_width / 2.0f,
+                                p_data->cam_height / 2.0f);
+            }
+
+            perf_end(p_perf, stab_pass);
+        }
+
+        /* The rectangle moves every frame. So, both its old and new areas
+         * must be redrawn. Other content is static */
+        rec_bounds = gl_get_rectangle_bounds(p_data->out_width,
+                                             p_data->out_height, gl_res);
+
+        overlay_invalidate(&overlay, last_bounds);
+        overlay_invalidate(&overlay, rec_bounds);
+
+        last_bounds = rec_bounds;
+
+        /* Redraw sprite only when its frame changes */
+        if ((video_frames % SPINNER_FRAME_INTERVAL) == 0)
+        {
+            spinner_frame = video_frames / SPINNER_FRAME_INTERVAL;
+            overlay_invalidate(&overlay, spinner_bounds);
+        }
+
+        video_frames++;
+
+        /* Content of masks changes every frame. It's applied by NV12
+         * writers, so overlay is not affected */
+        if (p_data->p_mask_file != NULL)
+        {
+            perf_begin(p_perf, mask_pass);
+
+            mask_update(&mask, mask_src_prog, blur_prog,
+                        GL_TEXTURE_EXTERNAL_OES, p_yuyv_texs[cam_buf.index],
+                        conv_res);
+
+            perf_end(p_perf, mask_pass);
+        }
+
+        /* Detect motion. Results arrive a frame or two later, so this never
+         * waits for the GPU. Only cells which start or stop moving are
+         * redrawn on overlay */
+        if (p_data->p_motion_file != NULL)
+        {
+            perf_begin(p_perf, motion_pass);
+
+            if (motion_update(&motion, motion_prog, GL_TEXTURE_EXTERNAL_OES,
+                              p_yuyv_texs[cam_buf.index], conv_res))
+            {
+                motion_write_result(&motion, p_motion_file);
+            }
+
+            perf_end(p_perf, motion_pass);
+
+            for (row = 0; row < MOTION_GRID_ROWS; row++)
+            {
+                changed_cells = drawn_grid[row] ^ motion.grid[row];
+
+                for (col = 0; col < MOTION_GRID_COLS; col++)
+                {
+                    if (((changed_cells >> col) & 1) == 0)
+                    {
+                        continue;
+                    }
+
+                    cell = motion_get_cell_rect(col, row, p_data->out_width,
+                                                p_data->out_height);
+
+                    overlay_invalidate(&overlay, cell);
+                }
+
+                drawn_grid[row] = motion.grid[row];
+            }
+        }
+
+        /* Take the latest frame of the second camera (it's never waited
+         * for). Its area of overlay is only redrawn when a frame arrives */
+        if (p_data->p_pip_dev != NULL)
+        {
+            perf_begin(p_perf, pip_pass);
+
+            if (pip_update(&pip))
+            {
+                overlay_invalidate(&overlay, pip.area);
+            }
+
+            perf_end(p_perf, pip_pass);
+        }
+
+        /* Capture time changes every frame. Only slots of changed digits
+         * are laid out again, and only its area of overlay is redrawn */
+        if (p_data->b_timestamp &&
+            timestamp_update(&stamp, &cam_buf, gl_res))
+        {
+            overlay_invalidate(&overlay, stamp.bounds);
+        }
+
+        /* Take the list of external processes for this frame. It's copied
+         * from shared memory without any system call. Areas of both the
+         * previous and the new list are redrawn if it changes */
+        if (p_ipc != NULL)
+        {
+            ipc_bounds = ipc_get_bounds(p_ipc);
+
+            if (ipc_update(p_ipc,
+                           ((uint64_t)cam_buf.timestamp.tv_sec * 1000000) +
+                           cam_buf.timestamp.tv_usec, cam_buf.sequence))
+            {
+                overlay_invalidate(&overlay, ipc_bounds);
+                overlay_invalidate(&overlay, ipc_get_bounds(p_ipc));
+            }
+        }
+
+        /* Redraw dirty areas of overlay */
+        perf_begin(p_perf, overlay_pass);
+
+        if (overlay_begin(&overlay))
+        {
+            /* Draw the second camera under shapes and text */
+            if (p_data->p_pip_dev != NULL)
+            {
+                pip_draw(&pip, render_nv12_prog, gl_res);
+            }
+
+            /* Draw rectangle */
+            gl_draw_rectangle(rec_prog, gl_res);
+
+            /* Draw bounding boxes and other shapes with a single draw call */
+            batch_add_rect(&batch, 400.0f, 250.0f, 160.0f, 120.0f,
+                           0.0f, GREEN, 1.0f, 3.0f);
+
+            batch_add_rect(&batch, 440.0f, 80.0f, 100.0f, 100.0f,
+                           15.0f, BLUE, 0.5f, 0.0f);
+
+            batch_add_rounded_rect(&batch, 40.0f, 320.0f, 140.0f, 60.0f,
+                                   0.0f, 15.0f, WHITE, 1.0f, 2.0f);
+
+            batch_add_circle(&batch, 330.0f, 400.0f, 30.0f, RED, 1.0f, 4.0f);
+
+            batch_add_polyline(&batch, line_points, 4, 3.0f, WHITE, 1.0f);
+
+            batch_add_polygon(&batch, star_verts, 10, GREEN, 1.0f, 0.0f);
+
+            batch_add_image(&batch, &atlas, spinner, spinner_frame,
+                            250.0f, 150.0f, 64.0f, 64.0f, 0.0f, 1.0f);
+
+            /* Outline moving cells (of the latest result) */
+            for (row = 0; row < MOTION_GRID_ROWS; row++)
+            {
+                for (col = 0; col < MOTION_GRID_COLS; col++)
+                {
+                    if (!motion_is_cell_moving(&motion, col, row))
+                    {
+                        continue;
+                    }
+
+                    cell = motion_get_cell_rect(col, row, p_data->out_width,
+                                                p_data->out_height);
+
+                    /* Inset by 1 pixel, so antialiased edges stay inside */
+                    batch_add_rect(&batch, cell.x + 1, cell.y + 1,
+                                   cell.width - 2, cell.height - 2,
+                                   0.0f, RED, 1.0f, 2.0f);
+                }
+            }
+
+            /* Add boxes and masks of external processes */
+            if (p_ipc != NULL)
+            {
+                ipc_add_shapes(p_ipc, &batch);
+            }
+
+            batch_flush(batch_prog, &batch, gl_res);
+
+            /* Draw text */
+            gl_draw_text(text_prog, "This is a text",
+                         25.0f, 25.0f, BLACK, gl_res);
+
+            /* Draw outlined text with shadow */
+            gl_draw_sdf_text(sdf_text_prog, "This is an SDF text",
+                             25.0f, 70.0f, 40.0f, &sdf_style, gl_res);
+
+            /* Draw labels of external processes */
+            if (p_ipc != NULL)
+            {
+                ipc_draw_labels(p_ipc, sdf_text_prog, &sdf_style, gl_res);
+            }
+
+            /* Draw capture time of camera frame */
+            if (p_data->b_timestamp)
+            {
+                timestamp_draw(&stamp, sdf_text_prog, &sdf_style, gl_res);
+            }
+
+            overlay_end(&overlay);
+        }
+
+        perf_end(p_perf, overlay_pass);
+
+        /* Convert YUYV texture to NV12 texture and blend overlay onto it.
+         * No intermediate RGB texture is needed, unless the camera frame
+         * is denoised (it's blended with the previous one first) */
+        fused_texs[0] = p_yuyv_texs[cam_buf.index];
+        fused_texs[1] = overlay.tex;
+
+        if (p_data->denoise > 0.0f)
+        {
+            perf_begin(p_perf, denoise_pass);
+
+            fused_texs[0] = denoise_apply(&denoise, denoise_prog,
+                                          GL_TEXTURE_EXTERNAL_OES,
+                                          p_yuyv_texs[cam_buf.index],
+                                          conv_res);
+
+            perf_end(p_perf, denoise_pass);
+        }
+
+        /* If both writers are used, they take turns */
+        b_write_planes = b_plane_writer &&
+                         (!b_yuv_writer || ((video_frames % 2) == 0));
 
-        /* Convert YUYV texture to RGB texture */
-        gl_render_texture(yuyv_to_rgb_prog, GL_TEXTURE_EXTERNAL_OES,
-                          p_yuyv_texs[cam_buf.index], gl_res);
+        if (!b_write_planes)
+        {
+            /* Bind framebuffer.
+             * All subsequent rendering operations will now render to
+             * NV12 texture which is linked to the framebuffer (see above):
+             * https://learnopengl.com/Advanced-OpenGL/Framebuffers */
+            glBindFramebuffer(GL_FRAMEBUFFER, p_nv12_fbs[index]);
+
+            perf_begin(p_perf, nv12_pass);
 
-        /* Draw rectangle */
-        gl_draw_rectangle(rec_prog, gl_res);
+            gl_render_textures(yuyv_to_nv12_prog, fused_targets,
+                               fused_texs, fused_count, write_res);
 
-        /* Draw text */
-        gl_draw_text(text_prog, "This is a text", 25.0f, 25.0f, BLACK, gl_res);
+            perf_end(p_perf, nv12_pass);
+        }
+        else
+        {
+            /* Write Y values to Y plane (R8) */
+            glBindFramebuffer(GL_FRAMEBUFFER, p_plane_fbs[2 * index]);
+
+            perf_begin(p_perf, luma_pass);
+
+            gl_render_textures(yuyv_to_luma_prog, fused_targets,
+                               fused_texs, fused_count, write_res);
+
+            perf_end(p_perf, luma_pass);
+
+            /* Write pairs of U and V values to UV plane (GR88) */
+            glBindFramebuffer(GL_FRAMEBUFFER, p_plane_fbs[(2 * index) + 1]);
+
+            perf_begin(p_perf, chroma_pass);
+
+            gl_render_textures(yuyv_to_chroma_prog, fused_targets,
+                               fused_texs, fused_count, chroma_res);
+
+            perf_end(p_perf, chroma_pass);
+        }
 
         /* Bind back to default framebuffer */
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
-        /* Render RGB frame */
-        gl_render_texture(render_tex_prog, GL_TEXTURE_2D,
-                          p_rgb_texs[cam_buf.index], gl_res);
+        /* Render NV12 frame (the same frame sent to the encoder).
+         * The window has the same size, so it is displayed as is */
+        perf_begin(p_perf, display_pass);
+
+        gl_render_texture(render_nv12_prog, GL_TEXTURE_EXTERNAL_OES,
+                          p_nv12_texs[index], gl_res);
+
+        perf_end(p_perf, display_pass);
 
         /* Display to monitor */
         eglSwapBuffers(display, surface);
 
-        /* Bind framebuffer.
-         * All subsequent rendering operations will now render to
-         * NV12 texture which is linked to the framebuffer (see above) */
-        glBindFramebuffer(GL_FRAMEBUFFER, p_nv12_fbs[index]);
+        /* Copy NV12 frame to the CPU if a snapshot is requested. It's
+         * encoded by a background thread a frame or two later, so no frame
+         * is dropped. A request waits while the previous one is encoded */
+        if (p_snapshot != NULL)
+        {
+            perf_begin(p_perf, snapshot_pass);
+
+            if (g_snapshot_signal &&
+                snapshot_capture(p_snapshot, snapshot_prog,
+                                 GL_TEXTURE_EXTERNAL_OES, p_nv12_texs[index],
+                                 gl_res))
+            {
+                g_snapshot_signal = 0;
+            }
+
+            snapshot_update(p_snapshot);
 
-        /* Convert RGB texture to NV12 texture */
-        gl_render_texture(rgb_to_nv12_prog, GL_TEXTURE_2D,
-                          p_rgb_texs[cam_buf.index], gl_res);
+            perf_end(p_perf, snapshot_pass);
+        }
+
+        perf_end_frame(p_perf);
 
         /* Reuse camera's buffer */
         assert(v4l2_enqueue_buf(p_data->cam_fd, cam_buf.index));
 
         /* If 'p_buf' contains data, 'nFilledLen' must not be zero */
-        p_buf->nFilledLen = NV12_FRAME_SZ(p_data->cam_width,
-                                          p_data->cam_height);
+        p_buf->nFilledLen = NV12_FRAME_SZ(p_data->out_width,
+                                          p_data->out_height);
 
         /* Section 6.14.1 in document 'R01USxxxxEJxxxx_vecmn_v1.0.pdf' */
         p_buf->nFlags = OMX_BUFFERFLAG_ENDOFFRAME;
@@ -993,34 +1877,94 @@ void * thread_input(void * p_param)
     }
 
     /**************************************************************************
-     *                       STEP 9: CLEAN UP OPENGL ES                       *
+     *                       STEP 8: CLEAN UP OPENGL ES                       *
      **************************************************************************/
 
+    /* Delete framebuffers and textures of Y and UV planes */
+    if (b_plane_writer)
+    {
+        gl_delete_framebuffers(p_plane_fbs, 2 * NV12_BUFFER_COUNT);
+
+        gl_delete_textures(p_plane_texs, 2 * NV12_BUFFER_COUNT);
+        egl_delete_images(display, p_plane_imgs, 2 * NV12_BUFFER_COUNT);
+    }
+
     /* Delete framebuffers and NV12 textures */
-    gl_delete_framebuffers(p_nv12_fbs, NV12_BUFFER_COUNT);
+    if (b_yuv_writer)
+    {
+        gl_delete_framebuffers(p_nv12_fbs, NV12_BUFFER_COUNT);
+    }
 
     gl_delete_textures(p_nv12_texs, NV12_BUFFER_COUNT);
     egl_delete_images(display, p_nv12_imgs, NV12_BUFFER_COUNT);
 
-    /* Delete framebuffers and RGB textyres */
-    gl_delete_framebuffers(p_rgb_fbs, YUYV_BUFFER_COUNT);
-    gl_delete_textures(p_rgb_texs, YUYV_BUFFER_COUNT);
-
     /* Delete YUYV textures */
     gl_delete_textures(p_yuyv_texs, YUYV_BUFFER_COUNT);
     egl_delete_images(display, p_yuyv_imgs, YUYV_BUFFER_COUNT);
 
+    /* Delete profiler */
+    perf_delete(p_perf);
+
+    /* Delete overlay layer */
+    overlay_delete(&overlay);
+
+    /* Delete batch of shapes */
+    batch_delete(&batch);
+
+    /* Delete image atlas */
+    image_atlas_delete(&atlas);
+
+    /* Delete lens correction mesh (nothing happens if it's not created) */
+    lens_delete_mesh(&lens_mesh);
+
+    /* Delete temporal denoise (nothing happens if it's not created) */
+    denoise_delete(&denoise);
+
+    /* Delete privacy masks (nothing happens if they're not created) */
+    mask_delete(&mask);
+
+    /* Delete motion detection and close its file */
+    motion_delete(&motion);
+
+    if (p_motion_file != NULL)
+    {
+        fclose(p_motion_file);
+    }
+
+    /* Delete snapshot (a snapshot being encoded is finished first) */
+    snapshot_delete(p_snapshot);
+
+    /* Stop the second camera (nothing happens if it's not opened) */
+    pip_delete(&pip);
+
+    /* Delete stabilization (nothing happens if it's not created) */
+    stabilize_delete(&stab);
+
+    /* Remove shared memory of overlay commands */
+    ipc_delete(p_ipc);
+
     /* Delete resources for OpenGL ES */
     gl_delete_resources(gl_res);
 
     glDeleteProgram(rec_prog);
     glDeleteProgram(text_prog);
-    glDeleteProgram(render_tex_prog);
-    glDeleteProgram(yuyv_to_rgb_prog);
-    glDeleteProgram(rgb_to_nv12_prog);
+    glDeleteProgram(sdf_text_prog);
+    glDeleteProgram(batch_prog);
+    glDeleteProgram(render_nv12_prog);
+    glDeleteProgram(yuyv_to_nv12_prog);
+    glDeleteProgram(yuyv_to_luma_prog);
+    glDeleteProgram(yuyv_to_chroma_prog);
+    glDeleteProgram(denoise_prog);
+    glDeleteProgram(mask_src_prog);
+    glDeleteProgram(blur_prog);
+    glDeleteProgram(mask_prog);
+    glDeleteProgram(motion_prog);
+    glDeleteProgram(snapshot_prog);
+    glDeleteProgram(stab_luma_prog);
+    glDeleteProgram(stab_prog);
 
     /**************************************************************************
-     *                          STEP 10: CLEAN UP EGL                         *
+     *                          STEP 9: CLEAN UP EGL                          *
      **************************************************************************/
 
     /* Delete EGL context */
@@ -1033,7 +1977,7 @@ void * thread_input(void * p_param)
     egl_disconnect_display(display);
 
     /**************************************************************************
-     *                       STEP 11: CLEAN UP WAYLAND                        *
+     *                       STEP 10: CLEAN UP WAYLAND                         *
      **************************************************************************/
 
     /* Delete Wayland window */
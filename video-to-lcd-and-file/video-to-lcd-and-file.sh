@@ -30,6 +30,56 @@ HEIGHT="$DEFAULT_HEIGHT"
 
 FRAMERATE="$DEFAULT_FRAMERATE"
 
+# Size of output (empty if it's the same as frame size of camera)
+OUTPUT=""
+
+# Digital zoom into the center of frame
+DEFAULT_ZOOM="1"
+
+ZOOM="$DEFAULT_ZOOM"
+
+# Clockwise rotation of frame (0, 90, 180, or 270 degrees)
+DEFAULT_ROTATE="0"
+
+ROTATE="$DEFAULT_ROTATE"
+
+# Option to mirror frame (empty if disabled)
+MIRROR=""
+
+# Option to correct lens distortion (empty if disabled)
+LENS=""
+
+# Option to denoise frames over time (empty if disabled)
+DENOISE=""
+
+# Option to pixelate or blur regions listed in a file (empty if disabled)
+MASK=""
+
+# Option to detect motion and write results to a file (empty if disabled)
+MOTION=""
+
+# Option to save JPEG snapshots on SIGUSR1 (empty if disabled)
+SNAPSHOT=""
+
+# Options to draw a second camera as picture-in-picture (empty if disabled)
+PIP=""
+PIP_AREA=""
+
+# Option to stabilize camera frames (empty if disabled)
+STABILIZE=""
+
+# Option to burn capture time into frames (empty if disabled)
+TIMESTAMP=""
+
+# Option to receive overlay commands through shared memory (empty if disabled)
+IPC=""
+
+# Option to choose NV12 writer (empty if it's chosen automatically)
+NV12=""
+
+# Option to profile render passes (empty if disabled)
+PERF=""
+
 # ---------- FUNC ----------
 
 # Check if a kernel module is loaded or not?
@@ -62,6 +112,22 @@ function usage
     printf "%b" "-w, --width\tSet the frame width (default: $DEFAULT_WIDTH).\n" 
     printf "%b" "-h, --height\tSet the frame height (default: $DEFAULT_HEIGHT).\n"
     printf "%b" "-f, --fps\tSet the frame rate (default: $DEFAULT_FRAMERATE).\n"
+    printf "%b" "-o, --output\tSet the output size, such as 1280x720 (default: frame size).\n"
+    printf "%b" "-z, --zoom\tZoom into the center of frame (default: $DEFAULT_ZOOM).\n"
+    printf "%b" "-r, --rotate\tRotate frame clockwise by 0, 90, 180, or 270 degrees (default: $DEFAULT_ROTATE).\n"
+    printf "%b" "-m, --mirror\tMirror frame horizontally (h), vertically (v), or both (hv).\n"
+    printf "%b" "-l, --lens\tCorrect radial lens distortion with coefficients K1,K2, such as -0.3,0.1.\n"
+    printf "%b" "-t, --denoise\tDenoise frames over time with strength 0 to 0.95, such as 0.75.\n"
+    printf "%b" "-k, --mask\tPixelate or blur privacy masks listed in a file.\n"
+    printf "%b" "-a, --motion\tDetect motion and write a score and grid per frame to a file.\n"
+    printf "%b" "-j, --snapshot\tSave a JPEG snapshot named PREFIX-NNNN.jpg on each SIGUSR1.\n"
+    printf "%b" "-i, --pip\tDraw a second camera, such as /dev/video1, as picture-in-picture.\n"
+    printf "%b" "-g, --pip-area\tSet area of picture-in-picture as WIDTHxHEIGHT+X+Y, such as 320x240+16+16.\n"
+    printf "%b" "-b, --stabilize\tStabilize camera frames (not combined with -l).\n"
+    printf "%b" "-c, --timestamp\tBurn capture time (ms) and frame counter into frames.\n"
+    printf "%b" "-x, --ipc\tCreate shared memory, such as /overlay, for boxes and labels of other processes.\n"
+    printf "%b" "-n, --nv12\tWrite NV12 frames in 2 passes (planes), or alternate both writers (bench).\n"
+    printf "%b" "-p, --perf\tPrint GPU time of each render pass periodically.\n"
     exit 1
 }
 
@@ -91,6 +157,83 @@ do
             FRAMERATE="$2"
             shift 2
             ;;
+        -o|--output)
+            [ $# -gt 1 ] || usage
+            OUTPUT="-o $2"
+            shift 2
+            ;;
+        -z|--zoom)
+            [ $# -gt 1 ] || usage
+            ZOOM="$2"
+            shift 2
+            ;;
+        -r|--rotate)
+            [ $# -gt 1 ] || usage
+            ROTATE="$2"
+            shift 2
+            ;;
+        -m|--mirror)
+            [ $# -gt 1 ] || usage
+            MIRROR="-m $2"
+            shift 2
+            ;;
+        -l|--lens)
+            [ $# -gt 1 ] || usage
+            LENS="-l $2"
+            shift 2
+            ;;
+        -t|--denoise)
+            [ $# -gt 1 ] || usage
+            DENOISE="-t $2"
+            shift 2
+            ;;
+        -k|--mask)
+            [ $# -gt 1 ] || usage
+            MASK="-k $2"
+            shift 2
+            ;;
+        -a|--motion)
+            [ $# -gt 1 ] || usage
+            MOTION="-a $2"
+            shift 2
+            ;;
+        -j|--snapshot)
+            [ $# -gt 1 ] || usage
+            SNAPSHOT="-j $2"
+            shift 2
+            ;;
+        -i|--pip)
+            [ $# -gt 1 ] || usage
+            PIP="-i $2"
+            shift 2
+            ;;
+        -g|--pip-area)
+            [ $# -gt 1 ] || usage
+            PIP_AREA="-g $2"
+            shift 2
+            ;;
+        -b|--stabilize)
+            STABILIZE="-b"
+            shift
+            ;;
+        -c|--timestamp)
+            TIMESTAMP="-c"
+            shift
+            ;;
+        -x|--ipc)
+            [ $# -gt 1 ] || usage
+            IPC="-x $2"
+            shift 2
+            ;;
+        -n|--nv12)
+            [ $# -gt 1 ] || usage
+            NV12="-n $2"
+            shift 2
+            ;;
+        -p|--perf)
+            PERF="-p"
+            shift
+            ;;
         *)
             usage
             ;;
@@ -119,7 +262,7 @@ modprobe $UVC_DRIVER allocators=1
 if [ $? -eq 0 ]
 then
     echo "Running sample application"
-    ./main -d $CAM_DEVICE -w $WIDTH -h $HEIGHT -f $FRAMERATE
+    ./main -d $CAM_DEVICE -w $WIDTH -h $HEIGHT -f $FRAMERATE -z $ZOOM -r $ROTATE $MIRROR $LENS $DENOISE $MASK $MOTION $SNAPSHOT $PIP $PIP_AREA $STABILIZE $TIMESTAMP $IPC $OUTPUT $NV12 $PERF
 fi
 
 # Restore current log level